@@ -23,6 +23,14 @@
 
 using namespace std;
 
+float fSampleRate = F_HZ_DEFAULT;
+thread_local float fTaskSampleRate = 0.f;
+
+int nodeSpan(float _seconds)
+{
+    return qMax(1, qRound(_seconds*F_HZ));
+}
+
 mnode::mnode()
 {
 
@@ -116,6 +124,16 @@ void mnode::changeYaw(float dAngle)
 }
 
 glm::vec3 mnode::vLatHeart(float fHeart)
+{
+    return glm::normalize(glm::normalize(vLat) - glm::normalize(vDir)*(float)(fLatRollPerMeter()*F_PI*fHeart/180.f));
+}
+
+glm::vec3 mnode::vDirHeart(float fHeart)
+{
+    return glm::normalize(vDir + vLat*(float)(fDirRollPerMeter()*F_PI*fHeart/180.f));
+}
+
+float mnode::fLatRollPerMeter()
 {
     float estimated;
     float estDistFromLast = 0.7f*fHeartDistFromLast + 0.3f*fDistFromLast;
@@ -125,10 +143,10 @@ glm::vec3 mnode::vLatHeart(float fHeart)
         estimated = fVel/F_HZ;
     }
     float fRollSpeedPerMeter = estDistFromLast > 0.f ? (fRollSpeed + fSmoothSpeed)/F_HZ/estimated : 0.f;
-    return glm::normalize(glm::normalize(vLat) - glm::normalize(vDir)*(float)(fRollSpeedPerMeter*F_PI*fHeart/180.f));
+    return fRollSpeedPerMeter;
 }
 
-glm::vec3 mnode::vDirHeart(float fHeart)
+float mnode::fDirRollPerMeter()
 {
     float estimated;
     if(fAngleFromLast < 0.001f) {
@@ -139,7 +157,7 @@ glm::vec3 mnode::vDirHeart(float fHeart)
     float fRollSpeedPerMeter = fHeartDistFromLast > 0.f ? (fRollSpeed + fSmoothSpeed)/F_HZ/estimated : 0.f;
     if(fRollSpeedPerMeter != fRollSpeedPerMeter)
         fRollSpeedPerMeter = 0.f;
-    return glm::normalize(vDir + vLat*(float)(fRollSpeedPerMeter*F_PI*fHeart/180.f));
+    return fRollSpeedPerMeter;
 }
 
 void mnode::exportNode(QList<bezier_t*> &bezList, mnode *last, mnode*, mnode* anchor, float fHeart, float fRollThresh)
@@ -24,7 +24,17 @@
 #include <fstream>
 #include "lenassert.h"
 
-#define F_HZ (1000.f)
+// nodes per second, every section is integrated at the sample rate of the open project,
+// a worker uses the rate its task was queued with instead, see fTaskSampleRate
+#define F_HZ (fTaskSampleRate > 0.f ? fTaskSampleRate : fSampleRate)
+#define F_HZ_DEFAULT (1000.f)
+#define F_HZ_MIN (100.f)
+#define F_HZ_MAX (4000.f)
+extern float fSampleRate;
+extern thread_local float fTaskSampleRate;  // 0 unless set by a background task
+
+// nodes covering _seconds at the current rate, never less than one
+int nodeSpan(float _seconds);
 
 typedef struct bezier_s
 {
@@ -60,6 +70,8 @@ public:
     float fPosHeartz(float fHeart) { return vPos.z+vNorm.z*fHeart; }
     glm::vec3 vLatHeart(float fHeart);
     glm::vec3 vDirHeart(float fHeart);
+    float fLatRollPerMeter();   // roll of vLatHeart() per meter of heart offset, in degrees
+    float fDirRollPerMeter();   // same for vDirHeart()
     glm::vec3 vPosHeart(float fHeart) { return vPos + fHeart*vNorm; }
 
     glm::vec3 vRelPos(float y, float x, float z = 0.f) { return vPos - y*vNorm + x*vLatHeart(-y) + z*vDirHeart(-y); }
@@ -19,6 +19,7 @@
 #include "secforced.h"
 #include "mnode.h"
 #include "exportfuncs.h"
+#include "sectionkernel.h"
 
 secforced::~secforced()
 {
@@ -98,79 +99,7 @@ int secforced::updateSection(int node)
         rollFunc->translateValues(rollFunc->funcList.at(0));
     }
 
-    int i;
-    for(i = node; i < numNodes; i++)
-    {
-        if(i >= lNodes.size()-1) {
-			lNodes.append(lNodes[i]);
-        }
-
-		mnode* prevNode = &lNodes[i];
-		mnode* curNode = &lNodes[i+1];
-        curNode->vPos = prevNode->vPos;
-        curNode->fVel = prevNode->fVel;
-        curNode->fEnergy = prevNode->fEnergy;
-
-        glm::vec3 forceVec = - normForce->getValue((i+1)/F_HZ) * prevNode->vNorm - latForce->getValue((i+1)/F_HZ) * prevNode->vLat - glm::vec3(0.f, 1.f, 0.f);
-
-        curNode->forceNormal = normForce->getValue((i+1)/F_HZ);
-        curNode->forceLateral = latForce->getValue((i+1)/F_HZ);
-
-		float nForce = - glm::dot(forceVec, glm::normalize(prevNode->vNorm))*F_G;
-		float lForce = - glm::dot(forceVec, glm::normalize(prevNode->vLat))*F_G;
-
-        float estVel = fabs(prevNode->fHeartDistFromLast) < std::numeric_limits<float>::epsilon() ? prevNode->fVel : prevNode->fHeartDistFromLast*F_HZ;
-
-        curNode->vDir = glm::normalize(glm::angleAxis(nForce/F_HZ/estVel, prevNode->vLat) * glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vDir);
-        curNode->vLat = glm::normalize(glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vLat);
-
-        curNode->updateNorm();
-
-        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ)) + prevNode->vDir*(curNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
-
-        curNode->fRollSpeed = 0.f;
-        curNode->setRoll(rollFunc->getValue((i+1)/F_HZ)/F_HZ); // - rollFunc->getValue(i/1000.f));
-        calcDirFromLast(i+1);
-        if(bOrientation == EULER || rollFunc->getSubfunc((i+1)/F_HZ)->degree == tozero) {
-            curNode->setRoll(glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast);
-            curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast*F_HZ;
-        }
-
-
-        curNode->updateNorm();
-
-        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
-        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
-        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
-        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
-        curNode->fRollSpeed += rollFunc->getValue((i+1)/F_HZ);  // /1000.f/curNode->fDistFromLast;
-
-        calcDirFromLast(i+1);
-        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
-        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
-        curNode->fAngleFromLast = forceAngle;
-
-        if(bSpeed) {
-            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
-			curNode->fVel = sqrt(2.f*(curNode->fEnergy-F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
-        } else {
-            curNode->fVel = this->fVel;
-			curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
-        }
-
-
-        if(fabs(curNode->fAngleFromLast) < std::numeric_limits<float>::epsilon()) {
-            forceVec = glm::vec3(0.f, 1.f, 0.f);
-        } else {
-            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
-            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
-
-			forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
-        }
-        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
-        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
-
-    }
+    int i = integrateSection(this, node, (float)numNodes);
     while(lNodes.size() > 1+i) {
 		//delete lNodes.at(1+i);
         lNodes.removeAt(1+i);
@@ -237,79 +166,7 @@ int secforced::updateDistanceSection(int node)
     int retval = i;
     float end = this->getMaxArgument();
 
-    while(length < end) {
-        if(i >= lNodes.size()-1) {
-			lNodes.append(lNodes[i]);
-        }
-
-		mnode* prevNode = &lNodes[i];
-		mnode* curNode = &lNodes[i+1];
-        curNode->vPos = prevNode->vPos;
-        curNode->fVel = prevNode->fVel;
-        curNode->fEnergy = prevNode->fEnergy;
-
-        glm::vec3 forceVec = - normForce->getValue(length+prevNode->fVel/F_HZ) * prevNode->vNorm - latForce->getValue(length+prevNode->fVel/F_HZ) * prevNode->vLat - glm::vec3(0.f, 1.f, 0.f);
-
-        curNode->forceNormal = normForce->getValue(length+prevNode->fVel/F_HZ);
-        curNode->forceLateral = latForce->getValue(length+prevNode->fVel/F_HZ);
-
-		float nForce = - glm::dot(forceVec, glm::normalize(prevNode->vNorm))*F_G;
-		float lForce = - glm::dot(forceVec, glm::normalize(prevNode->vLat))*F_G;
-
-        float estVel = fabs(prevNode->fHeartDistFromLast) < std::numeric_limits<float>::epsilon() ? prevNode->fVel : prevNode->fHeartDistFromLast*F_HZ;
-
-        curNode->vDir = glm::normalize(glm::angleAxis(nForce/F_HZ/estVel, prevNode->vLat) * glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vDir);
-        curNode->vLat = glm::normalize(glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vLat);
-
-        curNode->updateNorm();
-
-        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ)) + prevNode->vDir*(curNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
-
-        curNode->setRoll(rollFunc->getValue(length+curNode->fVel/F_HZ)*(curNode->fVel/F_HZ)); // - rollFunc->getValue(i/1000.f));
-
-        curNode->fRollSpeed = 0.f;
-		curNode->setRoll(rollFunc->getValue(length+prevNode->fVel/F_HZ)/F_HZ); // - rollFunc->getValue(i/1000.f));
-		calcDirFromLast(i+1);
-		if(bOrientation == EULER) {
-            curNode->setRoll(glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast);
-            curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast*F_HZ;
-        }
-
-		curNode->updateNorm();
-
-        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
-        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
-        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
-        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
-        curNode->fRollSpeed += rollFunc->getValue(length+curNode->fVel/F_HZ) *curNode->fVel;  // /1000.f/curNode->fDistFromLast;
-
-        calcDirFromLast(i+1);
-        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
-        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
-        curNode->fAngleFromLast = forceAngle;
-
-        if(bSpeed) {
-            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
-			curNode->fVel = sqrt(2.f*(curNode->fEnergy-F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
-        } else {
-            curNode->fVel = this->fVel;
-			curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
-        }
-
-        if(fabs(curNode->fAngleFromLast) < std::numeric_limits<float>::epsilon()) {
-            forceVec = glm::vec3(0.f, 1.f, 0.f);
-        } else {
-            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
-            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
-
-			forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
-        }
-        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
-        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
-
-        this->length += curNode->fDistFromLast;
-        ++i;
-    }
+    i = integrateSection(this, i, end);
     while(lNodes.size() > 1+i) {
 		//delete lNodes.at(1+i);
         lNodes.removeAt(1+i);
@@ -18,6 +18,7 @@
 
 #include "secgeometric.h"
 #include "exportfuncs.h"
+#include "sectionkernel.h"
 
 secgeometric::~secgeometric()
 {
@@ -114,96 +115,7 @@ int secgeometric::updateSection(int node)
         }
     }
 
-    int i;
-    for(i = node; i < numNodes; i++) {
-        if(i >= lNodes.size()-1) {
-			lNodes.append(lNodes[i]);
-        }
-
-		mnode* prevNode = &lNodes[i];
-		mnode* curNode = &lNodes[i+1];
-
-        curNode->vPos = prevNode->vPos;
-        curNode->vDir = prevNode->vDir;
-        curNode->vLat = prevNode->vLat;
-        curNode->vNorm = prevNode->vNorm;
-        curNode->fVel = prevNode->fVel;
-        curNode->fEnergy = prevNode->fEnergy;
-
-        float pitchChange = normForce->getValue((i+1)/F_HZ)/F_HZ;
-        float yawChange = latForce->getValue((i+1)/F_HZ)/F_HZ;
-        int sign = 1;
-        if(fabs(artificialRoll) >= 90.f) {
-            sign = -1;
-        }
-
-        curNode->changePitch(pitchChange, sign == -1);
-        curNode->changeYaw(yawChange);
-
-        float pureYawChange = (1.f-fabs(glm::dot(curNode->vDir, glm::vec3(0.f, 1.f, 0.f))))*yawChange;
-        float pureRollChange = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yawChange*F_HZ;
-        float deltaAngle = sqrt(pitchChange*pitchChange + pureYawChange*pureYawChange);
-
-        curNode->setRoll(-pureRollChange/F_HZ);
-        artificialRoll -= pureRollChange/F_HZ;
-
-        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ))+prevNode->vDir*(prevNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
-
-        curNode->updateNorm();
-
-        curNode->setRoll(rollFunc->getValue((i+1)/F_HZ)/F_HZ); //rollFunc->getValue((float)(i+1)/numNodes*fAngle)); //360./numNodes*(i+1));
-
-        if(bOrientation == EULER  || rollFunc->getSubfunc((i+1)/F_HZ)->degree == tozero) {
-            curNode->setRoll(+pureRollChange/F_HZ);
-            artificialRoll += pureRollChange/F_HZ;
-        }
-
-        artificialRoll += rollFunc->getValue((i+1)/F_HZ)/F_HZ;
-        while(artificialRoll > 180.f) {
-            artificialRoll -= 360.f;
-        }
-        while(artificialRoll < -180.f) {
-            artificialRoll += 360.f;
-        }
-        curNode->updateNorm();
-
-        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
-        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
-        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
-        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
-        curNode->fRollSpeed = rollFunc->getValue((i+1)/F_HZ);
-
-        if(bOrientation == EULER  || rollFunc->getSubfunc((i+1)/F_HZ)->degree == tozero) {
-            curNode->fRollSpeed += pureRollChange;
-        }
-
-
-        if(bSpeed) {
-            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
-            curNode->fVel = sqrt(2.f*(curNode->fEnergy-9.80665*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
-        } else {
-            curNode->fVel = this->fVel;
-            curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
-        }
-
-
-        calcDirFromLast(i+1);
-        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
-        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
-        curNode->fAngleFromLast = forceAngle;
-
-        glm::vec3 forceVec;
-        if(fabs(deltaAngle) < std::numeric_limits<float>::epsilon()) {
-            forceVec = glm::vec3(0.f, 1.f, 0.f);
-        } else {
-            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
-            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
-
-            forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
-        }
-        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
-        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
-    }
+    int i = integrateSection(this, node, (float)numNodes, artificialRoll);
     while(lNodes.size() > 1+i) {
 		//delete lNodes.at(1+i);
         lNodes.removeAt(1+i);
@@ -278,98 +190,7 @@ int secgeometric::updateDistanceSection(int node)
     int returnval = i;
     float end = this->getMaxArgument();
 
-    while(length < end) {
-        if(i >= lNodes.size()-1) {
-			lNodes.append(lNodes[i]);
-        }
-
-		mnode* prevNode = &lNodes[i];
-		mnode* curNode = &lNodes[i+1];
-
-        curNode->vPos = prevNode->vPos;
-        curNode->vDir = prevNode->vDir;
-        curNode->vLat = prevNode->vLat;
-        curNode->vNorm = prevNode->vNorm;
-        curNode->fVel = prevNode->fVel;
-        curNode->fEnergy = prevNode->fEnergy;
-
-        float pitchChange = normForce->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ);
-        float yawChange = latForce->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ);
-        int sign = 1;
-        if(fabs(artificialRoll) >= 90.f) {
-            sign = -1;
-        }
-
-
-        curNode->changePitch(pitchChange, sign == -1);
-        curNode->changeYaw(yawChange);
-
-        float pureYawChange = (1.f-fabs(glm::dot(curNode->vDir, glm::vec3(0.f, 1.f, 0.f))))*yawChange;
-        float pureRollChange = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yawChange*F_HZ;
-        float deltaAngle = sqrt(pitchChange*pitchChange + pureYawChange*pureYawChange);
-
-        curNode->setRoll(-pureRollChange/F_HZ);
-        artificialRoll -= pureRollChange/F_HZ;
-
-        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ))+prevNode->vDir*(prevNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
-
-        curNode->updateNorm();
-
-        curNode->setRoll(rollFunc->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ)); //rollFunc->getValue((float)(i+1)/numNodes*fAngle)); //360./numNodes*(i+1));
-
-        if(bOrientation == EULER) {
-            curNode->setRoll(pureRollChange/F_HZ);
-            artificialRoll += pureRollChange/F_HZ;
-        }
-
-        artificialRoll += rollFunc->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ);
-        while(artificialRoll > 180.f) {
-            artificialRoll -= 360.f;
-        }
-        while(artificialRoll < -180.f) {
-            artificialRoll += 360.f;
-        }
-
-        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
-        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
-        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
-        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
-        curNode->fRollSpeed = rollFunc->getValue(length + curNode->fVel/F_HZ)*curNode->fVel;
-
-        if(bOrientation == 1) {
-            curNode->fRollSpeed += pureRollChange;
-        }
-
-        if(bSpeed) {
-            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
-            curNode->fVel = sqrt(2.f*(curNode->fEnergy-9.80665*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
-        } else {
-            curNode->fVel = this->fVel;
-            curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
-        }
-
-
-        calcDirFromLast(i+1);
-        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
-        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
-        curNode->fAngleFromLast = forceAngle;
-
-        glm::vec3 forceVec;
-        if(fabs(deltaAngle) < std::numeric_limits<float>::epsilon()) {
-            forceVec = glm::vec3(0.f, 1.f, 0.f);
-        } else {
-            float normalDAngle = F_PI/180.f*(-curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
-            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
-
-            forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
-        }
-        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
-        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
-
-        this->length += curNode->fDistFromLast;
-        if(curNode->fVel < 0.01) break;
-        ++i;
-    }
+    i = integrateSection(this, i, end, artificialRoll);
     while(lNodes.size() > 1+i) {
 		//delete lNodes.at(1+i);
         lNodes.removeAt(1+i);
@@ -33,6 +33,7 @@ section::section(track* getParent, enum secType _type, mnode* first)
 	lNodes.reserve(180000);
 	lNodes.append(*first);
     parent = getParent;
+    bCache = true;
     normForce = NULL;
     latForce = NULL;
     if(_type != bezier) {
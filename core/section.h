@@ -67,8 +67,11 @@ public:
     float getSpeed();
     bool setLocked(eFunctype func, int _id, bool _active);
     void calcDirFromLast(int i);
+    // node _index for reading, unlike lNodes[] it does not detach a node buffer shared with a cloned track
+    mnode* readNode(int _index) { return const_cast<mnode*>(lNodes.constData()+_index); }
 	QVector<mnode> lNodes;
     track* parent;
+    bool bCache;    // integration results go to the section cache
     func* rollFunc;
 
     enum secType type;
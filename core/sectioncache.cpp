@@ -0,0 +1,166 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sectioncache.h"
+#include "sectionkernel.h"
+#include "section.h"
+#include "track.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <sstream>
+#include <algorithm>
+#include <list>
+
+namespace {
+
+typedef struct cacheentry_s{
+    QVector<mnode> nodes;
+    int last;
+    float length;
+    std::list<QByteArray>::iterator use;    // position in usage
+} cacheentry_t;
+
+// tracks are integrated on the worker threads, every access goes through the mutex
+QMutex cacheMutex;
+QHash<QByteArray, cacheentry_t> entries;
+std::list<QByteArray> usage;                // keys of entries, least recently used first
+qint64 cacheBytes = 0;
+qint64 cacheBudget = (qint64)SECTION_CACHE_BUDGET*1024*1024;
+quint64 cacheHits = 0;
+quint64 cacheMisses = 0;
+
+qint64 entrySize(const QByteArray &_key, const cacheentry_t &_entry)
+{
+    return _key.size() + _entry.nodes.size()*(qint64)sizeof(mnode) + (qint64)sizeof(cacheentry_t);
+}
+
+void evict(qint64 _bytes)
+{
+    while(cacheBytes + _bytes > cacheBudget && !usage.empty()) {
+        QHash<QByteArray, cacheentry_t>::iterator oldest = entries.find(usage.front());
+        cacheBytes -= entrySize(oldest.key(), oldest.value());
+        entries.erase(oldest);
+        usage.pop_front();
+    }
+}
+
+// field by field, the raw bytes of the node would take in whatever padding the compiler adds
+void appendNode(QByteArray &_key, const mnode &_node)
+{
+    const float values[] = {_node.vPos.x, _node.vPos.y, _node.vPos.z, _node.vDir.x, _node.vDir.y, _node.vDir.z,
+                            _node.vLat.x, _node.vLat.y, _node.vLat.z, _node.vNorm.x, _node.vNorm.y, _node.vNorm.z,
+                            _node.fRoll, _node.fVel, _node.fEnergy, _node.forceNormal, _node.forceLateral,
+                            _node.smoothNormal, _node.smoothLateral, _node.fDistFromLast, _node.fHeartDistFromLast,
+                            _node.fAngleFromLast, _node.fTrackAngleFromLast, _node.fDirFromLast,
+                            _node.fPitchFromLast, _node.fYawFromLast, _node.fRollSpeed, _node.fSmoothSpeed,
+                            _node.fTotalLength, _node.fTotalHeartLength};
+    _key.append((const char*)values, sizeof(values));
+}
+
+}
+
+QByteArray sectionCacheKey(section* _section, float _end)
+{
+    std::stringstream data;
+    _section->saveSection(data);
+    const std::string saved = data.str();
+
+    // the forced sections do not save these
+    const float values[] = {_end, F_HZ, F_TOLERANCE, _section->parent->fHeart, _section->parent->fFriction,
+                            _section->parent->fResistance, _section->fVel};
+    const char flags[] = {(char)_section->bSpeed, (char)_section->bOrientation, (char)_section->bArgument};
+
+    QByteArray key(saved.data(), (int)saved.size());
+    appendNode(key, _section->lNodes.constFirst());
+    key.append((const char*)values, sizeof(values));
+    key.append(flags, sizeof(flags));
+    return key;
+}
+
+bool restoreSection(const QByteArray &_key, section* _section, int &_last)
+{
+    QMutexLocker locker(&cacheMutex);
+    QHash<QByteArray, cacheentry_t>::iterator it = entries.find(_key);
+    if(it == entries.end()) {
+        ++cacheMisses;
+        return false;
+    }
+    ++cacheHits;
+    usage.splice(usage.end(), usage, it.value().use);
+
+    const cacheentry_t &entry = it.value();
+    _section->lNodes.resize(entry.nodes.size());
+    std::copy(entry.nodes.constBegin(), entry.nodes.constEnd(), _section->lNodes.begin());
+    _section->length = entry.length;
+    _last = entry.last;
+    return true;
+}
+
+void storeSection(const QByteArray &_key, section* _section, int _last)
+{
+    // a compact copy, the section keeps its reserved node buffer
+    cacheentry_t entry;
+    entry.nodes.resize(std::min(_last+1, (int)_section->lNodes.size()));
+    std::copy(_section->lNodes.constBegin(), _section->lNodes.constBegin()+entry.nodes.size(), entry.nodes.begin());
+    entry.last = _last;
+    entry.length = _section->length;
+
+    QMutexLocker locker(&cacheMutex);
+    const qint64 size = entrySize(_key, entry);
+    if(size > cacheBudget || entries.contains(_key)) return;
+    evict(size);
+    usage.push_back(_key);
+    entry.use = std::prev(usage.end());
+    entries.insert(_key, entry);
+    cacheBytes += size;
+}
+
+void setSectionCacheBudget(qint64 _bytes)
+{
+    QMutexLocker locker(&cacheMutex);
+    cacheBudget = std::max(_bytes, (qint64)0);
+    evict(0);
+}
+
+qint64 getSectionCacheBudget()
+{
+    QMutexLocker locker(&cacheMutex);
+    return cacheBudget;
+}
+
+sectioncachestats_t getSectionCacheStats()
+{
+    QMutexLocker locker(&cacheMutex);
+    sectioncachestats_t stats;
+    stats.hits = cacheHits;
+    stats.misses = cacheMisses;
+    stats.entries = entries.size();
+    stats.bytes = cacheBytes;
+    stats.budget = cacheBudget;
+    return stats;
+}
+
+void clearSectionCache()
+{
+    QMutexLocker locker(&cacheMutex);
+    entries.clear();
+    usage.clear();
+    cacheBytes = 0;
+}
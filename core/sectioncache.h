@@ -0,0 +1,50 @@
+#ifndef SECTIONCACHE_H
+#define SECTIONCACHE_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QByteArray>
+
+class section;
+
+// node buffers of integrated forced and geometric sections, least recently used ones go first once the budget is full
+#define SECTION_CACHE_BUDGET 64     // default budget in MB, 0 turns the cache off
+
+typedef struct sectioncachestats_s{
+    quint64 hits;
+    quint64 misses;
+    int entries;
+    qint64 bytes;
+    qint64 budget;
+} sectioncachestats_t;
+
+// the key holds everything the integration of _section depends on: its saved parameters,
+// the start node, the heartline and friction of the track, the sample rate and the adaptive tolerance
+QByteArray sectionCacheKey(section* _section, float _end);
+
+// copies the cached nodes into _section, _last gets the index of the last node
+bool restoreSection(const QByteArray &_key, section* _section, int &_last);
+void storeSection(const QByteArray &_key, section* _section, int _last);
+
+void setSectionCacheBudget(qint64 _bytes);
+qint64 getSectionCacheBudget();
+sectioncachestats_t getSectionCacheStats();
+void clearSectionCache();
+
+#endif // SECTIONCACHE_H
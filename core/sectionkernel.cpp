@@ -0,0 +1,554 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sectionkernel.h"
+#include "sectioncache.h"
+#include "track.h"
+#include "logging.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <algorithm>
+
+float fAdaptiveTolerance = 0.f;
+thread_local float fTaskTolerance = -1.f;
+
+namespace {
+
+// work of the adaptive integration for benchmarkSections()
+thread_local qint64 adaptiveSteps = 0;
+thread_local qint64 adaptiveNodes = 0;
+
+// function value per node, the time argument advances 1/F_HZ per node, the distance argument fVel/F_HZ
+template<bool Argument>
+inline float perNode(float value, float vel)
+{
+    if constexpr(Argument == DISTANCE) return value*(vel/F_HZ);
+    else return value/F_HZ;
+}
+
+// the per node body of the former secforced/secgeometric update loops,
+// every bArgument, bOrientation and bSpeed branch is resolved when the kernel is instantiated
+template<enum secType Type, bool Argument, bool Orientation, bool Speed>
+int integrate(section* sec, int i, float end, float artificialRoll)
+{
+    track* parent = sec->parent;
+    func* rollFunc = sec->rollFunc;
+    func* normForce = sec->normForce;
+    func* latForce = sec->latForce;
+
+    while(Argument == DISTANCE ? sec->length < end : i < end) {
+        if(i >= sec->lNodes.size()-1) {
+            sec->lNodes.append(sec->lNodes[i]);
+        }
+
+        mnode* prevNode = &sec->lNodes[i];
+        mnode* curNode = &sec->lNodes[i+1];
+        curNode->vPos = prevNode->vPos;
+        if constexpr(Type == geometric) {
+            curNode->vDir = prevNode->vDir;
+            curNode->vLat = prevNode->vLat;
+            curNode->vNorm = prevNode->vNorm;
+        }
+        curNode->fVel = prevNode->fVel;
+        curNode->fEnergy = prevNode->fEnergy;
+
+        const float arg = Argument == DISTANCE ? sec->length+prevNode->fVel/F_HZ : (i+1)/F_HZ;
+        const float normValue = normForce->getValue(arg);
+        const float latValue = latForce->getValue(arg);
+        subfunc* rollSub = rollFunc->getSubfunc(arg);
+        const float rollValue = rollSub->getValue(arg);
+        // euler sections and tozero roll functions let the roll follow the yaw, the distance argument ignores tozero
+        const bool followYaw = Orientation == EULER || (Argument == TIME && rollSub->degree == tozero);
+
+        float deltaAngle = 0.f;
+        float pureRollChange = 0.f;
+        if constexpr(Type == forced) {
+            glm::vec3 forceVec = - normValue * prevNode->vNorm - latValue * prevNode->vLat - glm::vec3(0.f, 1.f, 0.f);
+
+            curNode->forceNormal = normValue;
+            curNode->forceLateral = latValue;
+
+            float nForce = - glm::dot(forceVec, glm::normalize(prevNode->vNorm))*F_G;
+            float lForce = - glm::dot(forceVec, glm::normalize(prevNode->vLat))*F_G;
+
+            float estVel = fabs(prevNode->fHeartDistFromLast) < std::numeric_limits<float>::epsilon() ? prevNode->fVel : prevNode->fHeartDistFromLast*F_HZ;
+
+            curNode->vDir = glm::normalize(glm::angleAxis(nForce/F_HZ/estVel, prevNode->vLat) * glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vDir);
+            curNode->vLat = glm::normalize(glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vLat);
+
+            curNode->updateNorm();
+
+            curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ)) + prevNode->vDir*(curNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+            if constexpr(Argument == DISTANCE) {
+                curNode->setRoll(perNode<Argument>(rollValue, curNode->fVel));
+            }
+            curNode->fRollSpeed = 0.f;
+            curNode->setRoll(rollValue/F_HZ);
+            sec->calcDirFromLast(i+1);
+            if(followYaw) {
+                curNode->setRoll(glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast);
+                curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast*F_HZ;
+            }
+
+            curNode->updateNorm();
+        } else {
+            float pitchChange = perNode<Argument>(normValue, curNode->fVel);
+            float yawChange = perNode<Argument>(latValue, curNode->fVel);
+
+            curNode->changePitch(pitchChange, fabs(artificialRoll) >= 90.f);
+            curNode->changeYaw(yawChange);
+
+            float pureYawChange = (1.f-fabs(glm::dot(curNode->vDir, glm::vec3(0.f, 1.f, 0.f))))*yawChange;
+            pureRollChange = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yawChange*F_HZ;
+            deltaAngle = sqrt(pitchChange*pitchChange + pureYawChange*pureYawChange);
+
+            curNode->setRoll(-pureRollChange/F_HZ);
+            artificialRoll -= pureRollChange/F_HZ;
+
+            curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ))+prevNode->vDir*(prevNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+            curNode->updateNorm();
+
+            curNode->setRoll(perNode<Argument>(rollValue, curNode->fVel));
+
+            if(followYaw) {
+                curNode->setRoll(+pureRollChange/F_HZ);
+                artificialRoll += pureRollChange/F_HZ;
+            }
+
+            artificialRoll += perNode<Argument>(rollValue, curNode->fVel);
+            while(artificialRoll > 180.f) {
+                artificialRoll -= 360.f;
+            }
+            while(artificialRoll < -180.f) {
+                artificialRoll += 360.f;
+            }
+            if constexpr(Argument == TIME) {
+                curNode->updateNorm();
+            }
+        }
+
+        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
+        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
+        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
+        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
+
+        const float rollSpeed = Argument == DISTANCE ? rollValue*curNode->fVel : rollValue;
+        if constexpr(Type == forced) {
+            curNode->fRollSpeed += rollSpeed;
+        } else {
+            curNode->fRollSpeed = rollSpeed;
+            if(followYaw) {
+                curNode->fRollSpeed += pureRollChange;
+            }
+        }
+
+        sec->calcDirFromLast(i+1);
+        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
+        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);
+        curNode->fAngleFromLast = forceAngle;
+
+        if constexpr(Speed) {
+            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
+            if constexpr(Type == forced) {
+                curNode->fVel = sqrt(2.f*(curNode->fEnergy-F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+            } else {
+                curNode->fVel = sqrt(2.f*(curNode->fEnergy-9.80665*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+            }
+        } else {
+            curNode->fVel = sec->fVel;
+            curNode->fEnergy = 0.5*sec->fVel*sec->fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
+        }
+
+        glm::vec3 forceVec;
+        if(fabs(Type == forced ? curNode->fAngleFromLast : deltaAngle) < std::numeric_limits<float>::epsilon()) {
+            forceVec = glm::vec3(0.f, 1.f, 0.f);
+        } else {
+            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
+            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
+
+            forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
+        }
+        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
+        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
+
+        if constexpr(Argument == DISTANCE) {
+            sec->length += curNode->fDistFromLast;
+            if(Type == geometric && curNode->fVel < 0.01) break;
+        }
+        ++i;
+    }
+    return i;
+}
+
+// state the adaptive integrator carries between its steps
+typedef struct stepstate_s {
+    mnode node;
+    float heartSpeed;       // speed of the heartline over the last step, forced sections bend with it
+    float artificialRoll;
+} stepstate_t;
+
+inline float wrapAngle(float angle)
+{
+    while(angle > 180.f) angle -= 360.f;
+    while(angle < -180.f) angle += 360.f;
+    return angle;
+}
+
+// one step of dt seconds ending at time t, the same physics as integrate() with 1/F_HZ replaced by dt
+template<enum secType Type, bool Orientation, bool Speed>
+void advance(section* sec, const stepstate_t &from, float t, float dt, stepstate_t &to)
+{
+    track* parent = sec->parent;
+    mnode prevNode = from.node;
+    to = from;
+    mnode* curNode = &to.node;
+
+    const float normValue = sec->normForce->getValue(t);
+    const float latValue = sec->latForce->getValue(t);
+    subfunc* rollSub = sec->rollFunc->getSubfunc(t);
+    const float rollValue = rollSub->getValue(t);
+    const bool followYaw = Orientation == EULER || rollSub->degree == tozero;
+
+    if constexpr(Type == forced) {
+        glm::vec3 forceVec = - normValue * prevNode.vNorm - latValue * prevNode.vLat - glm::vec3(0.f, 1.f, 0.f);
+        float nForce = - glm::dot(forceVec, glm::normalize(prevNode.vNorm))*F_G;
+        float lForce = - glm::dot(forceVec, glm::normalize(prevNode.vLat))*F_G;
+        float estVel = fabs(from.heartSpeed) < std::numeric_limits<float>::epsilon() ? prevNode.fVel : from.heartSpeed;
+
+        curNode->vDir = glm::normalize(glm::angleAxis(nForce*dt/estVel, prevNode.vLat) * glm::angleAxis(-lForce/prevNode.fVel*dt, prevNode.vNorm) * prevNode.vDir);
+        curNode->vLat = glm::normalize(glm::angleAxis(-lForce/prevNode.fVel*dt, prevNode.vNorm) * prevNode.vLat);
+        curNode->updateNorm();
+
+        curNode->vPos += curNode->vDir*(curNode->fVel*dt/2.f) + prevNode.vDir*(curNode->fVel*dt/2.f) + (prevNode.vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+        curNode->setRoll(rollValue*dt);
+        if(followYaw) {
+            float yaw = wrapAngle(curNode->getDirection()-prevNode.getDirection());
+            curNode->setRoll(glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yaw);
+        }
+        curNode->updateNorm();
+    } else {
+        float pitchChange = normValue*dt;
+        float yawChange = latValue*dt;
+
+        curNode->changePitch(pitchChange, fabs(to.artificialRoll) >= 90.f);
+        curNode->changeYaw(yawChange);
+
+        float pureRollChange = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yawChange;
+        curNode->setRoll(-pureRollChange);
+        to.artificialRoll -= pureRollChange;
+
+        curNode->vPos += curNode->vDir*(curNode->fVel*dt/2.f) + prevNode.vDir*(prevNode.fVel*dt/2.f) + (prevNode.vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+        curNode->updateNorm();
+
+        curNode->setRoll(rollValue*dt);
+        if(followYaw) {
+            curNode->setRoll(pureRollChange);
+            to.artificialRoll += pureRollChange;
+        }
+        to.artificialRoll = wrapAngle(to.artificialRoll + rollValue*dt);
+        curNode->updateNorm();
+    }
+
+    float heartDist = glm::distance(curNode->vPos, prevNode.vPos);
+    curNode->fTotalLength = prevNode.fTotalLength + glm::distance(curNode->vPosHeart(parent->fHeart), prevNode.vPosHeart(parent->fHeart));
+    curNode->fTotalHeartLength = prevNode.fTotalHeartLength + heartDist;
+    to.heartSpeed = heartDist/dt;
+
+    if constexpr(Speed) {
+        curNode->fEnergy -= curNode->fVel*curNode->fVel*curNode->fVel*dt * parent->fResistance;
+        curNode->fVel = sqrt(2.f*(curNode->fEnergy-F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+    } else {
+        curNode->fVel = sec->fVel;
+        curNode->fEnergy = 0.5*sec->fVel*sec->fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
+    }
+}
+
+// estimated deviation between one step and two half steps, positions in meters, frames as the displacement of a point ADAPTIVE_LEVER off the heartline
+inline float stepError(const stepstate_t &full, const stepstate_t &half, float dt)
+{
+    float error = glm::distance(full.node.vPos, half.node.vPos);
+    error = std::max(error, ADAPTIVE_LEVER*glm::length(full.node.vDir-half.node.vDir));
+    error = std::max(error, ADAPTIVE_LEVER*glm::length(full.node.vLat-half.node.vLat));
+    error = std::max(error, (float)fabs(full.node.fVel-half.node.fVel)*dt);
+    return error;
+}
+
+// fills node j between the accepted steps a and b, positions along a hermite curve, frames by slerp
+void resample(mnode &node, const stepstate_t &a, const stepstate_t &b, float s, float span)
+{
+    float s2 = s*s, s3 = s2*s;
+    glm::vec3 m0 = a.node.vDir*(a.heartSpeed*span);
+    glm::vec3 m1 = b.node.vDir*(b.heartSpeed*span);
+    node.vPos = (2.f*s3-3.f*s2+1.f)*a.node.vPos + (s3-2.f*s2+s)*m0 + (-2.f*s3+3.f*s2)*b.node.vPos + (s3-s2)*m1;
+
+    glm::quat qa = glm::quat_cast(glm::mat3(a.node.vDir, a.node.vLat, a.node.vNorm));
+    glm::quat qb = glm::quat_cast(glm::mat3(b.node.vDir, b.node.vLat, b.node.vNorm));
+    glm::mat3 frame = glm::mat3_cast(glm::slerp(qa, qb, s));
+    node.vDir = glm::normalize(frame[0]);
+    node.vLat = glm::normalize(frame[1]);
+    node.updateRoll();
+
+    node.fVel = glm::mix(a.node.fVel, b.node.fVel, s);
+    node.fEnergy = glm::mix(a.node.fEnergy, b.node.fEnergy, s);
+}
+
+// per node quantities of the nodes from+1 to to on the uniform grid, as integrate() derives them
+template<enum secType Type, bool Orientation>
+void finishNodes(section* sec, int from, int to)
+{
+    track* parent = sec->parent;
+    const float nodeTime = 1.f/F_HZ;
+
+    for(int j = from+1; j <= to; ++j) {
+        mnode* prevNode = &sec->lNodes[j-1];
+        mnode* curNode = &sec->lNodes[j];
+        const float arg = j*nodeTime;
+
+        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
+        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
+        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
+        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
+
+        sec->calcDirFromLast(j);
+        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
+        curNode->fAngleFromLast = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);
+
+        subfunc* rollSub = sec->rollFunc->getSubfunc(arg);
+        curNode->fRollSpeed = rollSub->getValue(arg);
+        if(Orientation == EULER || rollSub->degree == tozero) {
+            if constexpr(Type == forced) {
+                curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast*F_HZ;
+            } else {
+                curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*sec->latForce->getValue(arg);
+            }
+        }
+
+        glm::vec3 forceVec;
+        if(fabs(curNode->fAngleFromLast) < std::numeric_limits<float>::epsilon()) {
+            forceVec = glm::vec3(0.f, 1.f, 0.f);
+        } else {
+            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
+            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
+
+            forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
+        }
+        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
+        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
+    }
+}
+
+// error controlled steps of 1 to ADAPTIVE_MAX_NODES nodes, checked by step doubling, the nodes in between are resampled
+// no step runs across the start of a subfunction, a tozero roll subfunction reads the finished nodes in front of its start
+template<enum secType Type, bool Orientation, bool Speed>
+int integrateAdaptive(section* sec, int i, int numNodes, float artificialRoll)
+{
+    const float nodeTime = 1.f/F_HZ;
+
+    while(sec->lNodes.size() < std::max(i, numNodes)+1) {
+        sec->lNodes.append(sec->lNodes[sec->lNodes.size()-1]);
+    }
+
+    QVector<int> bounds, finishAt;
+    func* funcs[3] = {sec->normForce, sec->latForce, sec->rollFunc};
+    for(int f = 0; f < 3; ++f) {
+        for(int s = 0; s < funcs[f]->funcList.size(); ++s) {
+            subfunc* sub = funcs[f]->funcList[s];
+            int b = (int)(sub->minArgument*F_HZ);   // the last node the previous subfunction covers
+            if(b <= i || b >= numNodes) continue;
+            bounds.append(b);
+            if(funcs[f] == sec->rollFunc && sub->degree == tozero) finishAt.append(b);
+        }
+    }
+    std::sort(bounds.begin(), bounds.end());
+
+    stepstate_t cur;
+    cur.node = sec->lNodes[i];
+    cur.heartSpeed = cur.node.fHeartDistFromLast*F_HZ;
+    cur.artificialRoll = artificialRoll;
+
+    int stride = 1;
+    int nextBound = 0;
+    const int first = i;
+    int finished = i;
+    stepstate_t full, mid, half;
+    while(i < numNodes) {
+        while(nextBound < bounds.size() && bounds[nextBound] <= i) ++nextBound;
+        if(finished < i && finishAt.contains(i)) {
+            finishNodes<Type, Orientation>(sec, finished, i);
+            finished = i;
+        }
+        const int len = std::min(stride, (nextBound < bounds.size() ? bounds[nextBound] : numNodes)-i);
+        int accepted;
+        int midNode = 0;
+        if(len == 1) {
+            advance<Type, Orientation, Speed>(sec, cur, (i+1)*nodeTime, nodeTime, half);
+            adaptiveSteps += 1;
+            accepted = 1;
+        } else {
+            int halfLen = len/2;
+            advance<Type, Orientation, Speed>(sec, cur, (i+len)*nodeTime, len*nodeTime, full);
+            advance<Type, Orientation, Speed>(sec, cur, (i+halfLen)*nodeTime, halfLen*nodeTime, mid);
+            advance<Type, Orientation, Speed>(sec, mid, (i+len)*nodeTime, (len-halfLen)*nodeTime, half);
+            adaptiveSteps += 3;
+
+            float error = stepError(full, half, len*nodeTime);
+            if(error > F_TOLERANCE) {
+                stride = halfLen;
+                continue;
+            }
+            accepted = len;
+            // the doubled step stays well inside the bound, the next one may be longer
+            if(error < 0.25f*F_TOLERANCE && len == stride) stride = std::min(2*stride, ADAPTIVE_MAX_NODES);
+            midNode = halfLen;
+            sec->lNodes[i+midNode] = mid.node;
+        }
+
+        for(int j = 1; j < accepted; ++j) {
+            if(j == midNode) continue;
+            resample(sec->lNodes[i+j], cur, half, (float)j/accepted, accepted*nodeTime);
+        }
+        sec->lNodes[i+accepted] = half.node;
+        cur = half;
+        i += accepted;
+    }
+
+    finishNodes<Type, Orientation>(sec, finished, numNodes);
+    adaptiveNodes += i-first;
+    return i;
+}
+
+template<enum secType Type, bool Argument, bool Orientation>
+int integrate(section* sec, int i, float end, float artificialRoll)
+{
+    if constexpr(Argument == TIME) {
+        if(F_TOLERANCE > 0.f) {
+            if(sec->bSpeed) return integrateAdaptive<Type, Orientation, true>(sec, i, (int)end, artificialRoll);
+            return integrateAdaptive<Type, Orientation, false>(sec, i, (int)end, artificialRoll);
+        }
+    }
+    if(sec->bSpeed) return integrate<Type, Argument, Orientation, true>(sec, i, end, artificialRoll);
+    return integrate<Type, Argument, Orientation, false>(sec, i, end, artificialRoll);
+}
+
+template<enum secType Type, bool Argument>
+int integrate(section* sec, int i, float end, float artificialRoll)
+{
+    if(sec->bOrientation == EULER) return integrate<Type, Argument, EULER>(sec, i, end, artificialRoll);
+    return integrate<Type, Argument, QUATERNION>(sec, i, end, artificialRoll);
+}
+
+template<enum secType Type>
+int integrate(section* sec, int i, float end, float artificialRoll)
+{
+    if(sec->bArgument == DISTANCE) return integrate<Type, DISTANCE>(sec, i, end, artificialRoll);
+    return integrate<Type, TIME>(sec, i, end, artificialRoll);
+}
+
+}
+
+int integrateSection(section* _section, int _node, float _end, float _artificialRoll)
+{
+    // the nodes in front of _node and the running roll follow from the key as well
+    QByteArray key;
+    int last;
+    if(_section->bCache && getSectionCacheBudget() > 0) {
+        key = sectionCacheKey(_section, _end);
+        if(restoreSection(key, _section, last)) return last;
+    }
+
+    if(_section->type == forced) {
+        last = integrate<forced>(_section, _node, _end, _artificialRoll);
+    } else {
+        lenAssert(_section->type == geometric);
+        last = integrate<geometric>(_section, _node, _end, _artificialRoll);
+    }
+
+    if(!key.isEmpty()) storeSection(key, _section, last);
+    return last;
+}
+
+void benchmarkSections(track* _track, int _runs)
+{
+    qint64 totalNs = 0, totalNodes = 0;
+    adaptiveSteps = 0;
+    adaptiveNodes = 0;
+    for(int s = 0; s < _track->lSections.size(); ++s) {
+        section* curSection = _track->lSections[s];
+        if(curSection->type != forced && curSection->type != geometric) continue;
+
+        QElapsedTimer timer;
+        timer.start();
+        for(int run = 0; run < _runs; ++run) {
+            curSection->updateSection(0);
+        }
+        qint64 ns = timer.nsecsElapsed();
+        qint64 nodes = (qint64)_runs*(curSection->lNodes.size()-1);
+        if(nodes <= 0) continue;
+
+        qCInfo(Logging::logCore, "%s section %d (%s): %d nodes, %.1f ns per node",
+               curSection->type == forced ? "forced" : "geometric", s, qPrintable(curSection->sName),
+               curSection->lNodes.size()-1, (double)ns/nodes);
+        totalNs += ns;
+        totalNodes += nodes;
+    }
+    if(totalNodes > 0) {
+        qCInfo(Logging::logCore, "%s: %.1f ns per node over %lld nodes", qPrintable(_track->name), (double)totalNs/totalNodes, totalNodes);
+    }
+    if(adaptiveNodes > 0) {
+        qCInfo(Logging::logCore, "adaptive integration: %lld steps for %lld nodes", adaptiveSteps, adaptiveNodes);
+    }
+}
+
+ridesummary_t summarizeRide(track* _track)
+{
+    ridesummary_t summary;
+    mnode* last = _track->anchorNode;
+    summary.maxNormal = summary.minNormal = last->forceNormal;
+    summary.maxLateral = fabs(last->forceLateral);
+    for(int s = 0; s < _track->lSections.size(); ++s) {
+        const QVector<mnode> &nodes = _track->lSections[s]->lNodes;
+        for(int i = 0; i < nodes.size(); ++i) {
+            summary.maxNormal = std::max(summary.maxNormal, nodes[i].forceNormal);
+            summary.minNormal = std::min(summary.minNormal, nodes[i].forceNormal);
+            summary.maxLateral = std::max(summary.maxLateral, (float)fabs(nodes[i].forceLateral));
+        }
+        if(nodes.size()) last = _track->lSections[s]->readNode(nodes.size()-1);
+    }
+    summary.endPos = last->vPos;
+    summary.endVel = last->fVel;
+    summary.length = last->fTotalLength;
+    return summary;
+}
+
+bool compareRides(const QString &_name, const ridesummary_t &_reference, const ridesummary_t &_test)
+{
+    float length = std::max(_reference.length, 1.f);
+    float position = glm::distance(_reference.endPos, _test.endPos)/length;
+    float ridelength = fabs(_reference.length-_test.length)/length;
+    float speed = fabs(_reference.endVel-_test.endVel);
+    float force = std::max(std::max(fabs(_reference.maxNormal-_test.maxNormal), fabs(_reference.minNormal-_test.minNormal)), fabs(_reference.maxLateral-_test.maxLateral));
+
+    bool passed = position <= RATE_TOL_POSITION && ridelength <= RATE_TOL_LENGTH && speed <= RATE_TOL_SPEED && force <= RATE_TOL_FORCE;
+    qCInfo(Logging::logCore, "%s: end position %.4f%%, length %.4f%%, end speed %.3f m/s, peak forces %.3f g: %s",
+           qPrintable(_name), 100.f*position, 100.f*ridelength, speed, force, passed ? "ok" : "out of tolerance");
+    return passed;
+}
@@ -0,0 +1,65 @@
+#ifndef SECTIONKERNEL_H
+#define SECTIONKERNEL_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QString>
+#include "mnode.h"
+
+class section;
+class track;
+
+// tolerances a ride integrated at another sample rate has to keep against the 1 kHz reference
+#define RATE_TOL_POSITION (0.002f)  // end position, relative to the ride length
+#define RATE_TOL_LENGTH (0.002f)    // ride length, relative
+#define RATE_TOL_SPEED (0.1f)       // end speed in m/s
+#define RATE_TOL_FORCE (0.05f)      // peak normal and lateral forces in g
+
+// error bound of the adaptive integration in meters per step, 0 keeps the fixed 1/F_HZ steps
+// only time argument sections integrate adaptively, their nodes stay on the 1/F_HZ grid
+extern float fAdaptiveTolerance;
+extern thread_local float fTaskTolerance;   // negative unless set by a background task
+#define F_TOLERANCE (fTaskTolerance >= 0.f ? fTaskTolerance : fAdaptiveTolerance)
+#define ADAPTIVE_MAX_NODES 64       // longest adaptive step in nodes
+#define ADAPTIVE_LEVER (1.f)        // frame errors count as the displacement of a point this far off the heartline
+
+typedef struct ridesummary_s{
+    glm::vec3 endPos;
+    float endVel;
+    float length;
+    float maxNormal;
+    float minNormal;
+    float maxLateral;
+} ridesummary_t;
+
+// integrates the nodes of a forced or geometric section, starting behind node _node
+// the time argument runs up to _end nodes, the distance argument up to a section length of _end
+// _artificialRoll is the running roll of geometric sections at _node
+// returns the index of the last node written, results of sections with bCache set are memoized in the section cache
+int integrateSection(section* _section, int _node, float _end, float _artificialRoll = 0.f);
+
+// recomputes every forced and geometric section of _track _runs times and logs the time spent per node
+void benchmarkSections(track* _track, int _runs);
+
+ridesummary_t summarizeRide(track* _track);
+
+// logs how far _test is off _reference and returns whether it stays inside the RATE_TOL_ tolerances
+bool compareRides(const QString &_name, const ridesummary_t &_reference, const ridesummary_t &_test);
+
+#endif // SECTIONKERNEL_H
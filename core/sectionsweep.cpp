@@ -0,0 +1,468 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sectionsweep.h"
+#include "track.h"
+#include "secforced.h"
+#include "secgeometric.h"
+#include "exportfuncs.h"
+#include "logging.h"
+
+#include <QThreadPool>
+#include <sstream>
+#include <limits>
+
+namespace {
+
+func* sweepFunc(section* _section, int _index)
+{
+    switch(_index) {
+    case 0:
+        return _section->rollFunc;
+    case 1:
+        return _section->normForce;
+    default:
+        return _section->latForce;
+    }
+}
+
+// cancelSweeps() moves on to the next generation, the batches of the older ones stop after their current variant
+QAtomicInt sweepGeneration;
+
+QThreadPool* sweepPool()
+{
+    // not the global pool, the sweeps must not wait for recomputeTracks() or the other way round
+    static QThreadPool* pool = new QThreadPool();
+    return pool;
+}
+
+sweepsource_t saveSource(section* _section)
+{
+    sweepsource_t source;
+    source.type = _section->type;
+    source.start = _section->lNodes.at(0);
+    std::stringstream saved;
+    _section->saveSection(saved);
+    source.data = saved.str();
+    // the forced sections do not save these with the undo data
+    source.bSpeed = _section->bSpeed;
+    source.fVel = _section->fVel;
+    source.fHeart = _section->parent->fHeart;
+    source.fFriction = _section->parent->fFriction;
+    source.fResistance = _section->parent->fResistance;
+    return source;
+}
+
+// a private section in a detached track of its own, a tozero roll function only finds the nodes of the copy
+// and the copy is always the last section, delete it with deleteCopy()
+section* copySection(const sweepsource_t &_source)
+{
+    track* context = new track();
+    context->fHeart = _source.fHeart;
+    context->fFriction = _source.fFriction;
+    context->fResistance = _source.fResistance;
+
+    mnode start = _source.start;
+    section* copy;
+    if(_source.type == forced) {
+        copy = new secforced(context, &start, 0.f);
+    } else if(_source.type == geometric) {
+        copy = new secgeometric(context, &start, 0.f);
+    } else {
+        delete context;
+        return NULL;
+    }
+    context->lSections.append(copy);
+    context->activeSection = copy;
+
+    std::stringstream data(_source.data);
+    readString(&data, 3);
+    copy->loadSection(data);
+    copy->bSpeed = _source.bSpeed;
+    copy->fVel = _source.fVel;
+    // variants are thrown away, they would only push the real sections out of the cache
+    copy->bCache = false;
+    return copy;
+}
+
+void deleteCopy(section* _copy)
+{
+    delete _copy->parent;   // deletes the copy with it
+}
+
+float signedAngleDifference(float _a, float _b)
+{
+    float diff = _a - _b;
+    while(diff > 180.f) diff -= 360.f;
+    while(diff < -180.f) diff += 360.f;
+    return diff;
+}
+
+float angleDifference(float _a, float _b)
+{
+    return fabs(signedAngleDifference(_a, _b));
+}
+
+// first node a change of the transition can move, the same restart point the transition widget asks updateTrack() for
+int sweepCheckpoint(subfunc* _sub)
+{
+    return std::max(0, (int)(_sub->minArgument*F_HZ-1.5f));
+}
+
+// scaled distances of the exit to every active target
+QVector<float> residuals(const sweepresult_t &_result, const sweeptarget_t &_target)
+{
+    QVector<float> r;
+    if(_target.useHeight) r.append((_result.pos.y - _target.height)/SWEEP_SCALE_HEIGHT);
+    if(_target.useSpeed) r.append((_result.vel - _target.speed)/SWEEP_SCALE_SPEED);
+    if(_target.usePitch) r.append(signedAngleDifference(_result.pitch, _target.pitch)/SWEEP_SCALE_ANGLE);
+    if(_target.useRoll) r.append(signedAngleDifference(_result.roll, _target.roll)/SWEEP_SCALE_ANGLE);
+    return r;
+}
+
+float sumOfSquares(const QVector<float> &_r)
+{
+    float sum = 0.f;
+    for(int i = 0; i < _r.size(); ++i) sum += _r[i]*_r[i];
+    return sum;
+}
+
+// gaussian elimination with partial pivoting, the systems have one row per swept parameter
+bool solveLinear(QVector<double> _a, QVector<double> _b, QVector<double> &_x)
+{
+    const int n = _b.size();
+    for(int c = 0; c < n; ++c) {
+        int pivot = c;
+        for(int r = c+1; r < n; ++r) {
+            if(fabs(_a[r*n+c]) > fabs(_a[pivot*n+c])) pivot = r;
+        }
+        if(fabs(_a[pivot*n+c]) < 1e-12) return false;
+        for(int k = 0; k < n; ++k) std::swap(_a[c*n+k], _a[pivot*n+k]);
+        std::swap(_b[c], _b[pivot]);
+        for(int r = c+1; r < n; ++r) {
+            double f = _a[r*n+c]/_a[c*n+c];
+            for(int k = c; k < n; ++k) _a[r*n+k] -= f*_a[c*n+k];
+            _b[r] -= f*_b[c];
+        }
+    }
+    _x.resize(n);
+    for(int r = n-1; r >= 0; --r) {
+        double sum = _b[r];
+        for(int k = r+1; k < n; ++k) sum -= _a[r*n+k]*_x[k];
+        _x[r] = sum/_a[r*n+r];
+    }
+    return true;
+}
+
+void evaluate(section* _copy, const sweeptarget_t &_target, sweepresult_t &_result)
+{
+    _result.valid = false;
+    _result.score = std::numeric_limits<float>::max();
+    if(_copy->lNodes.size() < 2) return;
+
+    mnode last = _copy->lNodes.last();
+    _result.pos = last.vPos;
+    _result.pitch = last.getPitch();
+    _result.yaw = last.getDirection();
+    _result.roll = last.fRoll;
+    _result.vel = last.fVel;
+    _result.maxNormal = _result.minNormal = _copy->lNodes[1].forceNormal;
+    _result.maxLateral = 0.f;
+    for(int i = 1; i < _copy->lNodes.size(); ++i) {
+        const mnode &node = _copy->lNodes[i];
+        _result.maxNormal = std::max(_result.maxNormal, node.forceNormal);
+        _result.minNormal = std::min(_result.minNormal, node.forceNormal);
+        _result.maxLateral = std::max(_result.maxLateral, (float)fabs(node.forceLateral));
+    }
+    if(_result.vel != _result.vel || _result.vel <= 0.f) return;
+
+    float score = 0.f;
+    if(_target.useHeight) score += fabs(_result.pos.y - _target.height)/SWEEP_SCALE_HEIGHT;
+    if(_target.useSpeed) score += fabs(_result.vel - _target.speed)/SWEEP_SCALE_SPEED;
+    if(_target.usePitch) score += angleDifference(_result.pitch, _target.pitch)/SWEEP_SCALE_ANGLE;
+    if(_target.useRoll) score += angleDifference(_result.roll, _target.roll)/SWEEP_SCALE_ANGLE;
+    _result.score = score;
+    _result.valid = true;
+}
+
+// one worker evaluates a contiguous block of variants on a single copy, the values are absolute so the copy is reused
+class sweepTask : public QRunnable
+{
+public:
+    sweepTask(sweepjob_t* _job, int _first, int _last) : job(_job), first(_first), last(_last) {}
+
+    void run()
+    {
+        section* copy = copySection(job->source);
+        if(copy != NULL) {
+            sweep(copy);
+            deleteCopy(copy);
+        }
+
+        if(!job->pending.deref()) {
+            job->cancelled = job->generation != sweepGeneration.loadAcquire();
+            qCInfo(Logging::logCore, "swept %d variants of %s in %.1f ms%s", job->results.size(), qPrintable(job->name),
+                   job->timer.nsecsElapsed()/1000000., job->cancelled ? ", cancelled" : "");
+            job->done();
+        }
+    }
+
+private:
+    void sweep(section* copy)
+    {
+        const QList<sweeprange_t> &ranges = job->ranges;
+        subfunc* sub = sweepFunc(copy, job->funcIndex)->funcList[job->subIndex];
+        // the nodes before the transition do not depend on it, only the first variant integrates them
+        int node = 0;
+
+        for(int v = first; v < last; ++v) {
+            if(job->generation != sweepGeneration.loadAcquire()) return;
+            sweepresult_t &result = job->results[v];
+            result.values.resize(ranges.size());
+            int rest = v;
+            for(int r = 0; r < ranges.size(); ++r) {
+                const int steps = std::max(1, ranges[r].steps);
+                result.values[r] = sweepValue(ranges[r], rest%steps);
+                rest /= steps;
+                applySweepValue(sub, ranges[r].parameter, result.values[r]);
+            }
+            copy->updateSection(node);
+            node = sweepCheckpoint(sub);
+            evaluate(copy, job->target, result);
+        }
+    }
+
+    sweepjob_t* job;
+    int first;
+    int last;
+};
+
+}
+
+int sweepVariants(const QList<sweeprange_t> &_ranges)
+{
+    int variants = 1;
+    for(int i = 0; i < _ranges.size(); ++i) {
+        variants *= std::max(1, _ranges[i].steps);
+        if(variants > SWEEP_MAX_VARIANTS) return SWEEP_MAX_VARIANTS+1;
+    }
+    return variants;
+}
+
+float sweepValue(const sweeprange_t &_range, int _step)
+{
+    if(_range.steps < 2) return _range.from;
+    return _range.from + (_range.to-_range.from)*_step/(_range.steps-1);
+}
+
+float getSweepValue(subfunc* _sub, enum eSweepParameter _parameter)
+{
+    switch(_parameter) {
+    case sweepSymArg:
+        return _sub->symArg;
+    case sweepArg1:
+        return _sub->arg1;
+    case sweepCenterArg:
+        return _sub->centerArg;
+    case sweepTensionArg:
+        return _sub->tensionArg;
+    case sweepLength:
+        return _sub->maxArgument - _sub->minArgument;
+    }
+    return 0.f;
+}
+
+// the same changes the transition widget makes for its spin boxes
+void applySweepValue(subfunc* _sub, enum eSweepParameter _parameter, float _value)
+{
+    switch(_parameter) {
+    case sweepSymArg:
+        _sub->symArg = _value;
+        _sub->parent->translateValues(_sub);
+        break;
+    case sweepArg1:
+        _sub->arg1 = _value;
+        _sub->parent->translateValues(_sub);
+        break;
+    case sweepCenterArg:
+        _sub->centerArg = _value;
+        break;
+    case sweepTensionArg:
+        _sub->tensionArg = _value;
+        break;
+    case sweepLength:
+        _sub->parent->changeLength(_value, _sub->parent->getSubfuncNumber(_sub));
+        break;
+    }
+}
+
+// returns right away, _done runs on a worker once every batch has finished or cancelSweeps() stopped them
+bool startSweep(sweepjob_t* _job, section* _section, subfunc* _sub, const QList<sweeprange_t> &_ranges, const sweeptarget_t &_target, std::function<void()> _done)
+{
+    if(_section == NULL || _sub == NULL || (_section->type != forced && _section->type != geometric)) return false;
+    const int variants = sweepVariants(_ranges);
+    if(variants > SWEEP_MAX_VARIANTS) return false;
+
+    _job->timer.start();
+    _job->name = _section->sName;
+    _job->source = saveSource(_section);
+    _job->ranges = _ranges;
+    _job->target = _target;
+    _job->funcIndex = _sub->parent == _section->rollFunc ? 0 : (_sub->parent == _section->normForce ? 1 : 2);
+    _job->subIndex = _sub->parent->getSubfuncNumber(_sub);
+    _job->generation = sweepGeneration.loadAcquire();
+    _job->cancelled = false;
+    _job->done = _done;
+
+    _job->results.resize(variants);
+    for(int v = 0; v < variants; ++v) {
+        _job->results[v].values.clear();
+        _job->results[v].valid = false;
+        _job->results[v].score = std::numeric_limits<float>::max();
+    }
+
+    const int batches = std::min(variants, std::max(1, sweepPool()->maxThreadCount()));
+    _job->pending.storeRelease(batches);
+    for(int b = 0; b < batches; ++b) {
+        sweepPool()->start(new sweepTask(_job, variants*b/batches, variants*(b+1)/batches));
+    }
+    return true;
+}
+
+// stops every running sweep after its current variant and waits for the workers, their jobs finish as cancelled
+void cancelSweeps()
+{
+    sweepGeneration.fetchAndAddOrdered(1);
+    sweepPool()->waitForDone();
+}
+
+int bestSweepResult(const QVector<sweepresult_t> &_results)
+{
+    int best = -1;
+    for(int i = 0; i < _results.size(); ++i) {
+        if(_results[i].valid && (best < 0 || _results[i].score < _results[best].score)) best = i;
+    }
+    return best;
+}
+
+solveresult_t solveSection(section* _section, subfunc* _sub, const QList<sweeprange_t> &_ranges, const sweeptarget_t &_target)
+{
+    solveresult_t solution;
+    solution.iterations = 0;
+    solution.integrations = 0;
+    solution.converged = false;
+    solution.exit.valid = false;
+    solution.exit.score = std::numeric_limits<float>::max();
+
+    const int n = _ranges.size();
+    const int m = (int)_target.useHeight + (int)_target.useSpeed + (int)_target.usePitch + (int)_target.useRoll;
+    if(_section == NULL || _sub == NULL || n == 0 || m == 0 || (_section->type != forced && _section->type != geometric)) return solution;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    int funcIndex = _sub->parent == _section->rollFunc ? 0 : (_sub->parent == _section->normForce ? 1 : 2);
+    int subIndex = _sub->parent->getSubfuncNumber(_sub);
+
+    section* copy = copySection(saveSource(_section));
+    subfunc* sub = sweepFunc(copy, funcIndex)->funcList[subIndex];
+
+    QVector<float> x(n), lower(n), upper(n), h(n);
+    for(int i = 0; i < n; ++i) {
+        lower[i] = std::min(_ranges[i].from, _ranges[i].to);
+        upper[i] = std::max(_ranges[i].from, _ranges[i].to);
+        x[i] = qBound(lower[i], getSweepValue(_sub, _ranges[i].parameter), upper[i]);
+        h[i] = SOLVE_STEP*std::max(upper[i]-lower[i], 0.01f);
+    }
+
+    // every integration after the first one restarts at the transition
+    int node = 0;
+    auto integrate = [&](const QVector<float> &_x, sweepresult_t &_result) -> float {
+        _result.values = _x;
+        for(int i = 0; i < n; ++i) {
+            applySweepValue(sub, _ranges[i].parameter, _x[i]);
+        }
+        copy->updateSection(node);
+        node = sweepCheckpoint(sub);
+        ++solution.integrations;
+        evaluate(copy, _target, _result);
+        return _result.valid ? sumOfSquares(residuals(_result, _target)) : std::numeric_limits<float>::max();
+    };
+
+    sweepresult_t current;
+    float cost = integrate(x, current);
+    QVector<float> r = current.valid ? residuals(current, _target) : QVector<float>();
+    float lambda = 0.001f;
+
+    while(current.valid && sqrt(cost) > SOLVE_TOLERANCE && solution.iterations < SOLVE_MAX_ITERATIONS) {
+        ++solution.iterations;
+
+        // forward differences, a step that would leave the range is taken backwards
+        QVector<double> jacobian(m*n);
+        bool ok = true;
+        for(int j = 0; j < n && ok; ++j) {
+            QVector<float> probe = x;
+            float step = x[j]+h[j] > upper[j] ? -h[j] : h[j];
+            probe[j] += step;
+            sweepresult_t result;
+            ok = integrate(probe, result) < std::numeric_limits<float>::max();
+            if(!ok) break;
+            QVector<float> rp = residuals(result, _target);
+            for(int k = 0; k < m; ++k) jacobian[k*n+j] = (rp[k]-r[k])/step;
+        }
+        if(!ok) break;
+
+        QVector<double> normal(n*n, 0.), gradient(n, 0.);
+        for(int a = 0; a < n; ++a) {
+            for(int k = 0; k < m; ++k) gradient[a] -= jacobian[k*n+a]*r[k];
+            for(int b = 0; b < n; ++b) {
+                for(int k = 0; k < m; ++k) normal[a*n+b] += jacobian[k*n+a]*jacobian[k*n+b];
+            }
+        }
+
+        bool improved = false;
+        while(!improved && lambda < 1e10f) {
+            QVector<double> damped = normal, delta;
+            for(int a = 0; a < n; ++a) damped[a*n+a] += lambda*normal[a*n+a] + 1e-9;
+            if(solveLinear(damped, gradient, delta)) {
+                QVector<float> next(n);
+                for(int a = 0; a < n; ++a) next[a] = qBound(lower[a], (float)(x[a]+delta[a]), upper[a]);
+                sweepresult_t result;
+                float nextCost = integrate(next, result);
+                if(nextCost < cost) {
+                    x = next;
+                    current = result;
+                    cost = nextCost;
+                    r = residuals(current, _target);
+                    lambda = std::max(lambda/3.f, 1e-7f);
+                    improved = true;
+                    continue;
+                }
+            }
+            lambda *= 4.f;
+        }
+        if(!improved) break;
+    }
+    deleteCopy(copy);
+
+    solution.exit = current;
+    solution.converged = current.valid && sqrt(cost) <= SOLVE_TOLERANCE;
+    qCInfo(Logging::logCore, "solved %s in %d iterations, %d integrations, %.1f ms: %s", qPrintable(_section->sName),
+           solution.iterations, solution.integrations, timer.nsecsElapsed()/1000000., solution.converged ? "converged" : "best effort");
+    return solution;
+}
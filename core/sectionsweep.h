@@ -0,0 +1,128 @@
+#ifndef SECTIONSWEEP_H
+#define SECTIONSWEEP_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QList>
+#include <QVector>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <functional>
+#include <string>
+#include "mnode.h"
+#include "section.h"
+
+class subfunc;
+
+#define SWEEP_MAX_VARIANTS 4096     // variants a single sweep evaluates at most
+
+// distances to the target are counted in these units when candidates are ranked
+#define SWEEP_SCALE_HEIGHT (1.f)    // m
+#define SWEEP_SCALE_SPEED (1.f)     // m/s
+#define SWEEP_SCALE_ANGLE (1.f)     // degrees of pitch and roll
+
+#define SOLVE_MAX_ITERATIONS 40     // levenberg-marquardt iterations before a solve gives up
+#define SOLVE_TOLERANCE (0.001f)    // largest scaled distance to the target of a solution
+#define SOLVE_STEP (0.001f)         // finite difference step, relative to the width of the parameter range
+
+enum eSweepParameter
+{
+    sweepSymArg,
+    sweepArg1,
+    sweepCenterArg,
+    sweepTensionArg,
+    sweepLength
+};
+
+typedef struct sweeprange_s {
+    enum eSweepParameter parameter;
+    float from;
+    float to;
+    int steps;
+} sweeprange_t;
+
+typedef struct sweeptarget_s {
+    bool useHeight;
+    float height;
+    bool useSpeed;
+    float speed;
+    bool usePitch;
+    float pitch;
+    bool useRoll;
+    float roll;
+} sweeptarget_t;
+
+typedef struct sweepresult_s {
+    QVector<float> values;      // one per range
+    glm::vec3 pos;
+    float pitch, yaw, roll;
+    float vel;
+    float maxNormal, minNormal, maxLateral;
+    float score;                // distance to the target, lower is better
+    bool valid;
+} sweepresult_t;
+
+// everything a copy needs from the section and its track, taken on the calling thread before any worker starts
+typedef struct sweepsource_s {
+    enum secType type;
+    mnode start;
+    std::string data;
+    bool bSpeed;
+    float fVel;
+    float fHeart;
+    float fFriction;
+    float fResistance;
+} sweepsource_t;
+
+// a sweep running in the background, the owner leaves it alone until done ran
+typedef struct sweepjob_s {
+    QVector<sweepresult_t> results;     // one per variant, the ones a cancelled sweep skipped stay invalid
+    bool cancelled;
+    sweepsource_t source;
+    QList<sweeprange_t> ranges;
+    sweeptarget_t target;
+    int funcIndex, subIndex;
+    int generation;
+    QAtomicInt pending;                 // batches still running
+    QElapsedTimer timer;
+    QString name;
+    std::function<void()> done;         // called on the worker of the last batch
+} sweepjob_t;
+
+typedef struct solveresult_s {
+    sweepresult_t exit;         // values and exit state of the solution
+    int iterations;
+    int integrations;
+    bool converged;
+} solveresult_t;
+
+int sweepVariants(const QList<sweeprange_t> &_ranges);
+float sweepValue(const sweeprange_t &_range, int _step);
+float getSweepValue(subfunc* _sub, enum eSweepParameter _parameter);
+void applySweepValue(subfunc* _sub, enum eSweepParameter _parameter, float _value);
+
+// evaluates every combination of the ranges on copies of _section in the background, the section itself is left untouched
+bool startSweep(sweepjob_t* _job, section* _section, subfunc* _sub, const QList<sweeprange_t> &_ranges, const sweeptarget_t &_target, std::function<void()> _done);
+void cancelSweeps();
+int bestSweepResult(const QVector<sweepresult_t> &_results);
+
+// adjusts the parameters of the ranges within their bounds until the exit meets the target, starting from their current values
+solveresult_t solveSection(section* _section, subfunc* _sub, const QList<sweeprange_t> &_ranges, const sweeptarget_t &_target);
+
+#endif // SECTIONSWEEP_H
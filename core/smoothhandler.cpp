@@ -59,7 +59,7 @@ smoothHandler::smoothHandler(track* _track, int _section, char* customChar, int
         treeItem->setText(1, QString("custom Region"));
         treeItem->setFlags(treeItem->flags() | Qt::ItemIsEditable);
     }
-    length = _length;
+    length = _length < 0 ? (int)(0.4f*F_HZ+0.5f) : _length;
     iterations = _iterations;
 
     update(customChar);
@@ -72,6 +72,13 @@ smoothHandler::~smoothHandler()
 
 
 void smoothHandler::update(char* customChar)
+{
+    updateRange();
+    updateLabels(customChar);
+}
+
+// the node range of the section, without the tree item it can run off the gui thread
+void smoothHandler::updateRange()
 {
     if(sec == (section*)-1)
     {
@@ -83,7 +90,10 @@ void smoothHandler::update(char* customChar)
         fromNode = m_track->getNumPoints(sec);
         toNode = fromNode + sec->lNodes.size() - 2;
     }
+}
 
+void smoothHandler::updateLabels(char* customChar)
+{
     if(sec == NULL)
     {
         if(customChar == NULL)
@@ -109,9 +119,9 @@ void smoothHandler::update(char* customChar)
             treeItem->setText(1, sec->sName);
         }
     }
-    treeItem->setText(2, QString::number(fromNode/1000.).append("s"));
-    treeItem->setText(3, QString::number(toNode/1000.).append("s"));
-    treeItem->setText(4, QString::number(length/1000.).append("s"));
+    treeItem->setText(2, QString::number(fromNode/F_HZ).append("s"));
+    treeItem->setText(3, QString::number(toNode/F_HZ).append("s"));
+    treeItem->setText(4, QString::number(length/F_HZ).append("s"));
     treeItem->setText(5, QString::number(iterations));
     treeItem->setCheckState(6, active ? Qt::Checked : Qt::Unchecked);
 }
@@ -139,18 +149,18 @@ int smoothHandler::getIterations()
 void smoothHandler::setFrom(int _arg)
 {
     fromNode = _arg;
-    treeItem->setText(2, QString::number(fromNode/1000.).append("s"));
+    treeItem->setText(2, QString::number(fromNode/F_HZ).append("s"));
 }
 void smoothHandler::setTo(int _arg)
 {
     toNode = _arg;
-    treeItem->setText(3, QString::number(toNode/1000.).append("s"));
+    treeItem->setText(3, QString::number(toNode/F_HZ).append("s"));
 }
 
 void smoothHandler::setLength(int _arg)
 {
     length = _arg;
-    treeItem->setText(4, QString::number(length/1000.).append("s"));
+    treeItem->setText(4, QString::number(length/F_HZ).append("s"));
 }
 
 void smoothHandler::setIterations(int _arg)
@@ -191,6 +201,19 @@ void smoothHandler::loadSmooth(std::fstream &file)
     update();
 }
 
+void smoothHandler::copySmooth(smoothHandler* _source)
+{
+    treeItem->setText(1, _source->treeItem->text(1));
+
+    setFrom(_source->fromNode);
+    setTo(_source->toNode);
+    setLength(_source->length);
+    setIterations(_source->iterations);
+    active = _source->active;
+
+    update();
+}
+
 void smoothHandler::legacyLoadSmooth(std::fstream &file)
 {
     int namelength = readInt(&file);
@@ -28,10 +28,12 @@ class section;
 class smoothHandler
 {
 public:
-    smoothHandler(track* _track, int _section, char* customChar = NULL, int _length = 400, int _iterations = 1, int _fromNode = 0, int _toNode = -1);
+    smoothHandler(track* _track, int _section, char* customChar = NULL, int _length = -1, int _iterations = 1, int _fromNode = 0, int _toNode = -1);
     ~smoothHandler();
 
     void update(char* customChar = NULL);
+    void updateRange();
+    void updateLabels(char* customChar = NULL);
 
 
     QTreeWidgetItem* treeItem;
@@ -51,6 +53,7 @@ public:
     void saveSmooth(std::fstream& file);
     void loadSmooth(std::fstream& file);
     void legacyLoadSmooth(std::fstream& file);
+    void copySmooth(smoothHandler* _source);
 
     bool active;
 
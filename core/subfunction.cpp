@@ -242,8 +242,8 @@ float subfunc::getValue(float x)
     case tozero:
         inTrack = parent->secParent->parent;
 
-        curNode = this->parent->secParent->parent->getPoint(inTrack->getNumPoints(parent->secParent)+minArgument*1000.f-0.5f);
-        prevNode = this->parent->secParent->parent->getPoint(inTrack->getNumPoints(parent->secParent)+minArgument*1000.f-1.5f);
+        curNode = this->parent->secParent->parent->getPoint(inTrack->getNumPoints(parent->secParent)+minArgument*F_HZ-0.5f);
+        prevNode = this->parent->secParent->parent->getPoint(inTrack->getNumPoints(parent->secParent)+minArgument*F_HZ-1.5f);
         if(this->parent->secParent->bOrientation == EULER)
         {
         d = (curNode->fRollSpeed + glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast
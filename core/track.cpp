@@ -25,6 +25,7 @@
 #include "trackmesh.h"
 #include "smoothui.h"
 #include "trackwidget.h"
+#include "graphwidget.h"
 
 #define RELTHRESH 0.98f
 
@@ -33,11 +34,6 @@ using namespace std;
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
 
-track::track()
-{
-
-}
-
 track::track(trackHandler* _parent, glm::vec3 startPos, float startYaw, float heartLine)
 {
     this->anchorNode = new mnode(glm::vec3(0.f, 0.f, 0.f), glm::vec3(0, 0, -1), 0., 10.f, 1., 0.);
@@ -46,6 +42,7 @@ track::track(trackHandler* _parent, glm::vec3 startPos, float startYaw, float he
     this->startPitch = 0.f;
     povPos = glm::vec2(0, 0);
     mParent = _parent;
+    cold = false;
     anchorNode->updateNorm();
     anchorNode->fEnergy = 0.5f*anchorNode->fVel*anchorNode->fVel + F_G*anchorNode->fPosHearty(0.9*heartLine);
     this->fHeart = heartLine;
@@ -63,21 +60,6 @@ track::track(trackHandler* _parent, glm::vec3 startPos, float startYaw, float he
     style = generic;
 }
 
-track::~track()
-{
-    while(lSections.size() != 0)
-    {
-        delete lSections.at(0);
-        lSections.removeAt(0);
-    }
-    while(smoothList.size() != 0)
-    {
-        delete smoothList[0];
-        smoothList.removeFirst();
-    }
-    delete anchorNode;
-}
-
 void track::removeSection(int index)
 {
     if(lSections.size() <= index) return;
@@ -193,20 +175,255 @@ void track::applySmooth(int fromNode)
     }
 }
 
+// the smoothing of the roll speed, only touches the nodes and the smooth handlers so the workers may run it
+void track::smoothRoll(int fromNode)
+{
+    removeSmooth(fromNode);
+
+    anchorNode->fRollSpeed = 0.0;
+
+    int sec, curNode = fromNode < 0 ? 0 : fromNode;
+    for(sec = 0; sec < lSections.size(); ++sec)
+    {
+        if(lSections[sec]->lNodes.size() >= curNode)
+        {
+            break;
+        }
+        curNode -= lSections[sec]->lNodes.size()-1;
+    }
+
+    for(; sec < lSections.size(); ++sec)
+    {
+        section* curSection = lSections[sec];
+        for(int i = curNode; i < curSection->lNodes.size(); ++i)
+        {
+			curSection->lNodes[i].fSmoothSpeed = 0.f;
+        }
+        curNode = 0;
+    }
+
+    for(int i = 0; i < smoothList.size(); ++i)
+    {
+        smoothHandler* cur = smoothList[i];
+        if(cur->active == false) continue;
+
+        if(cur->getTo() > fromNode)
+        {
+            applyRollSmoothFilter(cur);
+        }
+    }
+
+    if(smoothActive())
+    {
+        applySmooth(fromNode);
+    }
+    hasChanged = true;
+    return;
+}
+
+void track::applyRollSmoothFilter(smoothHandler* _handler)
+{
+    const int iter = _handler->getIterations();
+    const int length = _handler->getLength()/iter;
+    const int fromNode = _handler->getFrom();
+    const int toNode = _handler->getTo();
+
+    QVector<double> adjustValues;
+
+    QVector<double> *cur = new QVector<double>();
+    QVector<double> *last = new QVector<double>();
+    QVector<double> orig;
+    QVector<double> *swap;
+
+    mnode* curNode;
+
+    if(toNode - fromNode - length/2*iter < 0)
+    {
+        lenAssert(0 && "Smoothing not possible");
+        return;
+    }
+
+    double lastValue = 0., firstValue = 0.;
+    for(int i = 0; i <= length/2*iter; ++i)
+    {
+        curNode = getPoint(toNode - i);
+        lastValue += curNode->fRollSpeed + curNode->fSmoothSpeed;
+        curNode =  getPoint(fromNode + i);
+        firstValue += curNode->fRollSpeed + curNode->fSmoothSpeed;
+    }
+    lastValue /= length/2*iter + 1;
+    firstValue /= length/2*iter + 1;
+
+    for(int i = fromNode; i < toNode; ++i)
+    {
+        if(length == 0)
+        {
+            curNode = getPoint(i);
+            cur->append(curNode->fRollSpeed + curNode->fSmoothSpeed);
+            last->append(cur->last());
+            orig.append(cur->last());
+            continue;
+        }
+        double t1 = (i - fromNode - length/2.*iter)/(length/2. * iter);
+        double t2 = (toNode - length/2.*iter - i)/(length/2. * iter);
+        if(t1 < 0) t1 = 1.;
+        else t1 = exp(-2*t1*t1);
+        if(t2 < 0) t2 = 1.;
+        else t2 = exp(-2*t2*t2);
+        double t = (1. - t1)*(1. - t2);
+        if(t != t) t = 0.;
+
+        if(t2 > t1)
+        {
+            if(t > t2) { // max = t
+                if(fabs(t1+t2) > std::numeric_limits<double>::epsilon())
+                {
+                    t2 = t2/(t1+t2)*(1.-t);
+                    t1 = t1/(t1+t2)*(1.-t);
+                }
+            } else {   // max = t2
+                if(fabs(t1+t) > std::numeric_limits<double>::epsilon())
+                {
+                    t = t/(t1+t)*(1.-t2);
+                    t1 = t1/(t1+t)*(1.-t2);
+                }
+            }
+        }
+        else
+        {
+            if(t > t1) { // max = t
+                if(fabs(t1+t2) > std::numeric_limits<double>::epsilon())
+                {
+                    t2 = t2/(t1+t2)*(1.-t);
+                    t1 = t1/(t1+t2)*(1.-t);
+                }
+            } else {   // max = t1
+                if(fabs(t+t2) > std::numeric_limits<double>::epsilon())
+                {
+                    t = t/(t2+t)*(1.-t1);
+                    t2 = t2/(t2+t)*(1.-t1);
+                }
+            }
+        }
+        if(i < fromNode + length/2 * iter)
+        {
+            cur->append(firstValue);
+        }
+        else if(i > toNode - length/2*iter)
+        {
+            cur->append(lastValue);
+        }
+        else
+        {
+            curNode = getPoint(i);
+            cur->append(t*(curNode->fRollSpeed + curNode->fSmoothSpeed) + t1*firstValue + t2*lastValue);
+        }
+        last->append(cur->last());
+        orig.append(cur->last());
+    }
+
+    for(int iterations = 0; iterations < iter; ++iterations)
+    {
+        swap = cur;
+        cur = last;
+        last = swap;
+        for(int i = 0; i < cur->size(); ++i)
+        {
+            double temp = 0.0, div = 0.;
+
+            for(int j = -length/2; j <= length/2; ++j)
+            {
+                if(i+j < 0)
+                {
+                    temp += last->at(0);
+                }
+                else if(i+j >= last->size())
+                {
+                    temp += last->last();
+                }
+                else
+                {
+                    temp += last->at(i+j);
+                }
+                div = length/2 * 2 + 1;
+            }
+            cur->replace(i, temp/div);
+        }
+    }
+
+    for(int i = 0; i < cur->size(); ++i)
+    {
+        adjustValues.append(cur->at(i) - orig[i]);
+    }
+
+    for(int i = 0; i < adjustValues.size(); ++i)
+    {
+        getPoint(i+fromNode)->fSmoothSpeed += adjustValues[i];
+    }
+
+    delete cur;
+    delete last;
+}
+
+bool track::smoothActive()
+{
+    for(int i = 0; i < smoothList.size(); ++i)
+    {
+        if(smoothList[i]->active) return true;
+    }
+    return false;
+}
+
 void track::updateTrack(int index, int iNode)
 {
     //qDebug("called updateTrack(%d, %d)", index, iNode);
+    QElapsedTimer timer;
+    float mSec;
+    timer.start();
+
+    bool smoothed = false;
+    int nodeAt = integrateTrack(index, iNode, &smoothed);
+    if(nodeAt < 0) return;
+
+    updateSmoothLabels();
+    if(smoothed) mParent->graphWidgetItem->redrawGraphs();
+    if(index < 0) index = 0;
+    unsigned int count = getNumPoints() - nodeAt;
+    unsigned int count2 = getNumPoints() - iNode - getNumPoints(lSections[index]);
+
+    if(mParent->mMesh != NULL)
+        mParent->mMesh->buildMeshes(nodeAt);
+
+    mSec = timer.nsecsElapsed()/1000000.;
+    gloParent->showMessage(QString::number(mSec).append(QString("ms used to update %1 (%2) points").arg(count2).arg(count)), 3000);
+}
+
+void track::updateSmoothLabels()
+{
+    for(int i = 0; i < smoothList.size(); ++i)
+    {
+        if(smoothList[i]->active) smoothList[i]->updateLabels();
+    }
+}
+
+// a set abort stops between two sections, the track is left cold and integrated from the start next time
+int track::integrateTrack(int index, int iNode, bool* smoothed, const QAtomicInt* abort)
+{
     if(index < 0) index = 0;
+    if(cold)
+    {
+        // only the first node of every section is left
+        cold = false;
+        index = 0;
+        iNode = 0;
+    }
     if(lSections.size() <= index)
     {
         hasChanged = true;
-        return;   // for savety
+        return -1;   // for savety
     }
 
-    QElapsedTimer timer;
-    float mSec;
     bool useSmoothing = false;
-    timer.start();
 
     int nodeAt = (lSections[index]->type == straight || lSections[index]->type == curved) ? 0 : iNode;
     for(int i = 0; i < index; ++i)
@@ -219,7 +436,7 @@ void track::updateTrack(int index, int iNode)
         smoothHandler* cur = smoothList[i];
         if(cur->active == false) continue;
 
-        cur->update();
+        cur->updateRange();
         if(cur->getTo() > nodeAt)
         {
             useSmoothing = true;
@@ -239,24 +456,25 @@ void track::updateTrack(int index, int iNode)
     int updateFrom = lSections.at(index)->updateSection(iNode);
     for(int i = index+1; i < lSections.size(); i++)
     {
+        if(abort != NULL && abort->loadAcquire())
+        {
+            cold = true;
+            return -1;
+        }
 		lSections.at(i)->lNodes.prepend(lSections.at(i-1)->lNodes[lSections.at(i-1)->lNodes.size()-1]);
         lSections.at(i)->updateSection(0);
     }
 
-    if(useSmoothing && smoother && smoother->active()) smoother->applyRollSmooth(nodeAt);
-
-    unsigned int count = getNumPoints() - nodeAt;
-    unsigned int count2 = getNumPoints() - iNode - getNumPoints(lSections[index]);
+    if(useSmoothing)
+    {
+        smoothRoll(nodeAt);
+        if(smoothed) *smoothed = true;
+    }
 
     nodeAt = nodeAt > getNumPoints(lSections[index])+updateFrom ? getNumPoints(lSections[index])+updateFrom : nodeAt;
 
-    if(mParent->mMesh != NULL)
-        mParent->mMesh->buildMeshes(nodeAt);
-
-    mSec = timer.nsecsElapsed()/1000000.;
-    gloParent->showMessage(QString::number(mSec).append(QString("ms used to update %1 (%2) points").arg(count2).arg(count)), 3000);
-
     hasChanged = true;
+    return nodeAt;
 }
 
 void track::updateTrack(section* fromSection, int iNode)
@@ -270,6 +488,94 @@ void track::updateTrack(section* fromSection, int iNode)
     updateTrack(i, iNode);
 }
 
+void track::previewTrack(int index, int iNode)
+{
+    if(cold)
+    {
+        updateTrack(index, iNode);
+        return;
+    }
+    // cheap stand in for updateTrack() while a value is still being dragged,
+    // only the edited section is integrated and meshed, the sections behind it and the smoothing wait for the next updateTrack()
+    if(index < 0) index = 0;
+    if(lSections.size() <= index)
+    {
+        hasChanged = true;
+        return;
+    }
+
+    int nodeAt = (lSections[index]->type == straight || lSections[index]->type == curved) ? 0 : iNode;
+    nodeAt += getNumPoints(lSections[index]);
+
+    int updateFrom = lSections.at(index)->updateSection(iNode);
+
+    nodeAt = nodeAt > getNumPoints(lSections[index])+updateFrom ? getNumPoints(lSections[index])+updateFrom : nodeAt;
+
+    if(mParent->mMesh != NULL)
+        mParent->mMesh->buildMeshes(nodeAt, index+1);
+
+    hasChanged = true;
+}
+
+void track::previewTrack(section* fromSection, int iNode)
+{
+    int i = lSections.indexOf(fromSection);
+    if(i < 0) return;
+    previewTrack(i, iNode);
+}
+
+// tracks nobody edits or looks at drop every node but the first one of each section,
+// the section parameters are all integrateTrack() needs to restore them,
+// the GPU mesh stays as it is and its CPU side vertex lists are rebuilt when needed
+void track::compactTrack()
+{
+    if(cold) return;
+    for(int i = 0; i < lSections.size(); ++i)
+    {
+        QVector<mnode> &nodes = lSections[i]->lNodes;
+        if(nodes.size() > 1) nodes.resize(1);
+        nodes.squeeze();
+    }
+    if(mParent != NULL && mParent->mMesh != NULL) mParent->mMesh->releaseLists();
+    cold = true;
+}
+
+// returns whether the nodes had to be integrated again
+bool track::materializeTrack()
+{
+    if(mParent != NULL) mParent->lastUsed.start();
+    // a stub of a loaded project may still be queued for or held by a worker
+    if(claimTrack(mParent)) return true;
+    if(!cold) return false;
+    integrateTrack(0, 0);
+    return true;
+}
+
+void track::resample(float fromHz, bool integrate)
+{
+    // the sections are functions of time or distance and only need to be integrated again,
+    // the per node changes of the anchor and the smoothing windows are counted in nodes of fromHz
+    const float scale = F_HZ/fromHz;
+
+    anchorNode->fPitchFromLast /= scale;
+    anchorNode->fYawFromLast /= scale;
+
+    for(int i = 0; i < smoothList.size(); ++i)
+    {
+        smoothHandler* cur = smoothList[i];
+        cur->setFrom((int)(cur->getFrom()*scale+0.5f));
+        cur->setTo((int)(cur->getTo()*scale+0.5f));
+        cur->setLength(qMax(1, (int)(cur->getLength()*scale+0.5f)));
+    }
+    if(!integrate) return;  // the caller integrates and refreshes the smoothing
+
+    updateTrack(0, 0);
+    for(int i = 0; i < smoothList.size(); ++i)
+    {
+        smoothList[i]->update();
+    }
+}
+
 void track::newSection(enum secType type, int index)
 {
     mnode* startNode;
@@ -1022,7 +1328,7 @@ QString track::saveTrack(fstream& file, trackWidget* _widget)
     return QString("Save Successful");
 }
 
-QString track::loadTrack(fstream& file, trackWidget* _widget)
+QString track::loadTrack(fstream& file, trackWidget* _widget, bool integrate)
 {
     int namelength = readInt(&file);
     name = QString(readString(&file, namelength).c_str());
@@ -1063,58 +1369,29 @@ QString track::loadTrack(fstream& file, trackWidget* _widget)
     int size = readInt(&file);
     for(int i = 0; i < size; ++i)
     {
+        enum secType type;
         temp = readString(&file, 3);
-        if(temp == "STR")
-        {
-            _widget->addStraightSec();
-            //this->newSection(straight);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addStraightSec(activeSection);
-        }
-        else if(temp == "CUR")
-        {
-            _widget->addCurvedSec();
-            //this->newSection(curved);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addCurvedSec(activeSection);
-        }
-        else if(temp == "GEO")
-        {
-            _widget->addGeometricSec();
-            //this->newSection(geometric);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addGeometricSec(activeSection);
-        }
-        else if(temp == "FRC")
-        {
-            _widget->addForceSec();
-            //this->newSection(forced);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
-        }
-        else if(temp == "BEZ")
+        if(temp == "STR") type = straight;
+        else if(temp == "CUR") type = curved;
+        else if(temp == "GEO") type = geometric;
+        else if(temp == "FRC") type = forced;
+        else if(temp == "BEZ") type = bezier;
+        else if(temp == "CSV") type = nolimitscsv;
+        else
         {
-            _widget->addSection(bezier);
-            //this->newSection(forced);
-            activeSection->loadSection(file);
-            activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
+            return QString("Error while Loading: No Such Segment!");
         }
-        else if(temp == "CSV")
+
+        if(integrate)
         {
-            _widget->addSection(nolimitscsv);
-            //this->newSection(forced);
+            _widget->addSection(type);
             activeSection->loadSection(file);
             activeSection->updateSection();
-            //gloParent->addForceSec(activeSection);
         }
         else
         {
-            return QString("Error while Loading: No Such Segment!");
+            // only the parameters, the track is integrated from its start once it is needed
+            _widget->addSectionStub(type)->loadSection(file);
         }
     }
 
@@ -1129,7 +1406,8 @@ QString track::loadTrack(fstream& file, trackWidget* _widget)
     temp = readString(&file, 3);
     if(temp == "EOT")
     {
-        updateTrack(0, 0);
+        if(integrate) updateTrack(0, 0);
+        else compactTrack();
         _widget->clearSelection();
         _widget->setNames();
         return QString("Load Successful");
@@ -1140,6 +1418,49 @@ QString track::loadTrack(fstream& file, trackWidget* _widget)
     }
 }
 
+// fills this empty track with the settings and sections of _source without integrating anything,
+// every section shares its nodes with the one in _source until either of them is integrated again
+void track::cloneTrack(track* _source, trackWidget* _widget)
+{
+    for(int i = 0; i < 3; ++i) {
+        mParent->trackColors[i] = _source->mParent->trackColors[i];
+    }
+
+    startPos = _source->startPos;
+    startPitch = _source->startPitch;
+    startYaw = _source->startYaw;
+    *anchorNode = *_source->anchorNode;
+
+    fHeart = _source->fHeart;
+    fFriction = _source->fFriction;
+    fResistance = _source->fResistance;
+
+    drawTrack = _source->drawTrack;
+    drawHeartline = _source->drawHeartline;
+    style = _source->style;
+    mParent->mMesh->isWireframe = _source->mParent->mMesh->isWireframe;
+    povPos = _source->povPos;
+
+    _widget->updateAnchorGeometrics();
+
+    for(int i = 0; i < _source->lSections.size(); ++i)
+    {
+        _widget->addSharedSection(_source->lSections[i]);
+    }
+
+    for(int i = 0; i < _source->smoothList.size(); ++i)
+    {
+        if(i >= smoothList.size()) smoothList.append(new smoothHandler(this, -2));
+
+        smoothList[i]->copySmooth(_source->smoothList[i]);
+    }
+    smoothedUntil = _source->smoothedUntil;
+
+    _widget->clearSelection();
+    _widget->setNames();
+    hasChanged = true;
+}
+
 QString track::legacyLoadTrack(fstream& file, trackWidget* _widget)
 {
     int namelength = readInt(&file);
@@ -1258,22 +1579,6 @@ QString track::legacyLoadTrack(fstream& file, trackWidget* _widget)
     }
 }
 
-mnode* track::getPoint(int index)
-{
-    int i = 0;
-    if(index < 0) index = 0;
-    while(lSections.size() > i && index > lSections.at(i)->lNodes.size()-1)
-    {
-        index -= lSections.at(i++)->lNodes.size()-1;
-    }
-    if(lSections.size() == i)
-    {
-		if(lSections.size())    return &lSections.last()->lNodes.last();
-        else return anchorNode;
-    }
-	return &lSections.at(i)->lNodes[index];
-}
-
 int  track::getIndexFromDist(float dist)
 {
     int lower = 0;
@@ -1306,55 +1611,3 @@ int  track::getIndexFromDist(float dist)
         return (upper+lower)/2;
     }
 }
-
-int track::getNumPoints(section* until)
-{
-
-    int sum = 0;
-    for(int i = 0; i < lSections.size(); ++i)
-    {
-        if(lSections.at(i) == until) return sum;
-        sum += lSections.at(i)->lNodes.size()-1;
-    }
-    return sum;
-}
-
-int track::getSectionNumber(section *_section)
-{
-    int number = 0;
-    while(number < lSections.size() && lSections.at(number) != _section) ++number;
-    if(number < lSections.size())
-    {
-        return number;
-    }
-    else
-    {
-        return -1;
-    }
-}
-
-void track::getSecNode(int index, int *node, int *section)
-{
-    int i = 0;
-    while(lSections.size() > i && index > lSections.at(i)->lNodes.size()-1)
-    {
-        index -= lSections.at(i++)->lNodes.size()-1;
-    }
-    if(lSections.size() == i)
-    {
-        if(lSections.size())
-        {
-            *node = lSections.last()->lNodes.size()-1;
-            *section = lSections.size()-1;
-        }
-        else
-        {
-            *node = 0;
-            *section = -1;
-        }
-        return;
-    }
-    *node = index;
-    *section = i;
-    return;
-}
@@ -29,7 +29,9 @@
 #include "sectionhandler.h"
 #include <QList>
 #include <fstream>
+#include <atomic>
 #include <QString>
+#include <QAtomicInt>
 
 class optionsMenu;
 class sectionHandler;
@@ -60,9 +62,19 @@ public:
 
     void removeSmooth(int fromNode = 0);
     void applySmooth(int fromNode = 0);
+    void smoothRoll(int fromNode = 0);
+    void applyRollSmoothFilter(smoothHandler* _handler);
+    bool smoothActive();
 
     void updateTrack(int index, int iNode);
+    int integrateTrack(int index, int iNode, bool* smoothed = NULL, const QAtomicInt* abort = NULL);
+    void updateSmoothLabels();
     void updateTrack(section* fromSection, int iNode);
+    void previewTrack(int index, int iNode);
+    void previewTrack(section* fromSection, int iNode);
+    void resample(float fromHz, bool integrate = true);
+    void compactTrack();
+    bool materializeTrack();
     void newSection(enum secType type, int index = -1);
 
     int exportTrack(std::fstream* file, float mPerNode, int fromIndex, int toIndex, float fRollThresh);
@@ -73,16 +85,19 @@ public:
     void exportNL2Track(FILE *file, float mPerNode, int fromIndex, int toIndex);
 
     QString saveTrack(std::fstream& file, trackWidget* _widget);
-    QString loadTrack(std::fstream& file, trackWidget* _widget);
+    QString loadTrack(std::fstream& file, trackWidget* _widget, bool integrate = true);
     QString legacyLoadTrack(std::fstream& file, trackWidget* _widget);
+    void cloneTrack(track* _source, trackWidget* _widget);
     mnode* getPoint(int index);
+    mnode* readPoint(int index);
     int getIndexFromDist(float dist);
     int getNumPoints(section* until = NULL);
     int getSectionNumber(section* _section);
 
     void getSecNode(int index, int *node, int *section);
 
-    bool hasChanged;
+    std::atomic<bool> hasChanged;   // also set by the workers of warmTracks()
+    bool cold;          // compacted by compactTrack(), integrated from the start on the next update
     bool drawTrack;
     int drawHeartline;
 
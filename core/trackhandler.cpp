@@ -24,7 +24,13 @@
 #include "mainwindow.h"
 #include "trackmesh.h"
 #include "trackwidget.h"
+#include "smoothui.h"
+#include "sectionkernel.h"
 #include <QTreeWidgetItem>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QWaitCondition>
 
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
@@ -48,6 +54,11 @@ trackHandler::trackHandler(QString _name, int _id)
     trackWidgetItem->hide();
 
     tabId = -1;
+    isStub = false;
+    isStale = false;
+    staleNodes = false;
+    warmMesh = NULL;
+    lastUsed.start();
 
     trackColors[0] = QColor(20, 20, 130);
     trackColors[1] = QColor(255, 51, 51);
@@ -58,8 +69,14 @@ trackHandler::trackHandler(QString _name, int _id)
     mMesh = new trackMesh(trackData);
 }
 
+namespace {
+bool releaseTrack(trackHandler* _track);
+}
+
 trackHandler::~trackHandler()
 {
+    if(isStub || isStale) releaseTrack(this);
+    delete warmMesh;
     delete trackWidgetItem;
     delete graphWidgetItem;
     delete listItem;
@@ -78,3 +95,265 @@ int trackHandler::getID()
 {
     return id;
 }
+
+namespace {
+// a track to integrate and mesh, with the settings of the GUI when it was queued,
+// the workers never read the options, the view or the globals the GUI may change meanwhile
+typedef struct warmjob_s
+{
+    trackHandler* track;
+    bool integrate;         // the nodes are out of date too, not only the mesh
+    trackMesh* mesh;        // the mesh of a stub or the warmMesh of a track that is still drawn
+    float sampleRate;
+    float tolerance;
+    meshsettings_t settings;
+    MainWindow* notify;
+    QAtomicInt abort;       // checked between sections, see track::integrateTrack()
+} warmjob_t;
+
+// the workers always take the first job of warmQueue
+QMutex warmMutex;
+QWaitCondition warmCondition;
+QList<warmjob_t*> warmQueue;
+QList<warmjob_t*> warmRunning;
+QList<trackHandler*> warmDone;     // integrated and meshed, waiting for uploadWarmTracks()
+
+QThreadPool* warmPool()
+{
+    // not the global pool, stopWarming() waits for all of its tasks
+    static QThreadPool* pool = new QThreadPool();
+    return pool;
+}
+
+warmjob_t* findJob(const QList<warmjob_t*> &_jobs, trackHandler* _track)
+{
+    for(int i = 0; i < _jobs.size(); ++i)
+    {
+        if(_jobs[i]->track == _track) return _jobs[i];
+    }
+    return NULL;
+}
+
+// the running jobs are cancelled, so this only waits until their workers reach the next section
+void cancelRunning(trackHandler* _track)
+{
+    for(int i = 0; i < warmRunning.size(); ++i)
+    {
+        if(_track == NULL || warmRunning[i]->track == _track) warmRunning[i]->abort.storeRelease(1);
+    }
+    while(_track == NULL ? !warmRunning.isEmpty() : findJob(warmRunning, _track) != NULL) warmCondition.wait(&warmMutex);
+}
+
+// takes a track away from the workers, returns whether one of them already finished it
+bool releaseTrack(trackHandler* _track)
+{
+    QMutexLocker locker(&warmMutex);
+    for(int i = warmQueue.size()-1; i >= 0; --i)
+    {
+        if(warmQueue[i]->track == _track) delete warmQueue.takeAt(i);
+    }
+    cancelRunning(_track);
+    return warmDone.removeAll(_track) > 0;
+}
+
+// the mesh a worker or claimTrack() builds, a stale track keeps drawing its old one meanwhile, needs the GL context
+trackMesh* warmTarget(trackHandler* _track)
+{
+    if(!_track->isStale) return _track->mMesh;
+    if(_track->warmMesh == NULL && _track->mMesh != NULL)
+    {
+        _track->warmMesh = new trackMesh(_track->trackData);
+        _track->warmMesh->isWireframe = _track->mMesh->isWireframe;
+    }
+    return _track->warmMesh;
+}
+
+// the track has its nodes and a generated mesh, needs the GL context
+void finishStub(trackHandler* _track)
+{
+    _track->isStub = false;
+    if(_track->isStale)
+    {
+        delete _track->mMesh;
+        _track->mMesh = _track->warmMesh;
+        _track->warmMesh = NULL;
+        _track->isStale = false;
+        _track->staleNodes = false;
+    }
+    _track->trackData->hasChanged = true;
+    if(_track->trackData->smoother) _track->trackData->smoother->updateUi();
+    if(_track->mMesh == NULL) return;
+    if(_track->mMesh->isInit) _track->mMesh->uploadMeshes();
+    else _track->mMesh->init(false);
+}
+
+class warmTask : public QRunnable
+{
+public:
+    void run()
+    {
+        warmMutex.lock();
+        if(warmQueue.isEmpty()) {
+            warmMutex.unlock();
+            return;
+        }
+        warmjob_t* job = warmQueue.takeFirst();
+        warmRunning.append(job);
+        warmMutex.unlock();
+
+        fTaskSampleRate = job->sampleRate;
+        fTaskTolerance = job->tolerance;
+        track* curTrack = job->track->trackData;
+        if(job->integrate || curTrack->cold) curTrack->integrateTrack(0, 0, NULL, &job->abort);
+        if(!job->abort.loadAcquire() && job->mesh != NULL) job->mesh->generateMeshes(0, job->settings);
+        fTaskSampleRate = 0.f;
+        fTaskTolerance = -1.f;
+
+        bool finished = !job->abort.loadAcquire();
+        warmMutex.lock();
+        warmRunning.removeOne(job);
+        if(finished) warmDone.append(job->track);
+        warmCondition.wakeAll();
+        warmMutex.unlock();
+
+        if(finished) emit job->notify->emitTracksWarmed();
+        delete job;
+    }
+};
+}
+
+// only the track of the current tab is updated on this thread, its graphs and the view need it right away,
+// the others keep drawing their old mesh until a worker rebuilt them, a tab or an export claims them first,
+// mesh only changes leave their nodes alone
+void recomputeTracks(const QList<trackHandler*> &_allTracks, bool _integrate)
+{
+    stopWarming();
+    track* active = gloParent->curTrack();
+    trackHandler* curTrack = NULL;
+    for(int i = 0; i < _allTracks.size(); ++i)
+    {
+        if(_allTracks[i]->isStub) continue;
+        if(_allTracks[i]->trackData == active)
+        {
+            curTrack = _allTracks[i];
+            continue;
+        }
+        _allTracks[i]->isStale = true;
+        if(_integrate) _allTracks[i]->staleNodes = true;
+    }
+
+    if(curTrack != NULL)
+    {
+        QElapsedTimer timer;
+        timer.start();
+
+        bool didSmooth = false;
+        bool cold = curTrack->trackData->cold;
+        if(_integrate || cold || curTrack->staleNodes) curTrack->trackData->integrateTrack(0, 0, &didSmooth);
+        glView->makeCurrent();
+        if(curTrack->isStale)
+        {
+            delete curTrack->warmMesh;
+            curTrack->warmMesh = NULL;
+            curTrack->isStale = false;
+            curTrack->staleNodes = false;
+        }
+        if(curTrack->mMesh != NULL)
+        {
+            curTrack->mMesh->generateMeshes(0);
+            curTrack->mMesh->uploadMeshes();
+        }
+        curTrack->trackData->updateSmoothLabels();
+        if(didSmooth) curTrack->graphWidgetItem->redrawGraphs();
+        if(cold) curTrack->trackData->compactTrack();
+
+        float mSec = timer.nsecsElapsed()/1000000.;
+        gloParent->showMessage(QString::number(mSec).append(QString("ms used to update %1").arg(curTrack->trackData->name)), 3000);
+    }
+
+    warmTracks(_allTracks);
+}
+
+// a loaded project only reads the section parameters, the stubs are integrated and meshed here in the background,
+// the tracks shown in the view first and in list order, the hidden ones are only needed for a tab or an export
+void warmTracks(const QList<trackHandler*> &_tracks)
+{
+    QList<trackHandler*> queue;
+    for(int i = 0; i < _tracks.size(); ++i)
+    {
+        if((_tracks[i]->isStub || _tracks[i]->isStale) && _tracks[i]->trackData->drawTrack) queue.append(_tracks[i]);
+    }
+    for(int i = 0; i < _tracks.size(); ++i)
+    {
+        if((_tracks[i]->isStub || _tracks[i]->isStale) && !_tracks[i]->trackData->drawTrack) queue.append(_tracks[i]);
+    }
+
+    glView->makeCurrent();
+    meshsettings_t settings = currentMeshSettings();
+    int started = 0;
+    warmMutex.lock();
+    for(int i = 0; i < queue.size(); ++i)
+    {
+        if(findJob(warmQueue, queue[i]) || findJob(warmRunning, queue[i]) || warmDone.contains(queue[i])) continue;
+        warmjob_t* job = new warmjob_t;
+        job->track = queue[i];
+        job->integrate = queue[i]->isStub || queue[i]->staleNodes;
+        job->mesh = warmTarget(queue[i]);
+        job->sampleRate = fSampleRate;
+        job->tolerance = fAdaptiveTolerance;
+        job->settings = settings;
+        job->notify = gloParent;
+        warmQueue.append(job);
+        ++started;
+    }
+    warmMutex.unlock();
+
+    for(int i = 0; i < started; ++i)
+    {
+        warmPool()->start(new warmTask());
+    }
+}
+
+// a stub or stale track that is needed right now, a tab or an export, is finished on this thread unless a worker
+// already has it, returns whether the track was one
+bool claimTrack(trackHandler* _track)
+{
+    if(!_track->isStub && !_track->isStale) return false;
+
+    glView->makeCurrent();
+    if(!releaseTrack(_track))
+    {
+        if(_track->isStub || _track->staleNodes || _track->trackData->cold) _track->trackData->integrateTrack(0, 0);
+        trackMesh* mesh = warmTarget(_track);
+        if(mesh != NULL) mesh->generateMeshes(0);
+    }
+    finishStub(_track);
+    return true;
+}
+
+// drops the queued jobs and cancels the running ones, even the finished ones are built again once warmTracks() queues them,
+// nothing touches the tracks afterwards
+void stopWarming()
+{
+    QMutexLocker locker(&warmMutex);
+    qDeleteAll(warmQueue);
+    warmQueue.clear();
+    cancelRunning(NULL);
+    warmDone.clear();
+}
+
+// the stubs the workers finished since the last call, needs to run on the thread owning the GL context
+void uploadWarmTracks()
+{
+    warmMutex.lock();
+    QList<trackHandler*> done = warmDone;
+    warmDone.clear();
+    warmMutex.unlock();
+    if(done.isEmpty()) return;
+
+    glView->makeCurrent();
+    for(int i = 0; i < done.size(); ++i)
+    {
+        finishStub(done[i]);
+    }
+}
@@ -21,6 +21,8 @@
 
 #include "glviewwidget.h"
 
+#define COMPACT_IDLE 60000      // ms a track has to be unused before MainWindow::compactInactiveTracks() compacts it
+
 class QTreeWidgetItem;
 class trackWidget;
 class graphWidget;
@@ -46,6 +48,12 @@ public:
     undoHandler* mUndoHandler;
     QColor trackColors[3];
 
+    bool isStub;        // loaded without nodes and mesh, not drawn until warmTracks() or claimTrack() finished it
+    bool isStale;       // drawn with its old mesh while a worker builds warmMesh with the new settings
+    bool staleNodes;    // the nodes are out of date as well, not only the mesh
+    trackMesh* warmMesh;
+    QElapsedTimer lastUsed;     // restarted while the track is current or materialized
+
 private:
 
     int id;
@@ -54,4 +62,10 @@ private:
     //int j;
 };
 
+void recomputeTracks(const QList<trackHandler*> &_tracks, bool _integrate = true);
+void warmTracks(const QList<trackHandler*> &_tracks);
+bool claimTrack(trackHandler* _track);
+void stopWarming();
+void uploadWarmTracks();
+
 #endif // TRACKHANDLER_H
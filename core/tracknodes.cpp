@@ -0,0 +1,139 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// the parts of track the sections and the smoothing need, they do not touch the ui
+// so the core logic tests link them as they are
+
+#include "track.h"
+#include "smoothhandler.h"
+
+// a detached track without anchor, mesh or widgets, only holds the sections it is given
+track::track()
+{
+    anchorNode = NULL;
+    startPos = glm::vec3(0.f, 0.f, 0.f);
+    startYaw = 0.f;
+    startPitch = 0.f;
+    povPos = glm::vec2(0, 0);
+    mParent = NULL;
+    cold = false;
+    fHeart = 0.f;
+    fFriction = 0.03f;
+    fResistance = 2e-5;
+    hasChanged = false;
+    drawTrack = false;
+    drawHeartline = 0;
+    mOptions = NULL;
+    activeSection = NULL;
+    smoother = NULL;
+    smoothedUntil = 0;
+    style = generic;
+}
+
+track::~track()
+{
+    while(lSections.size() != 0)
+    {
+        delete lSections.at(0);
+        lSections.removeAt(0);
+    }
+    while(smoothList.size() != 0)
+    {
+        delete smoothList[0];
+        smoothList.removeFirst();
+    }
+    delete anchorNode;
+}
+
+mnode* track::getPoint(int index)
+{
+    int i = 0;
+    if(index < 0) index = 0;
+    while(lSections.size() > i && index > lSections.at(i)->lNodes.size()-1)
+    {
+        index -= lSections.at(i++)->lNodes.size()-1;
+    }
+    if(lSections.size() == i)
+    {
+		if(lSections.size())    return &lSections.last()->lNodes.last();
+        else return anchorNode;
+    }
+	return &lSections.at(i)->lNodes[index];
+}
+
+// getPoint() for reading, see section::readNode()
+mnode* track::readPoint(int index)
+{
+    int node, sec;
+    if(index < 0) index = 0;
+    getSecNode(index, &node, &sec);
+    if(sec < 0) return anchorNode;
+    return lSections[sec]->readNode(node);
+}
+
+int track::getNumPoints(section* until)
+{
+
+    int sum = 0;
+    for(int i = 0; i < lSections.size(); ++i)
+    {
+        if(lSections.at(i) == until) return sum;
+        sum += lSections.at(i)->lNodes.size()-1;
+    }
+    return sum;
+}
+
+int track::getSectionNumber(section *_section)
+{
+    int number = 0;
+    while(number < lSections.size() && lSections.at(number) != _section) ++number;
+    if(number < lSections.size())
+    {
+        return number;
+    }
+    else
+    {
+        return -1;
+    }
+}
+
+void track::getSecNode(int index, int *node, int *section)
+{
+    int i = 0;
+    while(lSections.size() > i && index > lSections.at(i)->lNodes.size()-1)
+    {
+        index -= lSections.at(i++)->lNodes.size()-1;
+    }
+    if(lSections.size() == i)
+    {
+        if(lSections.size())
+        {
+            *node = lSections.last()->lNodes.size()-1;
+            *section = lSections.size()-1;
+        }
+        else
+        {
+            *node = 0;
+            *section = -1;
+        }
+        return;
+    }
+    *node = index;
+    *section = i;
+    return;
+}
@@ -26,7 +26,7 @@
 # glm (tested with 0.9.5.1-1)
 # lib3ds
 
-CONFIG  += qt
+CONFIG  += qt c++17
 QT       += core gui widgets printsupport opengl openglwidgets
 
 #CONFIG += exceptions \
@@ -41,10 +41,14 @@ SOURCES += main.cpp\
     core/undoaction.cpp \
     core/trackhandler.cpp \
     core/track.cpp \
+    core/tracknodes.cpp \
     core/subfunction.cpp \
     core/smoothhandler.cpp \
     core/sectionhandler.cpp \
     core/section.cpp \
+    core/sectionkernel.cpp \
+    core/sectioncache.cpp \
+    core/sectionsweep.cpp \
     core/secstraight.cpp \
     core/secgeometric.cpp \
     core/secforced.cpp \
@@ -57,6 +61,7 @@ SOURCES += main.cpp\
     core/exportfuncs.cpp \
     osx/common.cpp \
     renderer/trackmesh.cpp \
+    renderer/meshsink.cpp \
     renderer/mytexture.cpp \
     renderer/myshader.cpp \
     renderer/myframebuffer.cpp \
@@ -64,6 +69,7 @@ SOURCES += main.cpp\
     ui/transitionwidget.cpp \
     ui/trackwidget.cpp \
     ui/trackproperties.cpp \
+    ui/sweepdialog.cpp \
     ui/smoothui.cpp \
     ui/qcustomplot.cpp \
     ui/projectwidget.cpp \
@@ -89,6 +95,9 @@ HEADERS  += core/logging.h \
     core/smoothhandler.h \
     core/sectionhandler.h \
     core/section.h \
+    core/sectionkernel.h \
+    core/sectioncache.h \
+    core/sectionsweep.h \
     core/secstraight.h \
     core/secgeometric.h \
     core/secforced.h \
@@ -101,6 +110,7 @@ HEADERS  += core/logging.h \
     core/exportfuncs.h \
     osx/common.h \
     renderer/trackmesh.h \
+    renderer/meshsink.h \
     renderer/mytexture.h \
     renderer/myshader.h \
     renderer/myframebuffer.h \
@@ -108,6 +118,7 @@ HEADERS  += core/logging.h \
     ui/transitionwidget.h \
     ui/trackwidget.h \
     ui/trackproperties.h \
+    ui/sweepdialog.h \
     ui/smoothui.h \
     ui/qcustomplot.h \
     ui/projectwidget.h \
@@ -128,6 +139,7 @@ HEADERS  += core/logging.h \
 FORMS    += ui/transitionwidget.ui \
     ui/trackwidget.ui \
     ui/trackproperties.ui \
+    ui/sweepdialog.ui \
     ui/smoothui.ui \
     ui/projectwidget.ui \
     ui/optionsmenu.ui \
@@ -223,6 +235,9 @@ OTHER_FILES += \
     shaders/floor.frag \
     shaders/debug.vert \
     shaders/debug.frag \
+    shaders/railExtrusion.vert \
+    shaders/railExtrusion.frag \
+    shaders/crosstieExpansion.vert \
     metalnormals.png \
     readme.txt \
     sky/negx.jpg \
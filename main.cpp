@@ -26,6 +26,9 @@
 #include "mainwindow.h"
 #include "lenassert.h"
 #include "core/logging.h"
+#include "core/sectionkernel.h"
+#include "core/trackhandler.h"
+#include "ui/projectwidget.h"
 #include "renderer/qtglcompat.h"
 
 #ifdef Q_OS_MAC
@@ -106,6 +109,16 @@ int main(int argc, char *argv[])
                                       QStringLiteral("level"));
     parser.addOption(logLevelOption);
 
+    QCommandLineOption benchmarkOption(QStringLiteral("benchmark"),
+                                       QStringLiteral("Time the section integration of the loaded project and log the cost per node"),
+                                       QStringLiteral("runs"));
+    parser.addOption(benchmarkOption);
+
+    QCommandLineOption validateRateOption(QStringLiteral("validate-rate"),
+                                          QStringLiteral("Integrate the loaded project at another sample rate and compare it with the project's own"),
+                                          QStringLiteral("hz"));
+    parser.addOption(validateRateOption);
+
     parser.addPositionalArgument(QStringLiteral("project"),
                                  QStringLiteral("Project file to load"),
                                  QStringLiteral("[project]"));
@@ -123,6 +136,43 @@ int main(int argc, char *argv[])
     if (projectFile.endsWith(QStringLiteral(".fvd"))) {
         qCInfo(Logging::logApp, "starting FVD++ with project %s", qPrintable(projectFile));
         w.loadProject(projectFile);
+
+        // the loaded tracks are stubs warmed in the background, both options need their nodes on this thread
+        const auto materializeTracks = [&w]() {
+            const QList<trackHandler*> tracks = w.getTrackList();
+            for (trackHandler* handler : tracks) {
+                handler->trackData->materializeTrack();
+            }
+        };
+        if (parser.isSet(benchmarkOption) || parser.isSet(validateRateOption)) {
+            materializeTracks();
+        }
+
+        if (parser.isSet(benchmarkOption)) {
+            const int runs = qMax(1, parser.value(benchmarkOption).toInt());
+            const QList<trackHandler*> tracks = w.getTrackList();
+            for (trackHandler* handler : tracks) {
+                benchmarkSections(handler->trackData, runs);
+            }
+        }
+
+        if (parser.isSet(validateRateOption)) {
+            const float projectRate = F_HZ;
+            const QList<trackHandler*> tracks = w.getTrackList();
+            QList<ridesummary_t> reference;
+            for (trackHandler* handler : tracks) {
+                reference.append(summarizeRide(handler->trackData));
+            }
+            w.project->setSampleRate(parser.value(validateRateOption).toFloat());
+            // only the open track is resampled right away, the others are stubs again
+            materializeTracks();
+            bool passed = true;
+            for (int i = 0; i < tracks.size(); ++i) {
+                passed = compareRides(tracks[i]->trackData->name, reference[i], summarizeRide(tracks[i]->trackData)) && passed;
+            }
+            qCInfo(Logging::logApp, "%g Hz against %g Hz: %s", F_HZ, projectRate, passed ? "within tolerance" : "out of tolerance");
+            w.project->setSampleRate(projectRate);
+        }
     }
 
 
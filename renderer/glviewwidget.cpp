@@ -20,12 +20,14 @@
 
 #include "mainwindow.h"
 #include <QMouseEvent>
+#include <QLabel>
 #include "optionsmenu.h"
 #include "graphwidget.h"
 #include "trackmesh.h"
 #include "myshader.h"
 #include "mytexture.h"
 #include "myframebuffer.h"
+#include "core/logging.h"
 
 #include "osx/common.h"
 #include <string>
@@ -69,6 +71,21 @@ glViewWidget::glViewWidget(QWidget *parent) : QtGLWidget(parent) {
 	preDistortionFb = NULL;
 	floorOpacity = 0.8;
     initialized = 0;
+	frameTime = 0.f;
+	frameTimeSum = 0.f;
+	frameCount = 0;
+	drawnChunks = 0;
+	culledChunks = 0;
+	frameUniforms = 0;
+	continuousMode = false;
+	gpuRails = false;
+	gpuCrossties = false;
+	hasChanged = true;
+
+	statsLabel = new QLabel(this);
+	statsLabel->setStyleSheet("QLabel { color: white; background-color: rgba(0, 0, 0, 128); padding: 4px; }");
+	statsLabel->move(8, 8);
+	statsLabel->hide();
 }
 
 glViewWidget::~glViewWidget()
@@ -80,6 +97,8 @@ glViewWidget::~glViewWidget()
 		delete trackShader;
 		delete simpleSMShader;
 		delete shadowVolumeShader;
+		delete railShader;
+		delete crosstieShader;
 
 		delete rasterTexture;
 		delete metalTexture;
@@ -103,18 +122,15 @@ void glViewWidget::drawFloor()
 {
 	floorShader->bind();
 
-	floorShader->useUniform("projectionMatrix", &ProjectionMatrix);
-	floorShader->useUniform("modelMatrix", &ModelMatrix);
-	floorShader->useUniform("eyePos", &cameraPos);
-	floorShader->useUniform("rasterTex", rasterTexture->getId());
-	floorShader->useUniform("floorTex", floorTexture->getId());
+	floorShader->useUniform(uniRasterTex, rasterTexture->getId());
+	floorShader->useUniform(uniFloorTex, floorTexture->getId());
 
-	if(shadowMode == 0) floorShader->useUniform("shadowTex", simpleShadowFb->getTexture());
-	else if(shadowMode > 0)  floorShader->useUniform("shadowTex", shadowVolumeFb->getTexture());
+	if(shadowMode == 0) floorShader->useUniform(uniShadowTex, simpleShadowFb->getTexture());
+	else if(shadowMode > 0)  floorShader->useUniform(uniShadowTex, shadowVolumeFb->getTexture());
 
-	floorShader->useUniform("border", (GLuint)drawBorder);
-	floorShader->useUniform("grid", (GLuint) gloParent->mOptions->drawGrid);
-	floorShader->useUniform("opacity", floorOpacity);
+	floorShader->useUniform(uniBorder, (GLuint)drawBorder);
+	floorShader->useUniform(uniGrid, (GLuint) gloParent->mOptions->drawGrid);
+	floorShader->useUniform(uniOpacity, floorOpacity);
 	glBindVertexArray(floorMesh.object);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 31);
 }
@@ -140,11 +156,11 @@ void glViewWidget::drawSky()
 	bottomRight /= bottomRight.w;
 	bottomRight = -glm::vec4(glm::normalize(glm::vec3(bottomRight)-cameraPos) ,0);
 
-	skyShader->useUniform("TL", topLeft.x, topLeft.y, topLeft.z);
-	skyShader->useUniform("TR", topRight.x, topRight.y, topRight.z);
-	skyShader->useUniform("BL", bottomLeft.x, bottomLeft.y, bottomLeft.z);
-	skyShader->useUniform("BR", bottomRight.x, bottomRight.y, bottomRight.z);
-	skyShader->useUniform("skyTex", skyTexture->getId());
+	skyShader->useUniform(uniTL, topLeft.x, topLeft.y, topLeft.z);
+	skyShader->useUniform(uniTR, topRight.x, topRight.y, topRight.z);
+	skyShader->useUniform(uniBL, bottomLeft.x, bottomLeft.y, bottomLeft.z);
+	skyShader->useUniform(uniBR, bottomRight.x, bottomRight.y, bottomRight.z);
+	skyShader->useUniform(uniSkyTex, skyTexture->getId());
 	glBindVertexArray(skyMesh.object);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
@@ -173,75 +189,51 @@ void glViewWidget::drawTrack(trackHandler *_track, bool toNormalMap)
 	glm::mat4 anchorBase = glm::translate(myTrack->startPos) * glm::rotate(TO_RAD(myTrack->startYaw-90.f), glm::vec3(0.f, 1.f, 0.f));
 
 	shader->bind();
-	shader->useUniform("projectionMatrix", &ProjectionMatrix);
-	shader->useUniform("modelMatrix", &ModelMatrix);
-	shader->useUniform("anchorBase", &anchorBase);
-	shader->useUniform("eyePos", &cameraPos);
-	shader->useUniform("colorMode", (GLuint)curTrackShader);
+	shader->useUniform(uniAnchorBase, &anchorBase);
+	shader->useUniform(uniColorMode, (GLuint)curTrackShader);
+	shader->useUniform(uniSelection, &mesh->selection);
+	shader->useUniform(uniMetricTex, mesh->metricTexture->getId());
+	shader->useUniform(uniMetricStep, (GLuint)mesh->metricStep);
 
-	shader->useUniform("metalTex", metalTexture->getId());
-	shader->useUniform("skyTex", skyTexture->getId());
-	shader->useUniform("occlusionTex", occlusionFb->getTexture());
+	shader->useUniform(uniMetalTex, metalTexture->getId());
+	shader->useUniform(uniSkyTex, skyTexture->getId());
+	shader->useUniform(uniOcclusionTex, occlusionFb->getTexture());
 
-	if(shadowMode == 0) shader->useUniform("shadowTex", simpleShadowFb->getTexture());
-	else if(shadowMode > 0)  shader->useUniform("shadowTex", shadowVolumeFb->getTexture());
+	if(shadowMode == 0) shader->useUniform(uniShadowTex, simpleShadowFb->getTexture());
+	else if(shadowMode > 0)  shader->useUniform(uniShadowTex, shadowVolumeFb->getTexture());
 
 	QColor* tempColor = _track->trackColors;
-	shader->useUniform("defaultColor", tempColor[0].red()/255.f, tempColor[0].green()/255.f, tempColor[0].blue()/255.f);
-	shader->useUniform("sectionColor", tempColor[1].red()/255.f, tempColor[1].green()/255.f, tempColor[1].blue()/255.f);
-	shader->useUniform("transitionColor", tempColor[2].red()/255.f, tempColor[2].green()/255.f, tempColor[2].blue()/255.f);
-
-	shader->useUniform("lightDir", &lightDir);
+	shader->useUniform(uniDefaultColor, tempColor[0].red()/255.f, tempColor[0].green()/255.f, tempColor[0].blue()/255.f);
+	shader->useUniform(uniSectionColor, tempColor[1].red()/255.f, tempColor[1].green()/255.f, tempColor[1].blue()/255.f);
+	shader->useUniform(uniTransitionColor, tempColor[2].red()/255.f, tempColor[2].green()/255.f, tempColor[2].blue()/255.f);
 
 	if(myTrack->drawHeartline != 2 && myTrack->lSections.size()!=0)
 	{
 		glBindVertexArray(mesh->TrackObject[0]);
-		for(int i = 0; i < mesh->pipeBorders.size()-1; ++i)
-		{
-			//glDrawArrays(GL_TRIANGLE_STRIP, i*mesh->trackVertexSize, mesh->trackVertexSize);
-			if(mesh->isWireframe)
-			{
-				glDrawElements(GL_LINE_STRIP, mesh->pipeBorders[i+1]-mesh->pipeBorders[i], GL_UNSIGNED_INT, (GLvoid*)(sizeof(GLuint)*mesh->pipeBorders[i]));
-			}
-			else
-			{
-				glDrawElements(GL_TRIANGLE_STRIP, mesh->pipeBorders[i+1]-mesh->pipeBorders[i], GL_UNSIGNED_INT, (GLvoid*)(sizeof(GLuint)*mesh->pipeBorders[i]));
-			}
-			//glDrawArrays(GL_POINTS, i*mesh->trackVertexSize, mesh->trackVertexSize);
-		}
+		glMultiDrawElements(mesh->isWireframe ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, mesh->drawCounts.data(), GL_UNSIGNED_INT, (const GLvoid**)mesh->drawOffsets.data(), mesh->drawCounts.size());
 		glBindVertexArray(mesh->TrackObject[3]);
-		if(mesh->isWireframe)
-		{
-			glDrawArrays(GL_LINES, 0, mesh->crossties.size());
-		}
-		else
-		{
-			glDrawArrays(GL_TRIANGLES, 0, mesh->crossties.size());
-		}
+		glMultiDrawArrays(mesh->isWireframe ? GL_LINES : GL_TRIANGLES, mesh->crosstieFirsts.data(), mesh->crosstieCounts.data(), mesh->crosstieCounts.size());
 		//glDrawArrays(GL_POINTS, 0, mesh->crossties.size());
 
 
 		glBindVertexArray(mesh->TrackObject[4]);
 		if(mesh->isWireframe)
 		{
-			shader->useUniform("defaultColor", 0.6f, 0.2f, 0.2f);
-			glDrawArrays(GL_LINES, 0, mesh->rendersupports.size());
+			shader->useUniform(uniDefaultColor, 0.6f, 0.2f, 0.2f);
+			glDrawArrays(GL_LINES, 0, mesh->supportVertexCount);
 		}
 		else
 		{
-			shader->useUniform("defaultColor", 0.6f, 0.6f, 0.6f);
-			for(int i = 0; i < mesh->supportsSize; ++i)
-			{
-				glDrawArrays(GL_TRIANGLE_STRIP, i*61, 61);
-			}
-			//glDrawArrays(GL_POINTS, i*61, 61);
+			shader->useUniform(uniDefaultColor, 0.6f, 0.6f, 0.6f);
+			glMultiDrawArrays(GL_TRIANGLE_STRIP, mesh->supportFirsts.data(), mesh->supportCounts.data(), mesh->supportCounts.size());
 		}
 	}
 
-	shader->useUniform("defaultColor", 0.9f, 0.9f, 0.4f);
+	shader->useUniform(uniDefaultColor, 0.9f, 0.9f, 0.4f);
 	if(myTrack->drawHeartline != 1)
 	{
 		glBindVertexArray(mesh->HeartObject[0]);
+		glVertexAttribI4i(6, -1, 0, 0, 0); // the heartline has no node attribute, keep it out of the selection
 		glDrawArrays(GL_LINE_STRIP, 0, mesh->heartline.size());
 	}
 
@@ -267,48 +259,24 @@ void glViewWidget::drawSimpleSM(trackHandler *_track)
 	}
 
 	simpleSMShader->bind();
-	simpleSMShader->useUniform("projectionMatrix", &ProjectionMatrix);
-	simpleSMShader->useUniform("modelMatrix", &ModelMatrix);
-	simpleSMShader->useUniform("anchorBase", &anchorBase);
-
-	simpleSMShader->useUniform("lightDir", &lightDir);
+	simpleSMShader->useUniform(uniAnchorBase, &anchorBase);
 
 	if(myTrack->drawHeartline != 2)
 	{
 		glBindVertexArray(mesh->TrackObject[0]);
-		for(int i = 0; i < mesh->pipeBorders.size()-1; ++i)
-		{
-			if(mesh->isWireframe)
-			{
-				glDrawElements(GL_LINE_STRIP, mesh->pipeBorders[i+1]-mesh->pipeBorders[i], GL_UNSIGNED_INT, (GLvoid*)(sizeof(GLuint)*mesh->pipeBorders[i]));
-			}
-			else
-			{
-				glDrawElements(GL_TRIANGLE_STRIP, mesh->pipeBorders[i+1]-mesh->pipeBorders[i], GL_UNSIGNED_INT, (GLvoid*)(sizeof(GLuint)*mesh->pipeBorders[i]));
-			}
-		}
+		glMultiDrawElements(mesh->isWireframe ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, mesh->drawCounts.data(), GL_UNSIGNED_INT, (const GLvoid**)mesh->drawOffsets.data(), mesh->drawCounts.size());
 		glBindVertexArray(mesh->TrackObject[3]);
-		if(mesh->isWireframe)
-		{
-			glDrawArrays(GL_LINES, 0, mesh->crossties.size());
-		}
-		else
-		{
-			glDrawArrays(GL_TRIANGLES, 0, mesh->crossties.size());
-		}
+		glMultiDrawArrays(mesh->isWireframe ? GL_LINES : GL_TRIANGLES, mesh->crosstieFirsts.data(), mesh->crosstieCounts.data(), mesh->crosstieCounts.size());
 
 
 		glBindVertexArray(mesh->TrackObject[4]);
 		if(mesh->isWireframe)
 		{
-			glDrawArrays(GL_LINES, 0, mesh->rendersupports.size());
+			glDrawArrays(GL_LINES, 0, mesh->supportVertexCount);
 		}
 		else
 		{
-			for(int i = 0; i < mesh->supportsSize; ++i)
-			{
-				glDrawArrays(GL_TRIANGLE_STRIP, i*61, 61);
-			}
+			glMultiDrawArrays(GL_TRIANGLE_STRIP, mesh->supportFirsts.data(), mesh->supportCounts.data(), mesh->supportCounts.size());
 		}
 	}
 
@@ -336,10 +304,8 @@ void glViewWidget::drawShadowVolumes()
 	shadowVolumeShader->bind();
 	glm::mat4 anchorBase = glm::translate(glm::vec3(0, 0, 0));
 
-	shadowVolumeShader->useUniform("projectionMatrix", &ProjectionMatrix);
-	shadowVolumeShader->useUniform("modelMatrix", &ModelMatrix);
-	shadowVolumeShader->useUniform("anchorBase", &anchorBase);
-	shadowVolumeShader->useUniform("uFill", 0.f);
+	shadowVolumeShader->useUniform(uniAnchorBase, &anchorBase);
+	shadowVolumeShader->useUniform(uniFill, 0.f);
 
 	/* RENDER MESHES */
 
@@ -347,7 +313,7 @@ void glViewWidget::drawShadowVolumes()
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 31);
 	for(int i = 0; i < trackList.size(); ++i)
 	{
-		if(trackList[i]->trackData->drawTrack)
+		if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
 		{
             if(!trackList[i]->mMesh->isInit) {
                 trackList[i]->mMesh->init();
@@ -356,43 +322,23 @@ void glViewWidget::drawShadowVolumes()
 			trackMesh* mesh = trackList[i]->mMesh;
 			track* myTrack = trackList[i]->trackData;
 			anchorBase = glm::translate(myTrack->startPos) * glm::rotate(TO_RAD(myTrack->startYaw-90.f), glm::vec3(0.f, 1.f, 0.f));
-			shadowVolumeShader->useUniform("anchorBase", &anchorBase);
+			shadowVolumeShader->useUniform(uniAnchorBase, &anchorBase);
 			if(myTrack->drawHeartline != 2 && myTrack->lSections.size()!=0)
 			{
 				glBindVertexArray(mesh->TrackObject[0]);
-				for(int i = 0; i < mesh->pipeBorders.size()-1; ++i)
-				{
-					if(mesh->isWireframe)
-					{
-						glDrawElements(GL_LINE_STRIP, mesh->pipeBorders[i+1]-mesh->pipeBorders[i], GL_UNSIGNED_INT, (GLvoid*)(sizeof(GLuint)*mesh->pipeBorders[i]));
-					}
-					else
-					{
-						glDrawElements(GL_TRIANGLE_STRIP, mesh->pipeBorders[i+1]-mesh->pipeBorders[i], GL_UNSIGNED_INT, (GLvoid*)(sizeof(GLuint)*mesh->pipeBorders[i]));
-					}
-				}
+				glMultiDrawElements(mesh->isWireframe ? GL_LINE_STRIP : GL_TRIANGLE_STRIP, mesh->drawCounts.data(), GL_UNSIGNED_INT, (const GLvoid**)mesh->drawOffsets.data(), mesh->drawCounts.size());
 				glBindVertexArray(mesh->TrackObject[3]);
-				if(mesh->isWireframe)
-				{
-					glDrawArrays(GL_LINES, 0, mesh->crossties.size());
-				}
-				else
-				{
-					glDrawArrays(GL_TRIANGLES, 0, mesh->crossties.size());
-				}
+				glMultiDrawArrays(mesh->isWireframe ? GL_LINES : GL_TRIANGLES, mesh->crosstieFirsts.data(), mesh->crosstieCounts.data(), mesh->crosstieCounts.size());
 
 
 				glBindVertexArray(mesh->TrackObject[4]);
 				if(mesh->isWireframe)
 				{
-					glDrawArrays(GL_LINES, 0, mesh->rendersupports.size());
+					glDrawArrays(GL_LINES, 0, mesh->supportVertexCount);
 				}
 				else
 				{
-					for(int i = 0; i < mesh->supportsSize; ++i)
-					{
-						glDrawArrays(GL_TRIANGLE_STRIP, i*61, 61);
-					}
+					glMultiDrawArrays(GL_TRIANGLE_STRIP, mesh->supportFirsts.data(), mesh->supportCounts.data(), mesh->supportCounts.size());
 				}
 			}
 		}
@@ -409,18 +355,18 @@ void glViewWidget::drawShadowVolumes()
 
 	for(int i = 0; i < trackList.size(); ++i)
 	{
-		if(trackList[i]->trackData->drawTrack && trackList[i]->trackData->drawHeartline != 2 && trackList[i]->trackData->lSections.size()!=0)
+		if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub && trackList[i]->trackData->drawHeartline != 2 && trackList[i]->trackData->lSections.size()!=0)
 		{
 			trackMesh* mesh = trackList[i]->mMesh;
 			track* myTrack = trackList[i]->trackData;
 			anchorBase = glm::translate(myTrack->startPos) * glm::rotate(TO_RAD(myTrack->startYaw-90.f), glm::vec3(0.f, 1.f, 0.f));
-			shadowVolumeShader->useUniform("anchorBase", &anchorBase);
+			shadowVolumeShader->useUniform(uniAnchorBase, &anchorBase);
 			glBindVertexArray(mesh->HeartObject[1]);
 			glDrawElements(GL_TRIANGLES, mesh->shadowIndices.size(), GL_UNSIGNED_INT, (GLvoid*)0);
 			glBindVertexArray(mesh->HeartObject[3]);
-			glDrawArrays(GL_TRIANGLES, 0, mesh->supportshadows.size());
+			glDrawArrays(GL_TRIANGLES, 0, mesh->supportShadowCount);
 			glBindVertexArray(mesh->HeartObject[4]);
-			glDrawArrays(GL_TRIANGLES, 0, mesh->crosstieshadows.size());
+			glDrawArrays(GL_TRIANGLES, 0, mesh->crosstieShadowCount);
 		}
 	}
 
@@ -438,10 +384,8 @@ void glViewWidget::drawShadowVolumes()
 
 	anchorBase = glm::translate(glm::vec3(0, 0, 0));
 
-	shadowVolumeShader->useUniform("uFill", 1.f);
-	shadowVolumeShader->useUniform("projectionMatrix", &anchorBase);
-	shadowVolumeShader->useUniform("modelMatrix", &anchorBase);
-	shadowVolumeShader->useUniform("anchorBase", &anchorBase);
+	shadowVolumeShader->useUniform(uniFill, 1.f);
+	shadowVolumeShader->useUniform(uniAnchorBase, &anchorBase);
 	glBindVertexArray(skyMesh.object);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
@@ -456,7 +400,7 @@ void glViewWidget::drawOcclusion()
 	QList<trackHandler*> trackList = gloParent->getTrackList();
 	for(int i = 0; i < trackList.size(); ++i)
 	{
-		if(trackList[i]->trackData->drawTrack)
+		if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
         {
             if(!trackList[i]->mMesh->isInit) {
                 trackList[i]->mMesh->init();
@@ -464,8 +408,9 @@ void glViewWidget::drawOcclusion()
 
             if(trackList[i]->trackData->hasChanged)
 			{
-				trackList[i]->mMesh->recolorTrack();
+				trackList[i]->mMesh->updateSelection();
 				trackList[i]->trackData->hasChanged = false;
+				cameraPathDirty = true;
 			}
 			if(!trackList[i]->mMesh->isWireframe) drawTrack(trackList[i], true);
 		}
@@ -494,14 +439,14 @@ void glViewWidget::drawOcclusion()
 	bottomRight /= bottomRight.w;
 	bottomRight = -glm::vec4(glm::normalize(glm::vec3(bottomRight)-cameraPos) ,0);
 
-	occlusionShader->useUniform("TL", topLeft.x, topLeft.y, topLeft.z);
-	occlusionShader->useUniform("TR", topRight.x, topRight.y, topRight.z);
-	occlusionShader->useUniform("BL", bottomLeft.x, bottomLeft.y, bottomLeft.z);
-	occlusionShader->useUniform("BR", bottomRight.x, bottomRight.y, bottomRight.z);
-	occlusionShader->useUniform("eyePos", &cameraPos);
-	occlusionShader->useUniform("tex", normalMapFb->getTexture());
-	occlusionShader->useUniform("width", 1.f/viewPortWidth);
-	occlusionShader->useUniform("height", 1.f/viewPortHeight);
+	occlusionShader->useUniform(uniTL, topLeft.x, topLeft.y, topLeft.z);
+	occlusionShader->useUniform(uniTR, topRight.x, topRight.y, topRight.z);
+	occlusionShader->useUniform(uniBL, bottomLeft.x, bottomLeft.y, bottomLeft.z);
+	occlusionShader->useUniform(uniBR, bottomRight.x, bottomRight.y, bottomRight.z);
+	occlusionShader->useUniform(uniEyePos, &cameraPos);
+	occlusionShader->useUniform(uniTex, normalMapFb->getTexture());
+	occlusionShader->useUniform(uniWidth, 1.f/viewPortWidth);
+	occlusionShader->useUniform(uniHeight, 1.f/viewPortHeight);
 	glBindVertexArray(skyMesh.object);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
@@ -513,7 +458,7 @@ void glViewWidget::drawDebug()
 {
 	glDisable(GL_DEPTH_TEST);
 	debugShader->bind();
-	debugShader->useUniform("tex", preDistortionFb->getTexture());
+	debugShader->useUniform(uniTex, preDistortionFb->getTexture());
 	glBindVertexArray(skyMesh.object);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	glEnable(GL_DEPTH_TEST);
@@ -523,11 +468,11 @@ void glViewWidget::drawOculus()
 {
 	glDisable(GL_DEPTH_TEST);
 	oculusShader->bind();
-	oculusShader->useUniform("tex", preDistortionFb->getTexture());
-	oculusShader->useUniform("hmdWarp", &HmdWarp);
+	oculusShader->useUniform(uniTex, preDistortionFb->getTexture());
+	oculusShader->useUniform(uniHmdWarp, &HmdWarp);
 	float lensCenter = 0.5f-1.f*lensSep/hScreenSize;
-	oculusShader->useUniform("lensCenter", lensCenter);
-	oculusShader->useUniform("scale", OCULUS_SCALE);
+	oculusShader->useUniform(uniLensCenter, lensCenter);
+	oculusShader->useUniform(uniScale, OCULUS_SCALE);
 	glBindVertexArray(skyMesh.object);
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 	glEnable(GL_DEPTH_TEST);
@@ -536,7 +481,6 @@ void glViewWidget::drawOculus()
 void glViewWidget::paintGL()
 {
 	if(initialized != 2) return;
-	if(gloParent->mGraphWidget) gloParent->mGraphWidget->setBezPoints();
 	if(!paintMode) return;
 
 	fov = gloParent->mOptions->fov;
@@ -545,17 +489,9 @@ void glViewWidget::paintGL()
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
 
 	renderTime = frameTimer.nsecsElapsed()/1000000000.f;
+	if(renderTime > 0.1f) renderTime = 0.1f;    // first frame after idling
 	frameTimer.start();
 
-	/*	static float avgTime = 0.f;
-	static int frames = 0;
-	frames++;
-	avgTime+=renderTime;
-	if(frames%60 == 0) {
-		qDebug("%4.1f fps", 60.f/avgTime);
-		avgTime = 0.f;
-	}*/
-
 	if(!legacyMode)
 	{
 		moveCamera();
@@ -568,7 +504,7 @@ void glViewWidget::paintGL()
 			occlusionFb->clear();
 			normalMapFb->clear();
 
-			//if(moveMode) updateLoD();
+			updateChunks();
 
 			if(shadowMode > 0)
 			{
@@ -580,12 +516,13 @@ void glViewWidget::paintGL()
 			QList<trackHandler*> trackList = gloParent->getTrackList();
 			for(int i = 0; i < trackList.size(); ++i)
 			{
-				if(trackList[i]->trackData->drawTrack)
+				if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
 				{
 					if(trackList[i]->trackData->hasChanged)
 					{
-						trackList[i]->mMesh->recolorTrack();
+						trackList[i]->mMesh->updateSelection();
 						trackList[i]->trackData->hasChanged = false;
+						cameraPathDirty = true;
 					}
 					if(shadowMode == 0 || trackList[i]->mMesh->isWireframe || trackList[i]->trackData->drawHeartline == 2)
 					{
@@ -596,7 +533,7 @@ void glViewWidget::paintGL()
 
 			for(int i = 0; i < trackList.size(); ++i)
 			{
-				if(trackList[i]->trackData->drawTrack)
+				if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
 				{
 					drawTrack(trackList[i]);
 				}
@@ -617,7 +554,7 @@ void glViewWidget::paintGL()
 				occlusionFb->clear();
 				normalMapFb->clear();
 
-				//if(moveMode) updateLoD();
+				updateChunks();
 
 				if(shadowMode > 0)
 				{
@@ -629,12 +566,13 @@ void glViewWidget::paintGL()
 				QList<trackHandler*> trackList = gloParent->getTrackList();
 				for(int i = 0; i < trackList.size(); ++i)
 				{
-					if(trackList[i]->trackData->drawTrack)
+					if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
 					{
 						if(trackList[i]->trackData->hasChanged)
 						{
-							trackList[i]->mMesh->recolorTrack();
+							trackList[i]->mMesh->updateSelection();
 							trackList[i]->trackData->hasChanged = false;
+							cameraPathDirty = true;
 						}
 						if(shadowMode == 0 || trackList[i]->mMesh->isWireframe || trackList[i]->trackData->drawHeartline == 2)
 						{
@@ -648,7 +586,7 @@ void glViewWidget::paintGL()
 				preDistortionFb->bind();
 				for(int i = 0; i < trackList.size(); ++i)
 				{
-					if(trackList[i]->trackData->drawTrack)
+					if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
 					{
 						drawTrack(trackList[i]);
 					}
@@ -688,12 +626,152 @@ void glViewWidget::paintGL()
 		QList<trackHandler*> trackList = gloParent->getTrackList();
 		for(int i = 0; i < trackList.size(); ++i)
 		{
-			if(trackList[i]->trackData->drawTrack)
+			if(trackList[i]->trackData->drawTrack && !trackList[i]->isStub)
 			{
 				legacyDrawTrack(trackList[i]);
 			}
 		}
 	}
+
+	frameTimeSum += frameTimer.nsecsElapsed()/1000000.f;
+	if(++frameCount == 60) {
+		frameTime = frameTimeSum/frameCount;
+		qCDebug(Logging::logRenderer, "%5.2f ms per frame", frameTime);
+		if(statsLabel->isVisible()) {
+			statsLabel->setText(QString("%1 ms per frame\n%2 chunks drawn\n%3 chunks culled").arg(frameTime, 0, 'f', 2).arg(drawnChunks).arg(culledChunks));
+			statsLabel->adjustSize();
+		}
+		frameTimeSum = 0.f;
+		frameCount = 0;
+	}
+}
+
+void glViewWidget::checkRedraw()
+{
+	if(initialized != 2) return;
+
+	bool redraw = hasChanged || continuousMode || moveMode;
+	if(fov != gloParent->mOptions->fov || shadowMode != gloParent->mOptions->shadowQuality || clearColor != gloParent->mOptions->backgroundColor)
+	{
+		redraw = true;
+	}
+	QList<trackHandler*> trackList = gloParent->getTrackList();
+	for(int i = 0; !redraw && i < trackList.size(); ++i)
+	{
+		redraw = trackList[i]->trackData->drawTrack && !trackList[i]->isStub && trackList[i]->trackData->hasChanged;
+	}
+	if(!redraw) return;
+
+	hasChanged = false;
+	if(povMode) gloParent->showCurInfoPanel();
+	update();
+}
+
+void glViewWidget::setContinuousMode(bool _continuous)
+{
+	continuousMode = _continuous;
+	hasChanged = true;
+}
+
+void glViewWidget::setGpuRails(bool _gpuRails)
+{
+	gpuRails = _gpuRails;
+	if(gloParent->project == NULL) return;
+	// only the open track is rebuilt right away, the others are warmed with the new setting
+	recomputeTracks(gloParent->getTrackList(), false);
+	hasChanged = true;
+}
+
+void glViewWidget::extrudeRails(trackMesh* _mesh)
+{
+	int numPipes = _mesh->options.size();
+	if(numPipes == 0 || _mesh->railFrames.isEmpty()) return;
+	int numFrames = _mesh->railFrames.size()/numPipes;
+
+	// every mesh node expands into one ring per pipe, the result lands in the same layout createRings() builds
+	railShader->bind();
+	railShader->useUniform(uniFrameTex, _mesh->frameTexture->getId());
+	railShader->useUniform(uniNumPipes, (GLuint)numPipes);
+	railShader->useUniform(uniNumFrames, (GLuint)numFrames);
+
+	glBindVertexArray(_mesh->TrackObject[1]);
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _mesh->TrackBuffer[0]);
+	glBeginTransformFeedback(GL_POINTS);
+
+	railShader->useUniform(uniCapMode, (GLuint)0);
+	glDrawArrays(GL_POINTS, 0, numPipes);
+	railShader->useUniform(uniCapMode, (GLuint)1);
+	glDrawArraysInstanced(GL_POINTS, 0, _mesh->ringTemplate.size(), numFrames);
+	railShader->useUniform(uniCapMode, (GLuint)2);
+	glDrawArrays(GL_POINTS, 0, numPipes);
+
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(0);
+}
+
+void glViewWidget::setGpuCrossties(bool _gpuCrossties)
+{
+	gpuCrossties = _gpuCrossties;
+	if(gloParent->project == NULL) return;
+	recomputeTracks(gloParent->getTrackList(), false);
+	hasChanged = true;
+}
+
+void glViewWidget::expandCrossties(trackMesh* _mesh)
+{
+	int numTies = _mesh->tieFrames.size();
+	if(numTies == 0 || _mesh->tieBlockOffsets.size() < 2) return;
+	int period = _mesh->tieBlockOffsets.size()-1;
+	int first = _mesh->tieBlockOffsets.first();
+	int blockSize = _mesh->tieBlockOffsets.last()-first;
+	int numBlocks = (numTies-1)/period;
+	int rest = (numTies-1)%period;
+
+	// the first tie, then one instance per full block of ties and the remaining ties of the last block
+	crosstieShader->bind();
+	crosstieShader->useUniform(uniTieTex, _mesh->tieTexture->getId());
+	crosstieShader->useUniform(uniTiePeriod, (GLuint)period);
+
+	glBindVertexArray(_mesh->TrackObject[2]);
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, _mesh->TrackBuffer[3]);
+	glBeginTransformFeedback(GL_POINTS);
+
+	crosstieShader->useUniform(uniFirstTie, (GLuint)0);
+	glDrawArrays(GL_POINTS, 0, first);
+	crosstieShader->useUniform(uniFirstTie, (GLuint)1);
+	if(numBlocks) glDrawArraysInstanced(GL_POINTS, first, blockSize, numBlocks);
+	crosstieShader->useUniform(uniFirstTie, (GLuint)(1+numBlocks*period));
+	if(rest) glDrawArrays(GL_POINTS, first, _mesh->tieBlockOffsets[rest]-first);
+
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glDisable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(0);
+}
+
+bool glViewWidget::eventFilter(QObject *obj, QEvent *event)
+{
+	// input on the view itself moves the camera, edits elsewhere mark their track or the view
+	switch(event->type()) {
+	case QEvent::MouseButtonPress:
+	case QEvent::MouseButtonRelease:
+	case QEvent::MouseButtonDblClick:
+	case QEvent::KeyPress:
+	case QEvent::KeyRelease:
+	case QEvent::Wheel:
+		hasChanged = true;
+		break;
+	case QEvent::MouseMove:
+		if(((QMouseEvent*)event)->buttons() != Qt::NoButton) hasChanged = true;
+		break;
+	default:
+		break;
+	}
+	return QtGLWidget::eventFilter(obj, event);
 }
 
 QString glViewWidget::getGLVersionString()
@@ -716,6 +794,7 @@ bool glViewWidget::loadGroundTexture(QString fileName)
 	{
 		floorTexture = new myTexture(img, 2);
 	}
+	hasChanged = true;
 	return true;
 }
 
@@ -743,8 +822,12 @@ void glViewWidget::initializeGL()
 	moveMode = false;
 	povMode = false;
 	povPos = 0;
+	povTime = 0.;
 	cameraJump = 0;
 	povNode = NULL;
+	cameraPathTrack = NULL;
+	cameraPathDirty = true;
+	cursorPos = -1;
 	paintMode = true;
 	riftMode = false;
 
@@ -967,6 +1050,7 @@ void glViewWidget::keyPressEvent(QKeyEvent *event)
 		if(!gloParent->curTrack()->lSections.size())
 			povMode = true;
 		povMode = !povMode;
+		cursorPos = -1;
 		if(!povMode) gloParent->mGraphWidget->drawGraph(10); // 10 = povPos
 		break;
 	default:
@@ -1017,6 +1101,9 @@ void glViewWidget::keyReleaseEvent(QKeyEvent *event)
 	case Qt::Key_B:
 		drawBorder = 1-drawBorder;
 		break;
+	case Qt::Key_I:
+		statsLabel->setVisible(!statsLabel->isVisible());
+		break;
 	case Qt::Key_Left:
 		if(povMode)
 		{
@@ -1180,6 +1267,12 @@ void glViewWidget::initTextures()
 
 void glViewWidget::initShaders()
 {
+	glGenBuffers(1, &frameUniforms);
+	glBindBuffer(GL_UNIFORM_BUFFER, frameUniforms);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(frameuniforms_t), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_UNIFORMS, frameUniforms);
+
 #ifdef Q_OS_LINUX
 	floorShader = new myShader(":/shaders/floor.vert", ":/shaders/floor.frag");
 #endif
@@ -1192,6 +1285,7 @@ void glViewWidget::initShaders()
 	floorShader->useAttribute(0, "aPosition");
 	floorShader->useAttribute(1, "aNormal");
 	floorShader->linkProgram();
+	floorShader->useUniformBlock("frameUniforms", FRAME_UNIFORMS);
 
 #ifdef Q_OS_LINUX
 	skyShader = new myShader(":/shaders/sky.vert", ":/shaders/sky.frag");
@@ -1215,15 +1309,11 @@ void glViewWidget::initShaders()
 	trackShader = new myShader(":/shaders/track.vert", ":/shaders/track.frag");
 #endif
 	trackShader->useAttribute(0, "aPosition");
-	trackShader->useAttribute(1, "aVel");
-	trackShader->useAttribute(2, "aRoll");
-	trackShader->useAttribute(3, "aNForce");
-	trackShader->useAttribute(4, "aLForce");
-	trackShader->useAttribute(5, "aFlex");
-	trackShader->useAttribute(6, "aselected");
+	trackShader->useAttribute(6, "aNode");
 	trackShader->useAttribute(7, "aNormal");
 	trackShader->useAttribute(8, "aUv");
 	trackShader->linkProgram();
+	trackShader->useUniformBlock("frameUniforms", FRAME_UNIFORMS);
 
 	simpleShadowFb = new myFramebuffer(viewPortWidth, viewPortHeight, GL_RED, GL_RED);
 
@@ -1239,6 +1329,7 @@ void glViewWidget::initShaders()
 	simpleSMShader->useAttribute(0, "aPosition");
 	simpleSMShader->setOutput(0, "visibility");
 	simpleSMShader->linkProgram();
+	simpleSMShader->useUniformBlock("frameUniforms", FRAME_UNIFORMS);
 
 	shadowVolumeFb = new myFramebuffer(viewPortWidth, viewPortHeight, GL_RED, GL_RED, true);
 	shadowVolumeFb->setClearColor(0, 0, 0);
@@ -1255,6 +1346,7 @@ void glViewWidget::initShaders()
 	shadowVolumeShader->useAttribute(0, "aPosition");
 	shadowVolumeShader->setOutput(0, "visibility");
 	shadowVolumeShader->linkProgram();
+	shadowVolumeShader->useUniformBlock("frameUniforms", FRAME_UNIFORMS);
 
 	normalMapFb = new myFramebuffer(viewPortWidth, viewPortHeight, GL_RGBA16F, GL_RGBA, true);
 	normalMapFb->setClearColor(0, 0, 0);
@@ -1272,6 +1364,7 @@ void glViewWidget::initShaders()
 	normalMapShader->useAttribute(7, "aNormal");
 	normalMapShader->setOutput(0, "normal");
 	normalMapShader->linkProgram();
+	normalMapShader->useUniformBlock("frameUniforms", FRAME_UNIFORMS);
 
 	occlusionFb = new myFramebuffer(viewPortWidth, viewPortHeight, GL_RED, GL_RED);
 	occlusionFb->setClearColor(0, 0, 0);
@@ -1292,6 +1385,38 @@ void glViewWidget::initShaders()
 	occlusionShader->setOutput(0, "visibility");
 	occlusionShader->linkProgram();
 
+#ifdef Q_OS_LINUX
+	railShader = new myShader(":/shaders/railExtrusion.vert", ":/shaders/railExtrusion.frag");
+#endif
+#ifdef Q_OS_WIN32
+	railShader = new myShader(":/shaders/railExtrusion.vert", ":/shaders/railExtrusion.frag");
+#endif
+#ifdef Q_OS_MAC
+	railShader = new myShader(":/shaders/railExtrusion.vert", ":/shaders/railExtrusion.frag");
+#endif
+	const GLchar* railOutputs[4] = {"tfPos", "tfNormal", "tfUv", "tfNode"};
+	railShader->useAttribute(0, "aShape");
+	railShader->useAttribute(1, "aTemplate");
+	railShader->setFeedback(railOutputs, 4);
+	railShader->linkProgram();
+
+#ifdef Q_OS_LINUX
+	crosstieShader = new myShader(":/shaders/crosstieExpansion.vert", ":/shaders/railExtrusion.frag");
+#endif
+#ifdef Q_OS_WIN32
+	crosstieShader = new myShader(":/shaders/crosstieExpansion.vert", ":/shaders/railExtrusion.frag");
+#endif
+#ifdef Q_OS_MAC
+	crosstieShader = new myShader(":/shaders/crosstieExpansion.vert", ":/shaders/railExtrusion.frag");
+#endif
+	crosstieShader->useAttribute(0, "aCorner1");
+	crosstieShader->useAttribute(1, "aCorner2");
+	crosstieShader->useAttribute(2, "aCorner3");
+	crosstieShader->useAttribute(3, "aCorner4");
+	crosstieShader->useAttribute(4, "aInfo");
+	crosstieShader->setFeedback(railOutputs, 4);
+	crosstieShader->linkProgram();
+
 #ifdef Q_OS_LINUX
 	debugShader = new myShader(":/shaders/debug.vert", ":/shaders/debug.frag");
 #endif
@@ -1323,26 +1448,36 @@ void glViewWidget::moveCamera()
 {
 	if(povMode)
 	{
-		povPos += (int)(F_HZ*renderTime)*cameraBoost*(cameraMov.x - cameraMov.z);
 		if(gloParent->curTrack())
 		{
-			if(povPos < 0)
+			updateCameraPath();
+
+			double length = cameraPath.size()-1;
+			povTime += F_HZ*renderTime*cameraBoost*(cameraMov.x - cameraMov.z);
+			if(povTime < 0.)
 			{
-				povPos += gloParent->curTrack()->getNumPoints();
+				povTime += length;
 			}
-			if(povPos > gloParent->curTrack()->getNumPoints())
+			if(povTime < 0. || povTime > length)
 			{
-				povPos = 0;
+				povTime = 0.;
 			}
-			povNode = gloParent->curTrack()->getPoint(povPos);
-			if(povNode != NULL)
+
+			// the camera is placed between two nodes by the time the ride has taken
+			povPos = (int)povTime;
+			int nextPos = povPos < cameraPath.size()-1 ? povPos+1 : povPos;
+			float t = povTime - povPos;
+			povNode = gloParent->curTrack()->readPoint(povPos);
+			povCamera.pos = glm::mix(cameraPath[povPos].pos, cameraPath[nextPos].pos, t);
+			povCamera.orientation = glm::mix(cameraPath[povPos].orientation, cameraPath[nextPos].orientation, t);
+
+			bool moving = cameraMov.x != cameraMov.z;
+			if(povPos != cursorPos && (!moving || !cursorTimer.isValid() || cursorTimer.elapsed() >= CURSOR_INTERVAL))
 			{
+				cursorPos = povPos;
+				cursorTimer.start();
 				gloParent->mGraphWidget->drawGraph(10); // 10 = povPos
 			}
-			else    // should not be possible right now
-			{
-				povMode = false;
-			}
 		}
 		else
 		{
@@ -1386,6 +1521,56 @@ void glViewWidget::moveCamera()
 	cameraJump = 0;
 }
 
+void glViewWidget::updateCameraPath()
+{
+	track* curTrack = gloParent->curTrack();
+	// the camera moves before paintGL looks at the tracks, so an edit of this frame is caught here
+	if(curTrack->hasChanged)
+	{
+		cameraPathDirty = true;
+	}
+	if(!cameraPathDirty && cameraPathTrack == curTrack && cameraPathHeart == curTrack->fHeart && cameraPathOffset == curTrack->povPos && cameraPath.size() == curTrack->getNumPoints()+1)
+	{
+		return;
+	}
+	cameraPathDirty = false;
+	cameraPathTrack = curTrack;
+	cameraPathHeart = curTrack->fHeart;
+	cameraPathOffset = curTrack->povPos;
+
+	// only the keys are kept, the nodes may move whenever a section is integrated or detached
+	// the first node of a section is the last node of the section before
+	cameraPath.resize(0);
+	for(int i = 0; i < curTrack->lSections.size(); ++i)
+	{
+		section* curSection = curTrack->lSections[i];
+		for(int k = cameraPath.size() ? 1 : 0; k < curSection->lNodes.size(); ++k)
+		{
+			appendCameraKey(curTrack, curSection->readNode(k));
+		}
+	}
+	if(cameraPath.isEmpty())
+	{
+		appendCameraKey(curTrack, curTrack->anchorNode);
+	}
+}
+
+void glViewWidget::appendCameraKey(track* curTrack, mnode* curNode)
+{
+	camerakey_t key;
+	glm::vec3 front = curNode->vDirHeart(curTrack->fHeart);
+	glm::vec3 side = curNode->vLatHeart(curTrack->fHeart);
+	side = glm::normalize(side - front*glm::dot(front, side));
+	key.pos = curNode->vRelPos(curTrack->povPos.y, curTrack->povPos.x);
+	key.orientation = glm::quat_cast(glm::mat3(side, glm::cross(front, side), front));
+	// neighbouring keys in the same hemisphere, so mixing them takes the short way
+	if(cameraPath.size() && glm::dot(cameraPath.last().orientation, key.orientation) < 0.f)
+	{
+		key.orientation = -key.orientation;
+	}
+	cameraPath.append(key);
+}
+
 void glViewWidget::buildMatrices(float offset)
 {
 	float scew = 0;//offset*FNEAR/screenDist;
@@ -1409,10 +1594,10 @@ void glViewWidget::buildMatrices(float offset)
 	if(povMode)
 	{
 		anchorBase = glm::translate(gloParent->curTrack()->startPos) * glm::rotate(TO_RAD(gloParent->curTrack()->startYaw-90.f), glm::vec3(0.f, 1.f, 0.f));
-		glm::vec3 pos = povNode->vRelPos(gloParent->curTrack()->povPos.y, gloParent->curTrack()->povPos.x);
-		glm::vec3 direction = povNode->vDirHeart(gloParent->curTrack()->fHeart);
+		glm::vec3 pos = povCamera.pos;
+		glm::vec3 direction = povCamera.orientation * glm::vec3(0.f, 0.f, 1.f);
 		glm::vec3 front = direction;
-		glm::vec3 side = povNode->vLatHeart(gloParent->curTrack()->fHeart);
+		glm::vec3 side = povCamera.orientation * glm::vec3(1.f, 0.f, 0.f);
 		glm::vec3 down = glm::cross(front, side);
 		direction = glm::angleAxis((float)(-headPos.z), down) * glm::angleAxis((float)(headPos.y*180.f/F_PI), side) * direction;
 		side = glm::angleAxis((float)(-headPos.z), down) * side;
@@ -1421,7 +1606,7 @@ void glViewWidget::buildMatrices(float offset)
 
 		ModelMatrix = glm::lookAt(glm::vec3(anchorBase * glm::vec4(pos, 1.f)), glm::vec3(anchorBase * glm::vec4(pos+direction, 1.f)), -glm::vec3(anchorBase * glm::vec4(down, 0.f)));
 		cameraPos = glm::vec3(anchorBase * glm::vec4(pos, 1.f));
-		cameraDir = glm::vec3(anchorBase * glm::vec4(povNode->vDirHeart(gloParent->curTrack()->fHeart), 0.f));
+		cameraDir = glm::vec3(anchorBase * glm::vec4(front, 0.f));
 	}
 	else
 	{
@@ -1433,18 +1618,40 @@ void glViewWidget::buildMatrices(float offset)
 	}
 
 	ProjectionModelMatrix = ProjectionMatrix*ModelMatrix;
+
+	if(!legacyMode) updateFrameUniforms();
 }
 
-void glViewWidget::updateLoD()
+void glViewWidget::updateFrameUniforms()
 {
-	static int curTrack = 0;
-	QList<trackHandler*> trackList = gloParent->getTrackList();
-	if(trackList.isEmpty()) return;
-	if(curTrack >= trackList.size()) curTrack = 0;
+	if(!frameUniforms) return;
 
-	curTrack = (curTrack+1)%trackList.size();
-	trackList[curTrack]->mMesh->createIndices();
-	return;
+	frameuniforms_t temp;
+	temp.projectionMatrix = ProjectionMatrix;
+	temp.modelMatrix = ModelMatrix;
+	temp.eyePos = glm::vec4(cameraPos, 1.f);
+	temp.lightDir = glm::vec4(lightDir, 0.f);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, frameUniforms);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(frameuniforms_t), &temp);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void glViewWidget::updateChunks()
+{
+	// only picks the precomputed index ranges, indices are rebuilt with the mesh
+	drawnChunks = culledChunks = 0;
+	QList<trackHandler*> trackList = gloParent->getTrackList();
+	for(int i = 0; i < trackList.size(); ++i)
+	{
+		if(!trackList[i]->trackData->drawTrack || trackList[i]->isStub || !trackList[i]->mMesh->isInit) continue;
+		trackMesh* mesh = trackList[i]->mMesh;
+		track* myTrack = trackList[i]->trackData;
+		glm::mat4 anchorBase = glm::translate(myTrack->startPos) * glm::rotate(TO_RAD(myTrack->startYaw-90.f), glm::vec3(0.f, 1.f, 0.f));
+		mesh->updateChunks(anchorBase, ProjectionModelMatrix, cameraPos, lightDir);
+		drawnChunks += mesh->drawnChunks;
+		culledChunks += mesh->culledChunks;
+	}
 }
 
 void glViewWidget::legacyDrawFloor()
@@ -1519,10 +1726,10 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 		for(int j = 0; j < curSection->lNodes.size(); ++j)
 		{
 			float distFromLastNode = 1.f;
-			float angle = curSection->lNodes[j].fFlexion();
+			float angle = curSection->readNode(j)->fFlexion();
 			angle /= angleNodeDist;
 			angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-			angle *= curSection->lNodes[j].fDistFromLast;;
+			angle *= curSection->readNode(j)->fDistFromLast;;
 			distFromLastNode += angle;
 			if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
 			{
@@ -1535,12 +1742,12 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 					distFromLastNode = 0.f;
 				}
 
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart+fSpine), 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart+fSpine), 1.f);
 				glVertex3f(curPos.x, curPos.y, curPos.z);
 			}
 		}
 		int end = curSection->lNodes.size()-1;
-		curPos = anchorBase * glm::vec4(curSection->lNodes[end].vPosHeart(myTrack->fHeart+fSpine), 1.f);
+		curPos = anchorBase * glm::vec4(curSection->readNode(end)->vPosHeart(myTrack->fHeart+fSpine), 1.f);
 		glVertex3f(curPos.x, curPos.y, curPos.z);
 		glEnd();
 	}
@@ -1554,10 +1761,10 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 		for(int j = 0; j < curSection->lNodes.size(); ++j)
 		{
 			float distFromLastNode = 1.f;
-			float angle = curSection->lNodes[j].fFlexion();
+			float angle = curSection->readNode(j)->fFlexion();
 			angle /= angleNodeDist;
 			angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-			angle *= curSection->lNodes[j].fDistFromLast;;
+			angle *= curSection->readNode(j)->fDistFromLast;;
 			distFromLastNode += angle;
 			if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
 			{
@@ -1570,12 +1777,12 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 					distFromLastNode = 0.f;
 				}
 
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart+fSpine), 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart+fSpine), 1.f);
 				glVertex3f(curPos.x, 0.f, curPos.z);
 			}
 		}
 		int end = curSection->lNodes.size()-1;
-		curPos = anchorBase * glm::vec4(curSection->lNodes[end].vPosHeart(myTrack->fHeart+fSpine), 1.f);
+		curPos = anchorBase * glm::vec4(curSection->readNode(end)->vPosHeart(myTrack->fHeart+fSpine), 1.f);
 		glVertex3f(curPos.x, 0.f, curPos.z);
 		glEnd();
 	}
@@ -1597,10 +1804,10 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 		for(int j = 0; j < curSection->lNodes.size(); ++j)
 		{
 			float distFromLastNode = 1.f;
-			float angle = curSection->lNodes[j].fFlexion();
+			float angle = curSection->readNode(j)->fFlexion();
 			angle /= angleNodeDist;
 			angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-			angle *= curSection->lNodes[j].fDistFromLast;;
+			angle *= curSection->readNode(j)->fDistFromLast;;
 			distFromLastNode += angle;
 			if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
 			{
@@ -1613,12 +1820,12 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 					distFromLastNode = 0.f;
 				}
 
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart)+curSection->lNodes[j].vLatHeart(myTrack->fHeart)*0.5f, 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart)+curSection->readNode(j)->vLatHeart(myTrack->fHeart)*0.5f, 1.f);
 				glVertex3f(curPos.x, curPos.y, curPos.z);
 			}
 		}
 		int end = curSection->lNodes.size()-1;
-		curPos = anchorBase * glm::vec4(curSection->lNodes[end].vPosHeart(myTrack->fHeart)+curSection->lNodes[end].vLatHeart(myTrack->fHeart)*0.5f, 1.f);
+		curPos = anchorBase * glm::vec4(curSection->readNode(end)->vPosHeart(myTrack->fHeart)+curSection->readNode(end)->vLatHeart(myTrack->fHeart)*0.5f, 1.f);
 		glVertex3f(curPos.x, curPos.y, curPos.z);
 		glEnd();
 	}
@@ -1641,10 +1848,10 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 		for(int j = 0; j < curSection->lNodes.size(); ++j)
 		{
 			float distFromLastNode = 1.f;
-			float angle = curSection->lNodes[j].fFlexion();
+			float angle = curSection->readNode(j)->fFlexion();
 			angle /= angleNodeDist;
 			angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-			angle *= curSection->lNodes[j].fDistFromLast;;
+			angle *= curSection->readNode(j)->fDistFromLast;;
 			distFromLastNode += angle;
 			if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
 			{
@@ -1657,12 +1864,12 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 					distFromLastNode = 0.f;
 				}
 
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart)-curSection->lNodes[j].vLatHeart(myTrack->fHeart)*0.5f, 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart)-curSection->readNode(j)->vLatHeart(myTrack->fHeart)*0.5f, 1.f);
 				glVertex3f(curPos.x, curPos.y, curPos.z);
 			}
 		}
 		int end = curSection->lNodes.size()-1;
-		curPos = anchorBase * glm::vec4(curSection->lNodes[end].vPosHeart(myTrack->fHeart)-curSection->lNodes[end].vLatHeart(myTrack->fHeart)*0.5f, 1.f);
+		curPos = anchorBase * glm::vec4(curSection->readNode(end)->vPosHeart(myTrack->fHeart)-curSection->readNode(end)->vLatHeart(myTrack->fHeart)*0.5f, 1.f);
 		glVertex3f(curPos.x, curPos.y, curPos.z);
 		glEnd();
 	}
@@ -1683,16 +1890,16 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 		}
 		for(int j = 0; j < curSection->lNodes.size(); j++)
 		{
-			distFromLastX += curSection->lNodes[j].fDistFromLast;
+			distFromLastX += curSection->readNode(j)->fDistFromLast;
 			if(distFromLastX >= 1.0f)
 			{
 				distFromLastX -= 1.0f;
 				glBegin(GL_LINE_STRIP);
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart)-curSection->lNodes[j].vLatHeart(myTrack->fHeart)*0.5f, 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart)-curSection->readNode(j)->vLatHeart(myTrack->fHeart)*0.5f, 1.f);
 				glVertex3f(curPos.x, curPos.y, curPos.z);
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart+fSpine), 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart+fSpine), 1.f);
 				glVertex3f(curPos.x, curPos.y, curPos.z);
-				curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPosHeart(myTrack->fHeart)+curSection->lNodes[j].vLatHeart(myTrack->fHeart)*0.5f, 1.f);
+				curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPosHeart(myTrack->fHeart)+curSection->readNode(j)->vLatHeart(myTrack->fHeart)*0.5f, 1.f);
 				glVertex3f(curPos.x, curPos.y, curPos.z);
 				glEnd();
 			}
@@ -1716,10 +1923,10 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 			for(int j = 0; j < curSection->lNodes.size(); ++j)
 			{
 				float distFromLastNode = 1.f;
-				float angle = curSection->lNodes[j].fFlexion();
+				float angle = curSection->readNode(j)->fFlexion();
 				angle /= angleNodeDist;
 				angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-				angle *= curSection->lNodes[j].fDistFromLast;;
+				angle *= curSection->readNode(j)->fDistFromLast;;
 				distFromLastNode += angle;
 				if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
 				{
@@ -1732,12 +1939,12 @@ void glViewWidget::legacyDrawTrack(trackHandler *_track)
 						distFromLastNode = 0.f;
 					}
 
-					curPos = anchorBase * glm::vec4(curSection->lNodes[j].vPos, 1.f);
+					curPos = anchorBase * glm::vec4(curSection->readNode(j)->vPos, 1.f);
 					glVertex3f(curPos.x, curPos.y, curPos.z);
 				}
 			}
 			int end = curSection->lNodes.size()-1;
-			curPos = anchorBase * glm::vec4(curSection->lNodes[end].vPos, 1.f);
+			curPos = anchorBase * glm::vec4(curSection->readNode(end)->vPos, 1.f);
 			glVertex3f(curPos.x, curPos.y, curPos.z);
 			glEnd();
 		}
@@ -34,6 +34,7 @@
 #endif
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 #include <QtGlobal>
 #include <QElapsedTimer>
 #include "track.h"
@@ -47,7 +48,9 @@
 
 class myShader;
 class myTexture;
+class QLabel;
 class myFramebuffer;
+class trackMesh;
 
 typedef struct mesh_s
 {
@@ -55,6 +58,24 @@ typedef struct mesh_s
     GLuint buffer;
 } mesh_t;
 
+// std140 layout of the frameUniforms block in the shaders
+typedef struct frameuniforms_s
+{
+    glm::mat4 projectionMatrix;
+    glm::mat4 modelMatrix;
+    glm::vec4 eyePos;
+    glm::vec4 lightDir;
+} frameuniforms_t;
+
+// camera of the POV ride at one node, relative to the track's anchor
+typedef struct camerakey_s
+{
+    glm::vec3 pos;
+    glm::quat orientation;  // columns of its matrix are side, down and front
+} camerakey_t;
+
+#define CURSOR_INTERVAL 16  // ms between updates of the graph's POV cursor during a ride
+
 class MainWindow;
 
 class glViewWidget : public QtGLWidget
@@ -68,6 +89,12 @@ public:
     bool loadGroundTexture(QString fileName);
 
     void setBackgroundColor(QColor _background);
+    void setContinuousMode(bool _continuous);
+    void setGpuRails(bool _gpuRails);
+    void extrudeRails(trackMesh* _mesh);
+    void setGpuCrossties(bool _gpuCrossties);
+    void expandCrossties(trackMesh* _mesh);
+    bool eventFilter(QObject *obj, QEvent *event);
 
     int curTrackShader;
     bool povMode;
@@ -77,9 +104,14 @@ public:
     bool riftMode;
     bool moveMode;
     int povPos;
+    double povTime;     // ride position in nodes, povPos is the node the camera is at
     glm::vec4 cameraMov;
     double mSec;
-    bool hasChanged;
+    float frameTime;    // time spent in paintGL, average over the last 60 frames in ms
+    bool hasChanged;    // a new frame is needed
+    bool continuousMode;
+    bool gpuRails;      // build rail rings in a transform feedback pass instead of on the CPU
+    bool gpuCrossties;  // same for the crosstie geometry
     glm::vec3 cameraPos;
 
 protected:
@@ -94,14 +126,20 @@ protected:
 
 signals:
 
+public slots:
+    void checkRedraw();
+
 private:
 
     void initFloorMesh();
     void initTextures();
     void initShaders();
     void moveCamera();
+    void updateCameraPath();
+    void appendCameraKey(track* curTrack, mnode* curNode);
     void buildMatrices(float offset);
-    void updateLoD();
+    void updateFrameUniforms();
+    void updateChunks();
 
     void drawFloor();
     void drawSky();
@@ -135,11 +173,21 @@ private:
 
     int cameraJump;
     float cameraBoost;
+
+    QVector<camerakey_t> cameraPath;   // one key per track node, nodes are looked up by index
+    camerakey_t povCamera;
+    track* cameraPathTrack;
+    bool cameraPathDirty;
+    float cameraPathHeart;
+    glm::vec2 cameraPathOffset;
+    QElapsedTimer cursorTimer;
+    int cursorPos;
     QColor clearColor;
 
     glm::mat4x4 ProjectionModelMatrix;
     glm::mat4x4 ModelMatrix;
     glm::mat4x4 ProjectionMatrix;
+    GLuint frameUniforms;
 
     myTexture* floorTexture;
     myTexture* rasterTexture;
@@ -164,6 +212,8 @@ private:
     myShader* shadowVolumeShader;
     myShader* normalMapShader;
     myShader* occlusionShader;
+    myShader* railShader;
+    myShader* crosstieShader;
     myShader* oculusShader;
 
     myShader* debugShader;
@@ -172,6 +222,10 @@ private:
 
     QElapsedTimer frameTimer;
     float renderTime;
+    float frameTimeSum;
+    int frameCount;
+    int drawnChunks, culledChunks;
+    QLabel* statsLabel;     // toggled with I
     float lens;
     float fov;
 
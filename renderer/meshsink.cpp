@@ -0,0 +1,411 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "meshsink.h"
+
+#include <lib3ds.h>
+#include <math.h>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+
+lib3dsSink::lib3dsSink(const QString &_fileName, const QColor &_color)
+{
+    fileName = _fileName;
+    color = _color;
+    file = NULL;
+}
+
+lib3dsSink::~lib3dsSink()
+{
+    if(file) lib3ds_file_free(file);
+}
+
+bool lib3dsSink::begin(const QVector<meshgroup_t> &groups)
+{
+    file = lib3ds_file_new();
+    file->frames = 360;
+
+    Lib3dsMaterial* mat = lib3ds_material_new("coaster");
+    lib3ds_file_insert_material(file, mat, -1);
+    mat->diffuse[0] = color.red()/255.f;
+    mat->diffuse[1] = color.green()/255.f;
+    mat->diffuse[2] = color.blue()/255.f;
+
+    // 3ds meshes use 16 bit indices
+    meshes.clear();
+    for(int i = 0; i < groups.size(); ++i) {
+        if(groups[i].vertices.size() > 65535 || groups[i].triangles.size()/3 > 65535) {
+            qWarning("3ds mesh %s is too large", groups[i].name.toLocal8Bit().data());
+            return false;
+        }
+        Lib3dsMesh *mesh = lib3ds_mesh_new(groups[i].name.toLocal8Bit().data());
+        lib3ds_file_insert_mesh(file, mesh, -1);
+        lib3ds_mesh_resize_vertices(mesh, groups[i].vertices.size(), 1, 0);
+        lib3ds_mesh_resize_faces(mesh, groups[i].triangles.size()/3);
+        meshes.append(mesh);
+    }
+    return true;
+}
+
+void lib3dsSink::writeGroup(int index, const meshgroup_t &group)
+{
+    Lib3dsMesh *mesh = meshes[index];
+    for(int i = 0; i < group.vertices.size(); ++i) {
+        const glm::vec3 &pos = group.vertices[i]->pos;
+        mesh->vertices[i][0] = pos.x;
+        mesh->vertices[i][1] = -pos.z;
+        mesh->vertices[i][2] = pos.y;
+        mesh->texcos[i][0] = 0.f;
+        mesh->texcos[i][1] = 0.f;
+    }
+    for(int i = 0; i < group.triangles.size()/3; ++i) {
+        for(int j = 0; j < 3; ++j) {
+            mesh->faces[i].index[j] = group.triangles[3*i+j];
+        }
+        mesh->faces[i].material = 0;
+    }
+}
+
+bool lib3dsSink::end()
+{
+    for(int i = 0; i < meshes.size(); ++i) {
+        Lib3dsMeshInstanceNode *inst = lib3ds_node_new_mesh_instance(meshes[i], meshes[i]->name, NULL, NULL, NULL);
+        lib3ds_file_append_node(file, (Lib3dsNode*)inst, NULL);
+    }
+
+    {
+        Lib3dsCamera *camera;
+        Lib3dsCameraNode *n;
+        Lib3dsTargetNode *t;
+        int i;
+
+        camera = lib3ds_camera_new("camera01");
+        lib3ds_file_insert_camera(file, camera, -1);
+        lib3ds_vector_make(camera->position, 0.0, -100, 0.0);
+        lib3ds_vector_make(camera->target, 0.0, 0.0, 0.0);
+
+        n = lib3ds_node_new_camera(camera);
+        t = lib3ds_node_new_camera_target(camera);
+        lib3ds_file_append_node(file, (Lib3dsNode*)n, NULL);
+        lib3ds_file_append_node(file, (Lib3dsNode*)t, NULL);
+
+        lib3ds_track_resize(&n->pos_track, 37);
+        for (i = 0; i <= 36; i++) {
+            n->pos_track.keys[i].frame = 10 * i;
+            lib3ds_vector_make(n->pos_track.keys[i].value,
+                (float)(100.0 * cos(2 * F_PI * i / 36.0)),
+                (float)(100.0 * sin(2 * F_PI * i / 36.0)),
+                50.0
+            );
+        }
+    }
+
+    bool saved = lib3ds_file_save(file, fileName.toLocal8Bit().data());
+    if(!saved) {
+        qDebug("ERROR: Saving 3ds file failed!\n");
+    }
+    lib3ds_file_free(file);
+    file = NULL;
+    return saved;
+}
+
+objSink::objSink(const QString &_fileName)
+{
+    fileName = _fileName;
+}
+
+bool objSink::begin(const QVector<meshgroup_t> &groups)
+{
+    vertexOffsets.clear();
+    int offset = 1;
+    for(int i = 0; i < groups.size(); ++i) {
+        vertexOffsets.append(offset);
+        offset += groups[i].vertices.size();
+    }
+    chunks.clear();
+    chunks.resize(groups.size());
+    return true;
+}
+
+void objSink::writeGroup(int index, const meshgroup_t &group)
+{
+    QByteArray &out = chunks[index];
+    out.reserve(48*group.vertices.size() + 16*group.triangles.size());
+    out.append("o ").append(group.name.toUtf8()).append('\n');
+    for(int i = 0; i < group.vertices.size(); ++i) {
+        const tracknode_t* vertex = group.vertices[i];
+        out.append("v ").append(QByteArray::number(vertex->pos.x)).append(' ').append(QByteArray::number(vertex->pos.y)).append(' ').append(QByteArray::number(vertex->pos.z)).append('\n');
+        out.append("vn ").append(QByteArray::number(vertex->normal.x)).append(' ').append(QByteArray::number(vertex->normal.y)).append(' ').append(QByteArray::number(vertex->normal.z)).append('\n');
+    }
+    for(int i = 0; i+2 < group.triangles.size(); i += 3) {
+        out.append('f');
+        for(int j = 0; j < 3; ++j) {
+            QByteArray v = QByteArray::number(vertexOffsets[index] + group.triangles[i+j]);
+            out.append(' ').append(v).append("//").append(v);
+        }
+        out.append('\n');
+    }
+}
+
+bool objSink::end()
+{
+    QFile file(fileName);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning("Could not open %s", fileName.toLocal8Bit().data());
+        return false;
+    }
+    file.write("# FVD++ track export\n");
+    for(int i = 0; i < chunks.size(); ++i) {
+        file.write(chunks[i]);
+        chunks[i].clear();
+    }
+    return true;
+}
+
+plySink::plySink(const QString &_fileName)
+{
+    file.setFileName(_fileName);
+    groupList = NULL;
+}
+
+bool plySink::begin(const QVector<meshgroup_t> &groups)
+{
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning("Could not open %s", file.fileName().toLocal8Bit().data());
+        return false;
+    }
+
+    qint64 numVertices = 0, numFaces = 0;
+    for(int i = 0; i < groups.size(); ++i) {
+        numVertices += groups[i].vertices.size();
+        numFaces += groups[i].triangles.size()/3;
+    }
+
+    QByteArray header("ply\nformat binary_little_endian 1.0\ncomment FVD++ track export\n");
+    header.append("element vertex ").append(QByteArray::number(numVertices)).append('\n');
+    header.append("property float x\nproperty float y\nproperty float z\n");
+    header.append("property float nx\nproperty float ny\nproperty float nz\n");
+    header.append("element face ").append(QByteArray::number(numFaces)).append('\n');
+    header.append("property list uchar uint vertex_indices\nend_header\n");
+    file.write(header);
+
+    stream.setDevice(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    groupList = &groups;
+    return true;
+}
+
+void plySink::writeGroup(int, const meshgroup_t &group)
+{
+    for(int i = 0; i < group.vertices.size(); ++i) {
+        const tracknode_t* vertex = group.vertices[i];
+        stream << vertex->pos.x << vertex->pos.y << vertex->pos.z;
+        stream << vertex->normal.x << vertex->normal.y << vertex->normal.z;
+    }
+}
+
+bool plySink::end()
+{
+    // ply wants every vertex before the first face, so the index lists are walked a second time
+    quint32 offset = 0;
+    for(int i = 0; i < groupList->size(); ++i) {
+        const meshgroup_t &group = groupList->at(i);
+        for(int j = 0; j+2 < group.triangles.size(); j += 3) {
+            stream << (quint8)3 << offset+group.triangles[j] << offset+group.triangles[j+1] << offset+group.triangles[j+2];
+        }
+        offset += group.vertices.size();
+    }
+    groupList = NULL;
+
+    bool ok = stream.status() == QDataStream::Ok;
+    stream.setDevice(NULL);
+    file.close();
+    if(!ok) {
+        qWarning("Writing %s failed", file.fileName().toLocal8Bit().data());
+    }
+    return ok;
+}
+
+namespace {
+QJsonObject gltfBufferView(qint64 offset, qint64 length, int target)
+{
+    QJsonObject view;
+    view["buffer"] = 0;
+    view["byteOffset"] = (double)offset;
+    view["byteLength"] = (double)length;
+    view["target"] = target;
+    return view;
+}
+
+QJsonObject gltfAccessor(int bufferView, int componentType, int count, const char* type)
+{
+    QJsonObject accessor;
+    accessor["bufferView"] = bufferView;
+    accessor["componentType"] = componentType;
+    accessor["count"] = count;
+    accessor["type"] = QString(type);
+    return accessor;
+}
+
+bool gltfWritten(const meshgroup_t &group)
+{
+    // gltf accessors need at least one element
+    return !group.vertices.isEmpty() && group.triangles.size() >= 3;
+}
+}
+
+gltfSink::gltfSink(const QString &_fileName, const QColor &_color)
+{
+    file.setFileName(_fileName);
+    color = _color;
+    fileLength = 0;
+}
+
+bool gltfSink::begin(const QVector<meshgroup_t> &groups)
+{
+    QJsonArray nodes, meshes, accessors, bufferViews, sceneNodes;
+    qint64 binLength = 0;
+
+    // per group: positions, normals and 32 bit indices, all of them multiples of 4 bytes
+    for(int i = 0; i < groups.size(); ++i) {
+        const meshgroup_t &group = groups[i];
+        if(!gltfWritten(group)) continue;
+
+        glm::vec3 minPos = group.vertices[0]->pos, maxPos = group.vertices[0]->pos;
+        for(int j = 1; j < group.vertices.size(); ++j) {
+            minPos = glm::min(minPos, group.vertices[j]->pos);
+            maxPos = glm::max(maxPos, group.vertices[j]->pos);
+        }
+
+        int view = bufferViews.size();
+        qint64 vertexBytes = 12*(qint64)group.vertices.size();
+        qint64 indexBytes = 4*(qint64)group.triangles.size();
+        bufferViews.append(gltfBufferView(binLength, vertexBytes, 34962));
+        bufferViews.append(gltfBufferView(binLength+vertexBytes, vertexBytes, 34962));
+        bufferViews.append(gltfBufferView(binLength+2*vertexBytes, indexBytes, 34963));
+        binLength += 2*vertexBytes + indexBytes;
+
+        int accessor = accessors.size();
+        QJsonObject position = gltfAccessor(view, 5126, group.vertices.size(), "VEC3");
+        position["min"] = QJsonArray() << minPos.x << minPos.y << minPos.z;
+        position["max"] = QJsonArray() << maxPos.x << maxPos.y << maxPos.z;
+        accessors.append(position);
+        accessors.append(gltfAccessor(view+1, 5126, group.vertices.size(), "VEC3"));
+        accessors.append(gltfAccessor(view+2, 5125, group.triangles.size(), "SCALAR"));
+
+        QJsonObject attributes;
+        attributes["POSITION"] = accessor;
+        attributes["NORMAL"] = accessor+1;
+        QJsonObject primitive;
+        primitive["attributes"] = attributes;
+        primitive["indices"] = accessor+2;
+        primitive["material"] = 0;
+        QJsonObject mesh;
+        mesh["name"] = group.name;
+        mesh["primitives"] = QJsonArray() << primitive;
+        meshes.append(mesh);
+
+        QJsonObject node;
+        node["name"] = group.name;
+        node["mesh"] = meshes.size()-1;
+        sceneNodes.append(nodes.size());
+        nodes.append(node);
+    }
+    if(nodes.isEmpty()) {
+        qWarning("Nothing to export");
+        return false;
+    }
+
+    QJsonObject asset;
+    asset["version"] = QString("2.0");
+    asset["generator"] = QString("FVD++");
+    QJsonObject scene;
+    scene["nodes"] = sceneNodes;
+    QJsonObject pbr;
+    pbr["baseColorFactor"] = QJsonArray() << color.redF() << color.greenF() << color.blueF() << 1.0;
+    pbr["metallicFactor"] = 0.0;
+    QJsonObject material;
+    material["name"] = QString("coaster");
+    material["pbrMetallicRoughness"] = pbr;
+    QJsonObject buffer;
+    buffer["byteLength"] = (double)binLength;
+
+    QJsonObject root;
+    root["asset"] = asset;
+    root["scene"] = 0;
+    root["scenes"] = QJsonArray() << scene;
+    root["nodes"] = nodes;
+    root["meshes"] = meshes;
+    root["materials"] = QJsonArray() << material;
+    root["accessors"] = accessors;
+    root["bufferViews"] = bufferViews;
+    root["buffers"] = QJsonArray() << buffer;
+
+    QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    while(json.size()%4) json.append(' ');
+
+    fileLength = 12 + 8 + json.size() + 8 + binLength;
+    if(fileLength > 0xffffffffLL) {
+        qWarning("glb file would exceed 4 GB");
+        return false;
+    }
+    if(!file.open(QIODevice::WriteOnly)) {
+        qWarning("Could not open %s", file.fileName().toLocal8Bit().data());
+        return false;
+    }
+
+    stream.setDevice(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+    stream << (quint32)0x46546C67 << (quint32)2 << (quint32)fileLength;     // "glTF"
+    stream << (quint32)json.size() << (quint32)0x4E4F534A;                  // "JSON"
+    stream.writeRawData(json.constData(), json.size());
+    stream << (quint32)binLength << (quint32)0x004E4942;                    // "BIN"
+    return true;
+}
+
+void gltfSink::writeGroup(int, const meshgroup_t &group)
+{
+    if(!gltfWritten(group)) return;
+
+    for(int i = 0; i < group.vertices.size(); ++i) {
+        const glm::vec3 &pos = group.vertices[i]->pos;
+        stream << pos.x << pos.y << pos.z;
+    }
+    for(int i = 0; i < group.vertices.size(); ++i) {
+        const glm::vec3 &normal = group.vertices[i]->normal;
+        stream << normal.x << normal.y << normal.z;
+    }
+    for(int i = 0; i < group.triangles.size(); ++i) {
+        stream << (quint32)group.triangles[i];
+    }
+}
+
+bool gltfSink::end()
+{
+    bool ok = stream.status() == QDataStream::Ok && file.pos() == fileLength;
+    stream.setDevice(NULL);
+    file.close();
+    if(!ok) {
+        qWarning("Writing %s failed", file.fileName().toLocal8Bit().data());
+    }
+    return ok;
+}
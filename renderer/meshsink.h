@@ -0,0 +1,119 @@
+#ifndef MESHSINK_H
+#define MESHSINK_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QString>
+#include <QVector>
+#include <QColor>
+#include <QByteArray>
+#include <QFile>
+#include <QDataStream>
+#include "trackmesh.h"
+
+struct Lib3dsFile;
+struct Lib3dsMesh;
+
+typedef struct meshgroup_s{
+    QString name;
+    QVector<const tracknode_t*> vertices;   // points into the vertices of the render mesh
+    QVector<unsigned int> triangles;        // three indices into vertices per triangle
+} meshgroup_t;
+
+// receives the groups of trackMesh::exportMesh()
+// begin() and end() run on the calling thread, writeGroup() runs in parallel for different groups
+// sequential sinks get writeGroup() in group order on the calling thread, so they can stream into the file
+class meshSink
+{
+public:
+    virtual ~meshSink() {}
+    virtual bool sequential() const { return false; }
+    virtual bool begin(const QVector<meshgroup_t> &groups) = 0;
+    virtual void writeGroup(int index, const meshgroup_t &group) = 0;
+    virtual bool end() = 0;
+};
+
+class lib3dsSink : public meshSink
+{
+public:
+    lib3dsSink(const QString &_fileName, const QColor &_color);
+    ~lib3dsSink();
+
+    bool begin(const QVector<meshgroup_t> &groups);
+    void writeGroup(int index, const meshgroup_t &group);
+    bool end();
+
+private:
+    QString fileName;
+    QColor color;
+    Lib3dsFile* file;
+    QVector<Lib3dsMesh*> meshes;
+};
+
+class objSink : public meshSink
+{
+public:
+    objSink(const QString &_fileName);
+
+    bool begin(const QVector<meshgroup_t> &groups);
+    void writeGroup(int index, const meshgroup_t &group);
+    bool end();
+
+private:
+    QString fileName;
+    QVector<int> vertexOffsets;     // obj indices count all vertices of the file, starting at 1
+    QVector<QByteArray> chunks;
+};
+
+// binary little endian ply, vertices are streamed per group, the faces follow in end()
+class plySink : public meshSink
+{
+public:
+    plySink(const QString &_fileName);
+
+    bool sequential() const { return true; }
+    bool begin(const QVector<meshgroup_t> &groups);
+    void writeGroup(int index, const meshgroup_t &group);
+    bool end();
+
+private:
+    QFile file;
+    QDataStream stream;
+    const QVector<meshgroup_t>* groupList;
+};
+
+// binary gltf 2.0, one node per group, the whole buffer layout is known in begin()
+class gltfSink : public meshSink
+{
+public:
+    gltfSink(const QString &_fileName, const QColor &_color);
+
+    bool sequential() const { return true; }
+    bool begin(const QVector<meshgroup_t> &groups);
+    void writeGroup(int index, const meshgroup_t &group);
+    bool end();
+
+private:
+    QFile file;
+    QDataStream stream;
+    QColor color;
+    qint64 fileLength;
+};
+
+#endif // MESHSINK_H
@@ -20,6 +20,16 @@
 #include "shaders.h"
 #include <QFile>
 
+// the GLSL names of eUniform, in the same order
+static const char* uniformNames[uniformCount] = {
+    "anchorBase", "colorMode", "selection", "defaultColor", "sectionColor", "transitionColor",
+    "metricTex", "metricStep", "metalTex", "skyTex", "occlusionTex", "shadowTex", "rasterTex", "floorTex",
+    "border", "grid", "opacity", "uFill",
+    "TL", "TR", "BL", "BR", "eyePos",
+    "tex", "width", "height", "hmdWarp", "lensCenter", "scale",
+    "frameTex", "numPipes", "numFrames", "capMode", "tieTex", "tiePeriod", "firstTie",
+};
+
 myShader::myShader(const char* _vertex, const char* _fragment)
 {
     QFile vertex(_vertex);
@@ -35,6 +45,8 @@ myShader::myShader(const char* _vertex, const char* _fragment)
 #ifdef Q_OS_MAC
     v.replace("#version 130", "#version 150 core");
     f.replace("#version 130", "#version 150 core");
+    v.replace("#version 140", "#version 150 core");
+    f.replace("#version 140", "#version 150 core");
 #endif
 
     char* v1 = new char[v.size()+1];
@@ -71,34 +83,50 @@ void myShader::setOutput(GLuint _index, const GLchar* _name)
     glBindFragDataLocation(program, _index, _name);
 }
 
-void myShader::useUniform(const GLchar* _name, glm::mat4* _mat4)
+void myShader::setFeedback(const GLchar** _names, GLsizei _count)
+{
+    glTransformFeedbackVaryings(program, _count, _names, GL_INTERLEAVED_ATTRIBS);
+}
+
+void myShader::useUniform(eUniform _uniform, glm::mat4* _mat4)
 {
-    glUniformMatrix4fv(glGetUniformLocation(program, _name), 1, GL_FALSE, glm::value_ptr(*_mat4));
+    glUniformMatrix4fv(locations[_uniform], 1, GL_FALSE, glm::value_ptr(*_mat4));
 }
 
-void myShader::useUniform(const GLchar* _name, glm::vec4* _vec4)
+void myShader::useUniform(eUniform _uniform, glm::vec4* _vec4)
 {
-    glUniform4f(glGetUniformLocation(program, _name), _vec4->x, _vec4->y, _vec4->z, _vec4->w);
+    glUniform4f(locations[_uniform], _vec4->x, _vec4->y, _vec4->z, _vec4->w);
 }
 
-void myShader::useUniform(const GLchar* _name, glm::vec3* _vec3)
+void myShader::useUniform(eUniform _uniform, glm::vec3* _vec3)
 {
-    glUniform3f(glGetUniformLocation(program, _name), _vec3->x, _vec3->y, _vec3->z);
+    glUniform3f(locations[_uniform], _vec3->x, _vec3->y, _vec3->z);
 }
 
-void myShader::useUniform(const GLchar* _name, float f1, float f2, float f3)
+void myShader::useUniform(eUniform _uniform, glm::ivec4* _ivec4)
 {
-    glUniform3f(glGetUniformLocation(program, _name), f1, f2, f3);
+    glUniform4i(locations[_uniform], _ivec4->x, _ivec4->y, _ivec4->z, _ivec4->w);
 }
 
-void myShader::useUniform(const GLchar* _name, GLuint _int)
+void myShader::useUniform(eUniform _uniform, float f1, float f2, float f3)
 {
-    glUniform1i(glGetUniformLocation(program, _name), _int);
+    glUniform3f(locations[_uniform], f1, f2, f3);
 }
 
-void myShader::useUniform(const GLchar* _name, float _float)
+void myShader::useUniform(eUniform _uniform, GLuint _int)
 {
-    glUniform1f(glGetUniformLocation(program, _name), _float);
+    glUniform1i(locations[_uniform], _int);
+}
+
+void myShader::useUniform(eUniform _uniform, float _float)
+{
+    glUniform1f(locations[_uniform], _float);
+}
+
+void myShader::useUniformBlock(const GLchar* _name, GLuint _binding)
+{
+    GLuint index = glGetUniformBlockIndex(program, _name);
+    if(index != GL_INVALID_INDEX) glUniformBlockBinding(program, index, _binding);
 }
 
 void myShader::linkProgram()
@@ -108,6 +136,11 @@ void myShader::linkProgram()
 
     glLinkProgram(program);
     printGLSLLinkLog(program);
+
+    for(int i = 0; i < uniformCount; ++i)
+    {
+        locations[i] = glGetUniformLocation(program, uniformNames[i]);
+    }
 }
 
 void myShader::bind()
@@ -21,6 +21,22 @@
 
 #include "glviewwidget.h"
 
+// binding point of the per frame uniform block shared by all shaders
+#define FRAME_UNIFORMS 0
+
+// the uniforms the renderer sets every frame, linkProgram() looks their locations up once
+// a shader without one of them gets -1, which glUniform ignores
+enum eUniform
+{
+    uniAnchorBase, uniColorMode, uniSelection, uniDefaultColor, uniSectionColor, uniTransitionColor,
+    uniMetricTex, uniMetricStep, uniMetalTex, uniSkyTex, uniOcclusionTex, uniShadowTex, uniRasterTex, uniFloorTex,
+    uniBorder, uniGrid, uniOpacity, uniFill,
+    uniTL, uniTR, uniBL, uniBR, uniEyePos,
+    uniTex, uniWidth, uniHeight, uniHmdWarp, uniLensCenter, uniScale,
+    uniFrameTex, uniNumPipes, uniNumFrames, uniCapMode, uniTieTex, uniTiePeriod, uniFirstTie,
+    uniformCount
+};
+
 class myShader
 {
 public:
@@ -28,19 +44,24 @@ public:
     ~myShader();
     void useAttribute(GLuint _index, const GLchar* _name);
     void setOutput(GLuint _index, const GLchar* _name);
+    void setFeedback(const GLchar** _names, GLsizei _count);
+
+    void useUniform(eUniform _uniform, glm::mat4* _mat4);
+    void useUniform(eUniform _uniform, glm::vec4* _vec4);
+    void useUniform(eUniform _uniform, glm::vec3* _vec3);
+    void useUniform(eUniform _uniform, glm::ivec4* _ivec4);
+    void useUniform(eUniform _uniform, float f1, float f2, float f3);
+    void useUniform(eUniform _uniform, GLuint _int);
+    void useUniform(eUniform _uniform, float _float);
 
-    void useUniform(const GLchar* _name, glm::mat4* _mat4);
-    void useUniform(const GLchar* _name, glm::vec4* _vec4);
-    void useUniform(const GLchar* _name, glm::vec3* _vec3);
-    void useUniform(const GLchar* _name, float f1, float f2, float f3);
-    void useUniform(const GLchar* _name, GLuint _int);
-    void useUniform(const GLchar* _name, float _float);
+    void useUniformBlock(const GLchar* _name, GLuint _binding);
 
     void linkProgram();
     void bind();
 private:
     GLuint sources[2];
     GLuint program;
+    GLint locations[uniformCount];
 };
 
 #endif // MYSHADER_H
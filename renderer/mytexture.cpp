@@ -160,6 +160,20 @@ myTexture::myTexture(int _width, int _height, GLuint _format, GLuint _intFormat)
     iType = 1;
 }
 
+myTexture::myTexture(GLuint _buffer, GLuint _format)
+{
+    mId = getFreeID();
+    myTexture::usedIDs[mId] = true;
+    glActiveTexture(GL_TEXTURE0 + mId);
+    glBindBuffer(GL_TEXTURE_BUFFER, _buffer);
+    glGenTextures(1, &handle);
+    glBindTexture(GL_TEXTURE_BUFFER, handle);
+    glTexBuffer(GL_TEXTURE_BUFFER, _format, _buffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    iType = 3;
+}
+
 myTexture::~myTexture()
 {
     myTexture::usedIDs[mId] = false;
@@ -28,6 +28,7 @@ public:
     myTexture(const char* _image, int mode = 0);
     myTexture(const char *_negx, const char *_negy, const char *_negz, const char *_posx, const char *_posy, const char *_posz);
     myTexture(int _width, int _height, GLuint _format, GLuint _intFormat);
+    myTexture(GLuint _buffer, GLuint _format);
     ~myTexture();
     GLuint getId();
     GLuint getHandle();
@@ -17,9 +17,14 @@
 */
 
 #include "trackmesh.h"
+#include "mytexture.h"
 #include "mainwindow.h"
 #include "optionsmenu.h"
 #include "mnode.h"
+#include "meshsink.h"
+#include <QThreadPool>
+#include <QHash>
+#include <functional>
 
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
@@ -31,7 +36,7 @@ trackMesh::trackMesh(track* parent)
     if(!glView->legacyMode)
     {
         glGenVertexArrays(5, TrackObject);
-        glGenBuffers(7, TrackBuffer);
+        glGenBuffers(8, TrackBuffer);
         glGenBuffers(5, TrackIndices);
         glGenVertexArrays(5, HeartObject);
         glGenBuffers(5, HeartBuffer);
@@ -42,28 +47,58 @@ trackMesh::trackMesh(track* parent)
 
     trackVertexSize = 0;
     numRails = 0;
+    selection = glm::ivec4(0, -1, 0, -1);
     supportsSize = 0;
     heartlineSize = 0;
     railShadowSize = 0;
+    numChunks = 0;
+    lodStrips = 0;
+    buildTime = -1.f;
+    metricsFrom = -1;
+    metricStep = 1;
+    listsReleased = false;
+    supportVertexCount = 0;
+    supportShadowCount = 0;
+    crosstieShadowCount = 0;
+    drawnChunks = 0;
+    culledChunks = 0;
     trackData = parent;
+    metricTexture = NULL;
+    frameTexture = NULL;
+    gpuRails = false;
+    tieTexture = NULL;
+    tieRadius = 0.f;
+    gpuCrossties = false;
 	isWireframe = false;
 }
 
-void trackMesh::init() {
+void trackMesh::init(bool build) {
     if(!glView->legacyMode)
     {
         glGenVertexArrays(5, TrackObject);
-        glGenBuffers(7, TrackBuffer);
+        glGenBuffers(8, TrackBuffer);
         glGenBuffers(5, TrackIndices);
         glGenVertexArrays(5, HeartObject);
         glGenBuffers(5, HeartBuffer);
         glGenBuffers(5, HeartIndices);
         glGenVertexArrays(1, ShadowObject);
         glGenBuffers(1, ShadowBuffer);
+        metricTexture = new myTexture(TrackBuffer[1], GL_RGBA32F);
+        frameTexture = new myTexture(TrackBuffer[2], GL_RGBA32F);
+        tieTexture = new myTexture(TrackBuffer[7], GL_RGBA32F);
     }
 
     isInit = true;
-    buildMeshes(0);
+    if(build)
+    {
+        buildMeshes(0);
+    }
+    else
+    {
+        // generated before the first frame, only the new buffers need the data
+        metricsFrom = -1;
+        uploadMeshes();
+    }
 }
 
 trackMesh::~trackMesh()
@@ -72,11 +107,14 @@ trackMesh::~trackMesh()
     {
         glDeleteVertexArrays(5, TrackObject);
         glDeleteVertexArrays(5, HeartObject);
-        glDeleteBuffers(7, TrackBuffer);
+        glDeleteBuffers(8, TrackBuffer);
         glDeleteBuffers(5, HeartBuffer);
         glDeleteBuffers(5, TrackIndices);
         glDeleteBuffers(5, HeartIndices);
     }
+    delete metricTexture;
+    delete frameTexture;
+    delete tieTexture;
 }
 
 /*enum trackStyle {
@@ -99,37 +137,17 @@ void trackMesh::appendTrackNode(QVector<tracknode_t> &list, float _u, float _v)
     temp.pos = nextPos;
     temp.normal = nextNorm;
     temp.uv = glm::vec2(_u, _v);
-    temp.vel = curNode->fVel;
-    temp.rollSpeed = fabs(curNode->fRollSpeed+curNode->fSmoothSpeed);
-    temp.yForce = curNode->forceNormal+curNode->smoothNormal;
-    temp.xForce = fabs(curNode->forceLateral + curNode->smoothLateral);
-    temp.flexion = fabs(curNode->fFlexion());
-
-    temp.selected = (trackData == gloParent->curTrack() && curSection == trackData->activeSection) ? (curSection->isInFunction(j, gloParent->selectedFunc) ? 2.f : 1.f) : 0.f;
 
     list.append(temp);
 }
 
-void trackMesh::append3dsNode(QVector<float> *_vertices)
-{
-    _vertices->append(nextPos.x);
-    _vertices->append(nextPos.y);
-    _vertices->append(nextPos.z);
-}
-
 void trackMesh::appendSupportNode(QVector<tracknode_t> &list, float _u, float _v)
 {
     tracknode_t temp;
-    temp.node = nextNode;
+    temp.node = -1; // supports are never highlighted
     temp.pos = nextPos;
     temp.normal = nextNorm;
     temp.uv = glm::vec2(_u, _v);
-    temp.vel =0;
-    temp.rollSpeed = 0;
-    temp.yForce = 0;
-    temp.xForce = 0;
-    temp.flexion = 0;
-    temp.selected = 0;
 
     list.append(temp);
 }
@@ -143,9 +161,8 @@ void trackMesh::appendMeshNode(QVector<meshnode_t> &list)
     list.append(temp);
 }
 
-int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &options)
+void trackMesh::createRings(QVector<tracknode_t> &list, QList<pipeoption_t> &options)
 {
-    int count = 0;
     float angle;
     int numPipes = options.size();
 
@@ -155,7 +172,7 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
         {
             j = 0;
             curSection = trackData->lSections[0];
-			curNode = &curSection->lNodes[0];
+			curNode = curSection->readNode(0);
             nextNorm = -curNode->vDirHeart(-options[p].offset.y);
             nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
             nextNode = 0;
@@ -175,7 +192,7 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
 
                 j = posList[pos];
                 curSection = trackData->lSections[secList[pos]];
-				curNode = &curSection->lNodes[j];
+				curNode = curSection->readNode(j);
 
                 nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180))*curNode->vLatHeart(-options[p].offset.y);
 
@@ -203,7 +220,7 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
         {
             j = posList.last();
             curSection = trackData->lSections[secList.last()];
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
 
             nextNorm = curNode->vDirHeart(-options[p].offset.y);
             nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
@@ -211,6 +228,15 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
             appendTrackNode(list, 0, curNode->fTotalLength);
         }
     }
+}
+
+int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &options)
+{
+    int count = 0;
+    int numPipes = options.size();
+
+    if(gpuRails) createRailFrames(options);
+    else createRings(list, options);
 
     // get shadow vertices
 
@@ -221,7 +247,7 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
         {
             j = posList[i];
             curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
             nextNode = trackData->getNumPoints(curSection) + j;
 
             float banking = glm::atan(curNode->vLatHeart(-options[p].offset.y).y, -curNode->vNorm.y)+F_PI_2+0.001;
@@ -277,69 +303,74 @@ int trackMesh::createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &opti
     return count;
 }
 
-int trackMesh::create3dsPipes(QVector<float> *_vertices, QList<pipeoption_t> &options)
+void trackMesh::createRailFrames(QList<pipeoption_t> &options)
 {
-    int count = 0;
-    float angle;
     int numPipes = options.size();
 
-    for(int p = 0; p < numPipes; ++p)
+    for(int pos = 0; pos < posList.size(); ++pos)
     {
-        if(!secList.isEmpty())
+        j = posList[pos];
+        curSection = trackData->lSections[secList[pos]];
+        curNode = curSection->readNode(j);
+        for(int p = 0; p < numPipes; ++p)
         {
-            j = posList[0];
-            curSection = trackData->lSections[secList[0]];
-			curNode = &curSection->lNodes[j];
-            nextNorm = -curNode->vDirHeart(-options[p].offset.y);
-            nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
-            nextNode = trackData->getNumPoints(curSection) + j;
-            append3dsNode(_vertices);
+            railframe_t temp;
+            temp.pos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
+            temp.v = curNode->fTotalLength;
+            temp.normal = curNode->vNorm;
+            temp.node = trackData->getNumPoints(curSection) + j;
+            temp.lat = curNode->vLatHeart(-options[p].offset.y);
+            temp.dir = curNode->vDirHeart(-options[p].offset.y);
+            railFrames.append(temp);
         }
+    }
+}
 
-        for(int pos = 0; pos < posList.size(); ++pos)
-        {
-            //float r = 0.5f*(options[p].radius.y+options[p].radius.x);
-            for(int i = 0; i < options[p].edges; ++i)
-            {
-                if(options[p].smooth) angle = i*360.f/options[p].edges - 180.f/options[p].edges;
-                else angle = (i/2)*720.f/options[p].edges - 360.f/options[p].edges;
-
-                j = posList[pos];
-				curSection = trackData->lSections[secList[pos]];
-				curNode = &curSection->lNodes[j];
-
-                nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180))*curNode->vLatHeart(-options[p].offset.y);
-                nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x)+nextNorm;
-                nextNode = trackData->getNumPoints(curSection) + j;
-                if(options[p].smooth)
-                {
-                    nextNorm = glm::normalize(nextNorm);
-                    append3dsNode(_vertices);
-                }
-                else
-                {
-                    nextNorm = -(float)(options[p].radius.y*cos(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*curNode->vNorm+(float)(options[p].radius.x*sin(angle*F_PI/180+((i%2)*2-1)*F_PI_4))*curNode->vLatHeart(-options[p].offset.y);
-                    nextNorm = glm::normalize(nextNorm);
-                    append3dsNode(_vertices);
-                }
-            }
-        }
+void trackMesh::createRingTemplate(QList<pipeoption_t> &options)
+{
+    float angle;
+    ringTemplate.clear();
 
-        //last node here
-        if(!posList.isEmpty())
+    // same ring layout as createRings(), only relative to the frame of its pipe
+    for(int p = 0; p < options.size(); ++p)
+    {
+        float r = 0.5f*(options[p].radius.y+options[p].radius.x);
+        for(int i = 0; i < options[p].edges; ++i)
         {
-            j = posList.last();
-            curSection = trackData->lSections[secList.last()];
-			curNode = &curSection->lNodes[j];
+            if(options[p].smooth) angle = i*360.f/options[p].edges - 180.f/options[p].edges;
+            else angle = (i/2)*720.f/options[p].edges - 360.f/options[p].edges;
 
-            nextNorm = curNode->vDirHeart(-options[p].offset.y);
-            nextPos = curNode->vRelPos(options[p].offset.y, options[p].offset.x);
-            nextNode = trackData->getNumPoints(curSection) + j;
-            append3dsNode(_vertices);
+            ringvertex_t temp;
+            temp.shape.x = options[p].radius.y*cos(angle*F_PI/180);
+            temp.shape.y = options[p].radius.x*sin(angle*F_PI/180);
+            if(options[p].smooth)
+            {
+                temp.shape.z = temp.shape.x;
+                temp.shape.w = temp.shape.y;
+            }
+            else
+            {
+                temp.shape.z = options[p].radius.y*cos(angle*F_PI/180+((i%2)*2-1)*F_PI_4);
+                temp.shape.w = options[p].radius.x*sin(angle*F_PI/180+((i%2)*2-1)*F_PI_4);
+            }
+            temp.u = r/0.3f*fabs(angle-180+180.f/options[p].edges)/180.f;
+            temp.pipe = p;
+            ringTemplate.append(temp);
         }
     }
+}
 
-    return count;
+int trackMesh::lastRailNode()
+{
+    if(gpuRails) return railFrames.size() ? (int)railFrames.last().node : -1;
+    return rails.size() ? rails.last().node : -1;
+}
+
+int trackMesh::railVertexCount()
+{
+    if(!gpuRails) return rails.size();
+    if(options.isEmpty() || railFrames.isEmpty()) return 0;
+    return 2*options.size() + railFrames.size()/options.size()*ringTemplate.size();
 }
 
 int trackMesh::createPipe(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, float y, float x, bool smooth)
@@ -358,7 +389,7 @@ int trackMesh::createPipe(QVector<tracknode_t> &list, int edges, float radiusy,
             j = posList[i];
             curSection = trackData->lSections[secList[i]];
 
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
 
             if((i == 0 && iteration%2==0) || (i == posList.size()-1 && iteration%2!=0))
             {
@@ -444,7 +475,7 @@ int trackMesh::createPipe(QVector<tracknode_t> &list, int edges, float radiusy,
         j = posList[i];
         curSection = trackData->lSections[secList[i]];
 
-		curNode = &curSection->lNodes[j];
+		curNode = curSection->readNode(j);
 
         P5 = P1;
         P6 = P2;
@@ -628,34 +659,6 @@ void trackMesh::createQuad(QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P
     appendTrackNode(list, glm::dot(P4, base1), glm::dot(P4, base2));
 }
 
-void trackMesh::create3dsQuad(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
-{
-    int offset = _vertices->size()/3;
-    _vertices->append(P1.x);
-    _vertices->append(P1.y);
-    _vertices->append(P1.z);
-
-    _vertices->append(P2.x);
-    _vertices->append(P2.y);
-    _vertices->append(P2.z);
-
-    _vertices->append(P3.x);
-    _vertices->append(P3.y);
-    _vertices->append(P3.z);
-
-    _vertices->append(P4.x);
-    _vertices->append(P4.y);
-    _vertices->append(P4.z);
-
-    _indices->append(offset+0);
-    _indices->append(offset+2);
-    _indices->append(offset+1);
-
-    _indices->append(offset+0);
-    _indices->append(offset+3);
-    _indices->append(offset+2);
-}
-
 void trackMesh::createQuad(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4)
 {
     nextNorm = glm::normalize(glm::cross(P1-P4, P1-P2));
@@ -708,66 +711,6 @@ void trackMesh::createBox(QVector<tracknode_t> &list, glm::vec3 P1l, glm::vec3 P
     createQuad(list, P3l, P1l, P1r, P3r);
 }
 
-void trackMesh::create3dsBox(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
-{
-    int offset = _vertices->size()/3;
-    _vertices->append(P1l.x);
-    _vertices->append(P1l.y);
-    _vertices->append(P1l.z);
-
-    _vertices->append(P2l.x);
-    _vertices->append(P2l.y);
-    _vertices->append(P2l.z);
-
-    _vertices->append(P4l.x);
-    _vertices->append(P4l.y);
-    _vertices->append(P4l.z);
-
-    _vertices->append(P3l.x);
-    _vertices->append(P3l.y);
-    _vertices->append(P3l.z);
-
-    _vertices->append(P1r.x);
-    _vertices->append(P1r.y);
-    _vertices->append(P1r.z);
-
-    _vertices->append(P2r.x);
-    _vertices->append(P2r.y);
-    _vertices->append(P2r.z);
-
-    _vertices->append(P4r.x);
-    _vertices->append(P4r.y);
-    _vertices->append(P4r.z);
-
-    _vertices->append(P3r.x);
-    _vertices->append(P3r.y);
-    _vertices->append(P3r.z);
-
-    const int l = 0;
-    const int r = 4;
-    QList<int> points;
-    for(int i = 0; i < 5; ++i)
-    {
-        points.append(offset+i%4+l);
-        points.append(offset+i%4+r);
-    }
-    for(int i = 0; i < points.size()-2; ++i)
-    {
-        if(i%2)
-        {
-            _indices->append(points[i]);
-            _indices->append(points[i+2]);
-            _indices->append(points[i+1]);
-        }
-        else
-        {
-            _indices->append(points[i]);
-            _indices->append(points[i+1]);
-            _indices->append(points[i+2]);
-        }
-    }
-}
-
 void trackMesh::createBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r)
 {
     createQuad(list, P1l, P2l, P2r, P1r);
@@ -1129,10 +1072,78 @@ int trackMesh::createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::ve
     return count;
 }
 
-void trackMesh::buildMeshes(int fromNode)
+void trackMesh::buildMeshes(int fromNode, int toSection)
+{
+    if(glView->legacyMode) return;
+
+    generateMeshes(fromNode, currentMeshSettings(), toSection);
+    uploadMeshes();
+    if(buildTime >= 0.f)
+    {
+        gloParent->showMessage(QString::number(buildTime).append(QString("ms used to build meshes")), 3000);
+    }
+}
+
+void trackMesh::uploadMeshes()
 {
     if(glView->legacyMode) return;
 
+    uploadNodeMetrics();
+    updateVertexArrays();
+}
+
+// a compacted track keeps drawing from the buffers, the copies in these lists only serve partial rebuilds and the export
+void trackMesh::releaseLists()
+{
+    if(glView->legacyMode || !isInit) return;
+
+    rails.clear();
+    rails.squeeze();
+    crossties.clear();
+    crossties.squeeze();
+    rendersupports.clear();
+    rendersupports.squeeze();
+    supports.clear();
+    supports.squeeze();
+    railshadows.clear();
+    railshadows.squeeze();
+    crosstieshadows.clear();
+    crosstieshadows.squeeze();
+    supportshadows.clear();
+    supportshadows.squeeze();
+    listsReleased = true;
+}
+
+meshsettings_t currentMeshSettings()
+{
+    meshsettings_t settings;
+    settings.quality = gloParent->mOptions->meshQuality;
+    settings.gpuRails = glView->gpuRails;
+    settings.gpuCrossties = glView->gpuCrossties;
+    settings.legacyMode = glView->legacyMode;
+    return settings;
+}
+
+void trackMesh::generateMeshes(int fromNode)
+{
+    generateMeshes(fromNode, currentMeshSettings());
+}
+
+void trackMesh::generateMeshes(int fromNode, const meshsettings_t &settings, int toSection)
+{
+    if(settings.legacyMode) return;
+
+    if(listsReleased)
+    {
+        fromNode = 0;
+        listsReleased = false;
+    }
+
+    // sections from toSection on keep no rails, ties or supports until they are meshed again
+    int endSection = trackData->lSections.size();
+    if(toSection >= 0 && toSection < endSection) endSection = toSection;
+
+    buildTime = -1.f;
     //rails.clear();
     //crossties.clear();
     rendersupports.clear();
@@ -1153,6 +1164,22 @@ void trackMesh::buildMeshes(int fromNode)
     railShadowSize = 0;
 
     if(fromNode < 0) fromNode = 0;
+    if(gpuRails != (settings.gpuRails && !isWireframe))
+    {
+        gpuRails = !gpuRails;
+        rails.clear();
+        railFrames.clear();
+        fromNode = 0;
+    }
+    if(gpuCrossties != (settings.gpuCrossties && !isWireframe))
+    {
+        gpuCrossties = !gpuCrossties;
+        crossties.clear();
+        crosstieshadows.clear();
+        tieFrames.clear();
+        fromNode = 0;
+    }
+    updateNodeMetrics(fromNode);
     int fromSection, fromSecI = fromNode;
 
     for(fromSection = 0; fromSection < trackData->lSections.size(); ++fromSection)
@@ -1166,7 +1193,7 @@ void trackMesh::buildMeshes(int fromNode)
     float crosstieSpacing = 0.f;
 
     float meshQuality;
-    switch(gloParent->mOptions->meshQuality)
+    switch(settings.quality)
     {
     case 0:
         meshQuality = 1;
@@ -1260,19 +1287,22 @@ void trackMesh::buildMeshes(int fromNode)
         // delete obsolete railnodes
         int railNode;
 
-        if(rails.size() && fromNode >= rails.last().node)
+        if(lastRailNode() != -1 && fromNode >= lastRailNode())
         {
-            fromNode = rails.last().node-5;
+            fromNode = lastRailNode()-5;
         }
 
         for(railNode = 0; railNode < rails.size() && rails[railNode].node < fromNode; ++railNode);
         rails.remove(railNode, rails.size()-railNode);
+        for(railNode = 0; railNode < railFrames.size() && railFrames[railNode].node < fromNode; ++railNode);
+        railFrames.remove(railNode, railFrames.size()-railNode);
 
-        railNode = rails.size() ? rails.last().node : 0;
+        railNode = lastRailNode() != -1 ? lastRailNode() : 0;
 
         if(railNode == 0)
         {
             rails.clear();
+            railFrames.clear();
         }
 
         int i;
@@ -1283,16 +1313,16 @@ void trackMesh::buildMeshes(int fromNode)
 
         if(i == j && j == 0) distFromLastNode = 1.f;
 
-        for(; i < trackData->lSections.size(); i++)
+        for(; i < endSection; i++)
         {
             curSection = trackData->lSections[i];
             for(; j < curSection->lNodes.size(); ++j)
             {
                 if(i != 0 && j == 1) distFromLastNode = 1.f;
-                float angle = curSection->lNodes[(j)].fFlexion();
+                float angle = curSection->readNode(j)->fFlexion();
                 angle /= angleNodeDist;
                 angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-				angle *= curSection->lNodes[(j)].fDistFromLast;;
+				angle *= curSection->readNode(j)->fDistFromLast;;
                 distFromLastNode += angle;
                 if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
                 {
@@ -1304,7 +1334,7 @@ void trackMesh::buildMeshes(int fromNode)
                     {
                         distFromLastNode = 0.f;
                     }
-                    if(rails.size() == 0 || rails.last().node != trackData->getNumPoints(curSection) + j)
+                    if(lastRailNode() != trackData->getNumPoints(curSection) + j)
                     {
                         posList.append(j);
                         secList.append(i);
@@ -1327,7 +1357,7 @@ void trackMesh::buildMeshes(int fromNode)
         }
 
         int jSize = posList.size();
-        rails.reserve(jSize*12);
+        if(!gpuRails) rails.reserve(jSize*12);
         //railshadows.reserve(jSize*12*8);
         //qDebug("Generated Points: %d", jSize);
 
@@ -1344,7 +1374,7 @@ void trackMesh::buildMeshes(int fromNode)
         {
             j = posList[i];
             section* curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
 
             heartlineSize += 1;
 
@@ -1414,6 +1444,7 @@ void trackMesh::buildMeshes(int fromNode)
             options.append(temp);
         }
 
+        createRingTemplate(options);
         createPipes(rails, options);
 
 
@@ -1446,14 +1477,24 @@ void trackMesh::buildMeshes(int fromNode)
 
         // crossties
 
-        int iCrosstie = 0, iCrossShadow = 0;
-        while(crossties.size() > iCrosstie && fromNode > crossties[iCrosstie].node) iCrosstie++; // cycle through crossties until we have something to change
+        int iCrosstie = 0, iCrossShadow = 0, lastTieNode = -1;
+        if(gpuCrossties)
+        {
+            while(tieFrames.size() > iCrosstie && fromNode > (int)tieFrames[iCrosstie].node) iCrosstie++;
+            if(iCrosstie) lastTieNode = (int)tieFrames[iCrosstie-1].node;
+            tieFrames.remove(iCrosstie, tieFrames.size()-iCrosstie);
+        }
+        else
+        {
+            while(crossties.size() > iCrosstie && fromNode > crossties[iCrosstie].node) iCrosstie++; // cycle through crossties until we have something to change
+            if(iCrosstie) lastTieNode = crossties[iCrosstie-1].node;
+            crossties.remove(iCrosstie, crossties.size()-iCrosstie);
+        }
         while(crosstieshadows.size() > iCrossShadow && fromNode > crosstieshadows[iCrossShadow].node) iCrossShadow++;
 
         if(iCrosstie == 0)  distFromLastNode = crosstieSpacing/2.f;
-        else distFromLastNode = trackData->getPoint(fromNode)->fTotalLength - trackData->getPoint(crossties[iCrosstie-1].node)->fTotalLength;
+        else distFromLastNode = trackData->readPoint(fromNode)->fTotalLength - trackData->readPoint(lastTieNode)->fTotalLength;
 
-        crossties.remove(iCrosstie, crossties.size()-iCrosstie);
         crosstieshadows.remove(iCrossShadow, crosstieshadows.size()-iCrossShadow);
 
 
@@ -1463,12 +1504,12 @@ void trackMesh::buildMeshes(int fromNode)
         secList.clear();
 
         j = fromSecI;
-        for(int i = fromSection; i < trackData->lSections.size(); i++)
+        for(int i = fromSection; i < endSection; i++)
         {
             section* curSection = trackData->lSections[i];
             for(; j < curSection->lNodes.size(); ++j)
             {
-				distFromLastNode += curSection->lNodes[(j)].fDistFromLast;
+				distFromLastNode += curSection->readNode(j)->fDistFromLast;
                 if(distFromLastNode >= crosstieSpacing)
                 {
                     distFromLastNode -= crosstieSpacing;
@@ -1510,20 +1551,15 @@ void trackMesh::buildMeshes(int fromNode)
             break;
         }
 
-        if(crossties.size()) curNode = trackData->getPoint(crossties.last().node);
-
-#define XS (0.06f)
-#define S (0.08f)
-#define M (0.10f)
-#define L (0.12f)
-#define XL (0.14f)
-#define XXL (0.16f)
-
-#define BOX_INWARD (0.14f)
-#define BOX_DIAG0 (0.08f)
-#define BOX_DIAG1 (0.18f)
-#define BOX_WIDTH (0.05f)
+        if(gpuCrossties)
+        {
+            // only the tie frames are rebuilt here, their geometry comes from the template
+            createTieTemplate(railSpacing, railWidth, spineHeight, spineSize);
+            offset = tieFrames.size();
+            tieFrames.reserve(offset+jSize);
+        }
 
+        if(lastTieNode >= 0) curNode = trackData->readPoint(lastTieNode);
 
         for(int i = 0; i < jSize; ++i)
         {
@@ -1531,589 +1567,26 @@ void trackMesh::buildMeshes(int fromNode)
             j = posList[i];
             curSection = trackData->lSections[secList[i]];
             lastNode = curNode;
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
             nextNode = trackData->getNumPoints(curSection) + j;
 
-            /* CROSSTIE GENERATION */
-            glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
-            float mysign = fabs(spineHeight)/spineHeight;
-            switch(trackData->style)
+            if(gpuCrossties)
             {
-            case generic:
-                P1 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, -0.15*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, 0.15*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.15*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.15*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);// -0.15*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);// 0.15*spineHeight);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);//, -0.15*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);//, 0.15*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, -0.15*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, 0.15*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart, railSpacing, -0.15*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.15*spineHeight);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case genericflat:
-                if(index%6 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, -M);
-                    P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, M);
-                    P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, -M);
-                    P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, M);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, -M);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, M);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, -M);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, M);
-
-                }
-                else
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -0.03);
-                    P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, 0.03);
-                    P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -0.03);
-                    P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, 0.03);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -0.03);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, 0.03);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -0.03);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, 0.03);
-                }
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                if(index)
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.13, 0.03);
-                    P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.07, 0.03);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.13, 0.03);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.07, 0.03);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.07, -0.03);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.13, -0.03);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.07, -0.03);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.13, -0.03);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            case vekoma:
-                P1 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, +0.05f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-                P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
-
-                createQuad(crossties, P2, P1, P3, P4);
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, +0.05f);
-
-                createQuad(crossties, P2, P1, P3, P4);
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, +0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, +0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, -0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, -0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = P5;
-                P2 = P6;
-                P3 = P7;
-                P4 = P8;
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, -0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, -0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = P5;
-                P2 = P6;
-                P3 = P7;
-                P4 = P8;
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-                P1 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
-                P2 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
-                P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
-                P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case bm:
-                P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, -0.05f*mysign);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, 0.05f*mysign);
-                P3 = curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.05f*mysign);
-                P4 = curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.05f*mysign);
-                P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, -0.05f*mysign);
-                P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, 0.05f*mysign);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-                if(index%6 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, -0.05f*mysign);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, 0.05f*mysign);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, -0.05f*mysign);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, 0.05f*mysign);
-                    P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, -0.05f*mysign);
-                    P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, 0.05f*mysign);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, -0.05f*mysign);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, 0.05f*mysign);
-
-                    createQuad(crossties, P2, P1, P3, P4);
-                    createQuad(crossties, P5, P6, P8, P7);
-                }
-                else
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, -0.05f*mysign);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, 0.05f*mysign);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
-                    P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, -0.05f*mysign);
-                    P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, 0.05f*mysign);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
-                }
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, -0.05f*mysign);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, 0.05f*mysign);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, -0.05f*mysign);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, 0.05f*mysign);
-                P7 = curNode->vRelPos(-trackData->fHeart, railSpacing, -0.05f*mysign);
-                P8 = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.05f*mysign);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case triangle:
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                if(index && index%2)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                else if(index && index%2 == 0)
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-
-                if(index)
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            case box:
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                if(index && index%2)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P2 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                    P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
-                    P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                    P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                else if(index && (index%2 == 0))
-                {
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P2 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P3 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                    P4 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
-            case smallflat:
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, BOX_WIDTH);
-
-                createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                break;
-            case doublespine:
-                if(index%2 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, -0.12*spineHeight);
-                    P2 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, 0.12*spineHeight);
-                    P3 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, -0.12*spineHeight);
-                    P4 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, 0.12*spineHeight);
-                    P5 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, -0.12*spineHeight);
-                    P6 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, 0.12*spineHeight);
-                    P7 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, -0.12*spineHeight);
-                    P8 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, 0.12*spineHeight);
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
-                    P2 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
-                    P3 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
-                    P4 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
-                    P2 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
-                    P5 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
-                    P6 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
-                    P7 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
-                    P8 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                if((index+3)%4 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
-                    P2 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, 0.65*spineSize);
-                    P3 = curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, -0.65*spineSize);
-                    P4 = curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, 0.65*spineSize);
-                    P5 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, -0.65*spineSize);
-                    P6 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, 0.65*spineSize);
-                    P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, -0.65*spineSize);
-                    P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, 0.65*spineSize);
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                if((index+1)%4 == 0)
-                {
-                    P1 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
-                    P2 = P1;
-                    P3 = P1;
-                    P4 = P1;
-                    P5 = P1;
-                    P6 = P1;
-                    P7 = P1;
-                    P8 = P1;
-
-                    createBox(crossties, P1, P2, P3, P4, P5, P6, P7, P8);
-                    createShadowBox(crosstieshadows, P1, P2, P3, P4, P5, P6, P7, P8);
-                }
-                break;
+                tieframe_t frame;
+                frame.pos = curNode->vPos;
+                frame.node = nextNode;
+                frame.normal = curNode->vNorm;
+                frame.latRoll = curNode->fLatRollPerMeter();
+                frame.lat = curNode->vLat;
+                frame.dirRoll = curNode->fDirRollPerMeter();
+                frame.dir = curNode->vDir;
+                frame.padding = 0.f;
+                tieFrames.append(frame);
             }
+            createCrosstie(index, curNode, lastNode, railSpacing, railWidth, spineHeight, spineSize, gpuCrossties ? NULL : &crossties, crosstieshadows);
         }
         mSec = timer.nsecsElapsed()/1000000.;
-        gloParent->showMessage(QString::number(mSec).append(QString("ms used to build meshes")), 3000);
+        buildTime = mSec;
     }
     else // wireframe
     {
@@ -2138,16 +1611,16 @@ void trackMesh::buildMeshes(int fromNode)
         if(i < 0) i = 0;
         if(i == j && j == 0) distFromLastNode = 1.f;
 
-        for(; i < trackData->lSections.size(); i++)
+        for(; i < endSection; i++)
         {
             curSection = trackData->lSections[i];
             for(; j < curSection->lNodes.size(); ++j)
             {
                 if(i != 0 && j == 1) distFromLastNode = 1.f;
-				float angle = curSection->lNodes[(j)].fFlexion();
+				float angle = curSection->readNode(j)->fFlexion();
                 angle /= angleNodeDist;
                 angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-				angle *= curSection->lNodes[(j)].fDistFromLast;;
+				angle *= curSection->readNode(j)->fDistFromLast;;
                 distFromLastNode += angle;
                 if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
                 {
@@ -2191,7 +1664,7 @@ void trackMesh::buildMeshes(int fromNode)
         {
             j = posList[i];
             section* curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
 
             heartlineSize += 1;
 
@@ -2208,7 +1681,7 @@ void trackMesh::buildMeshes(int fromNode)
         {
             j = posList[i];
             curSection = trackData->lSections[secList[i]];
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
 
             nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
             nextNorm = glm::vec3(0, 0.5, 0);
@@ -2257,7 +1730,7 @@ void trackMesh::buildMeshes(int fromNode)
         while(crosstieshadows.size() > iCrossShadow && fromNode > crosstieshadows[iCrossShadow].node) iCrossShadow++;
 
         if(iCrosstie == 0)  distFromLastNode = crosstieSpacing/2.f;
-        else distFromLastNode = trackData->getPoint(fromNode)->fTotalLength - trackData->getPoint(crossties[iCrosstie-1].node)->fTotalLength;
+        else distFromLastNode = trackData->readPoint(fromNode)->fTotalLength - trackData->readPoint(crossties[iCrosstie-1].node)->fTotalLength;
 
         crossties.remove(iCrosstie, crossties.size()-iCrosstie);
         crosstieshadows.remove(iCrossShadow, crosstieshadows.size()-iCrossShadow);
@@ -2269,12 +1742,12 @@ void trackMesh::buildMeshes(int fromNode)
         secList.clear();
 
         j = fromSecI;
-        for(int i = fromSection; i < trackData->lSections.size(); i++)
+        for(int i = fromSection; i < endSection; i++)
         {
             section* curSection = trackData->lSections[i];
             for(; j < curSection->lNodes.size(); ++j)
             {
-				distFromLastNode += curSection->lNodes[(j)].fDistFromLast;
+				distFromLastNode += curSection->readNode(j)->fDistFromLast;
                 if(distFromLastNode >= crosstieSpacing)
                 {
                     distFromLastNode -= crosstieSpacing;
@@ -2314,7 +1787,7 @@ void trackMesh::buildMeshes(int fromNode)
             break;
         }
 
-        if(crossties.size()) curNode = trackData->getPoint(crossties.last().node);
+        if(crossties.size()) curNode = trackData->readPoint(crossties.last().node);
 
         for(int i = 0; i < posList.size(); ++i)
         {
@@ -2322,7 +1795,7 @@ void trackMesh::buildMeshes(int fromNode)
             j = posList[i];
             curSection = trackData->lSections[secList[i]];
             lastNode = curNode;
-			curNode = &curSection->lNodes[j];
+			curNode = curSection->readNode(j);
 
             nextPos = curNode->vRelPos(-trackData->fHeart, -railSpacing);
             nextNorm = glm::vec3(0, 0.5, 0);
@@ -2555,860 +2028,876 @@ void trackMesh::buildMeshes(int fromNode)
         }
     }
     createIndices();
-    updateVertexArrays();
     return;
 }
 
-void trackMesh::build3ds(const int _sec, QVector<float> *_vertices, QVector<unsigned int> *_indices, QVector<unsigned int> *_borders)
-{
-    posList.clear();
-    secList.clear();
+#define XS (0.06f)
+#define S (0.08f)
+#define M (0.10f)
+#define L (0.12f)
+#define XL (0.14f)
+#define XXL (0.16f)
 
-    _borders->append(_vertices->size());
-    _borders->append(_indices->size());
+#define BOX_INWARD (0.14f)
+#define BOX_DIAG0 (0.08f)
+#define BOX_DIAG1 (0.18f)
+#define BOX_WIDTH (0.05f)
 
-    float crosstieSpacing = 0.f;
-    float meshQuality;
-    switch(gloParent->mOptions->meshQuality)
+
+void trackMesh::createCrosstie(int index, mnode* tieNode, mnode* lastNode, float railSpacing, float railWidth, float spineHeight, float spineSize, QVector<tracknode_t>* list, QVector<meshnode_t> &shadows)
+{
+    glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
+    float mysign = fabs(spineHeight)/spineHeight;
+    switch(trackData->style)
     {
-    case 0:
-        meshQuality = 1;
+    case generic:
+        P1 = tieNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, -0.15*spineHeight);
+        P2 = tieNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, 0.15*spineHeight);
+        P3 = tieNode->vRelPos(-trackData->fHeart, -railSpacing, -0.15*spineHeight);
+        P4 = tieNode->vRelPos(-trackData->fHeart, -railSpacing, 0.15*spineHeight);
+        P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
+        P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);// -0.15*spineHeight);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);// 0.15*spineHeight);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
+        P2 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
+        P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);//, -0.15*spineHeight);
+        P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);//, 0.15*spineHeight);
+        P5 = tieNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, -0.15*spineHeight);
+        P6 = tieNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, 0.15*spineHeight);
+        P7 = tieNode->vRelPos(-trackData->fHeart, railSpacing, -0.15*spineHeight);
+        P8 = tieNode->vRelPos(-trackData->fHeart, railSpacing, 0.15*spineHeight);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
         break;
-    case 1:
-        meshQuality = 2;
+    case genericflat:
+        if(index%6 == 0)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, -M);
+            P2 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, M);
+            P3 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, -M);
+            P4 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, M);
+            P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, -M);
+            P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, M);
+            P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, -M);
+            P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, M);
+
+        }
+        else
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -0.03);
+            P2 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, 0.03);
+            P3 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -0.03);
+            P4 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, 0.03);
+            P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -0.03);
+            P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, 0.03);
+            P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -0.03);
+            P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, 0.03);
+        }
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        if(index)
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.13, 0.03);
+            P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.07, 0.03);
+            P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.13, 0.03);
+            P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.07, 0.03);
+            P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.07, -0.03);
+            P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.13, -0.03);
+            P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.07, -0.03);
+            P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.13, -0.03);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
         break;
-    case 2:
-        meshQuality = 4;
+    case vekoma:
+        P1 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
+        P2 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
+        P3 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
+        P4 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, -0.05f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, +0.05f);
+        P7 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
+        P8 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
+        P2 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
+        P3 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
+        P4 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
+        P5 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
+        P6 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, -0.05f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, +0.05f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+
+        P1 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
+        P2 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
+        P3 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, -0.05f);
+        P4 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, +0.05f);
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, -0.05f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, +0.05f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
+
+        if(list) createQuad(*list, P2, P1, P3, P4);
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, -0.05f);
+        P2 = tieNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, +0.05f);
+        P3 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
+        P4 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, -0.05f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, +0.05f);
+
+        if(list) createQuad(*list, P2, P1, P3, P4);
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, -0.05f);
+        P2 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, +0.05f);
+        P3 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
+        P4 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, -0.05f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, +0.05f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
+        P2 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
+        P3 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
+        P4 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, -0.07f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, +0.07f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, -0.07f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, +0.07f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = P5;
+        P2 = P6;
+        P3 = P7;
+        P4 = P8;
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, -0.07f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, +0.07f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, -0.07f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, +0.07f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = P5;
+        P2 = P6;
+        P3 = P7;
+        P4 = P8;
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
+        P2 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
+        P3 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
+        P4 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
+        P5 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
+        P6 = tieNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
+        P7 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
+        P8 = tieNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
         break;
-    case 3:
-        meshQuality = 6;
-        break;
-    }
+    case bm:
+        P1 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, -0.05f*mysign);
+        P2 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, 0.05f*mysign);
+        P3 = tieNode->vRelPos(-trackData->fHeart, -railSpacing, -0.05f*mysign);
+        P4 = tieNode->vRelPos(-trackData->fHeart, -railSpacing, 0.05f*mysign);
+        P5 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, -0.05f*mysign);
+        P6 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, 0.05f*mysign);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
 
-    float minNodeDist = 12.f/(meshQuality), maxNodeDist = 0.3f/(meshQuality);    // minimal and maximal distance between nodes
-    float angleNodeDist = 6.f/(meshQuality);                     // after x degrees difference force a new node
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
 
-    float railSpacing = 0.f;
-    float distFromLastNode = 0.f;
-    float spineHeight = (trackData->fHeart < 0 ? -1.f : 1.f);
-    float spineSize = 0.06f;
 
-    float railWidth = 0.065f;
+        if(index%6 == 0)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, -0.05f*mysign);
+            P2 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, 0.05f*mysign);
+            P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, -0.05f*mysign);
+            P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, 0.05f*mysign);
+            P5 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, -0.05f*mysign);
+            P6 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, 0.05f*mysign);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, -0.05f*mysign);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, 0.05f*mysign);
+
+            if(list) createQuad(*list, P2, P1, P3, P4);
+            if(list) createQuad(*list, P5, P6, P8, P7);
+        }
+        else
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, -0.05f*mysign);
+            P2 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, 0.05f*mysign);
+            P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f*mysign);
+            P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f*mysign);
+            P5 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, -0.05f*mysign);
+            P6 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, 0.05f*mysign);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
+        }
 
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
 
-    mnode *lastNode = NULL;
-    curNode = NULL;
+        P1 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, -0.05f*mysign);
+        P2 = tieNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, 0.05f*mysign);
+        P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f*mysign);
+        P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f*mysign);
+        P5 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, -0.05f*mysign);
+        P6 = tieNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, 0.05f*mysign);
+        P7 = tieNode->vRelPos(-trackData->fHeart, railSpacing, -0.05f*mysign);
+        P8 = tieNode->vRelPos(-trackData->fHeart, railSpacing, 0.05f*mysign);
 
-    switch(trackData->style)
-    {
-    case generic:
-        numRails = 3;
-        railSpacing = 0.5f;
-        crosstieSpacing = 1.5f;
-        spineHeight = 0.30f * (trackData->fHeart < 0 ? -1.f : 1.f);
-        spineSize = 0.22f; // used to be 0.18f
-        break;
-    case genericflat:
-        numRails = 2;
-        railSpacing = 0.7f;
-        crosstieSpacing = 1.4f;
-        break;
-    case vekoma:
-        numRails = 3;
-        railSpacing = 0.60;
-        crosstieSpacing = 1.5f;
-        spineHeight = 0.85f * (trackData->fHeart < 0 ? -1.f : 1.f);
-        spineSize = 0.22f;
-        break;
-    case bm:
-        numRails = 3;
-        railSpacing = 0.6f;
-        crosstieSpacing = 1.45f;
-        spineHeight = 0.5f * (trackData->fHeart < 0 ? -1.f : 1.f);
-        spineSize = 0.26f*1.4101f;
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
         break;
     case triangle:
-        numRails = 3;
-        railSpacing = 0.5f;
-        crosstieSpacing = 1.0f;
-        spineSize = railWidth;
-        spineHeight = 0.75f * (trackData->fHeart < 0 ? -1.f : 1.f);
+        P1 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        if(index && index%2)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        else if(index && index%2 == 0)
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+
+        if(index)
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
         break;
     case box:
-        numRails = 4;
-        railSpacing = 0.5f;
-        crosstieSpacing = 1.0f;
-        spineSize = railWidth;
-        spineHeight = 1.f * (trackData->fHeart < 0 ? -1.f : 1.f);
+        P1 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+        if(index && index%2)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P2 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P3 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P4 = tieNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P2 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P3 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P4 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P2 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
+            P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
+            P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
+            P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
+            P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        else if(index && (index%2 == 0))
+        {
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P2 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P3 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
+            P4 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
         break;
     case smallflat:
-        numRails = 2;
-        railSpacing = 0.5f;
-        crosstieSpacing = 0.8f;
+        P1 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -BOX_WIDTH);
+        P2 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, BOX_WIDTH);
+        P3 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -BOX_WIDTH);
+        P4 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, BOX_WIDTH);
+        P5 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -BOX_WIDTH);
+        P6 = tieNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, BOX_WIDTH);
+        P7 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -BOX_WIDTH);
+        P8 = tieNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, BOX_WIDTH);
+
+        if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+        createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
         break;
     case doublespine:
-        numRails = 4;
-        railSpacing = 0.5f;
-        crosstieSpacing = 0.3f;
-        spineHeight = 0.3f * (trackData->fHeart < 0 ? -1.f : 1.f);
-        spineSize = 0.18f;
+        if(index%2 == 0)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, -0.12*spineHeight);
+            P2 = tieNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, 0.12*spineHeight);
+            P3 = tieNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, -0.12*spineHeight);
+            P4 = tieNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, 0.12*spineHeight);
+            P5 = tieNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, -0.12*spineHeight);
+            P6 = tieNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, 0.12*spineHeight);
+            P7 = tieNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, -0.12*spineHeight);
+            P8 = tieNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, 0.12*spineHeight);
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = tieNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
+            P2 = tieNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
+            P3 = tieNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
+            P4 = tieNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+
+            P1 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
+            P2 = tieNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
+            P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
+            P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
+            P5 = tieNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
+            P6 = tieNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
+            P7 = tieNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
+            P8 = tieNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        if((index+3)%4 == 0)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
+            P2 = tieNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, 0.65*spineSize);
+            P3 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, -0.65*spineSize);
+            P4 = tieNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, 0.65*spineSize);
+            P5 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, -0.65*spineSize);
+            P6 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, 0.65*spineSize);
+            P7 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, -0.65*spineSize);
+            P8 = tieNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, 0.65*spineSize);
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
+        if((index+1)%4 == 0)
+        {
+            P1 = tieNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
+            P2 = P1;
+            P3 = P1;
+            P4 = P1;
+            P5 = P1;
+            P6 = P1;
+            P7 = P1;
+            P8 = P1;
+
+            if(list) createBox(*list, P1, P2, P3, P4, P5, P6, P7, P8);
+            createShadowBox(shadows, P1, P2, P3, P4, P5, P6, P7, P8);
+        }
         break;
     }
+}
 
-
-    curSection = trackData->lSections[_sec];
-    for(j = 0; j < curSection->lNodes.size(); ++j)
+int trackMesh::crosstiePeriod()
+{
+    // crossties repeat after this many ties, see the index checks in createCrosstie()
+    switch(trackData->style)
     {
-        if(j == 0) distFromLastNode = 1.f;
-		float angle = curSection->lNodes[(j)].fFlexion();
-        angle /= angleNodeDist;
-        angle = std::min(std::max(1.f/minNodeDist, angle), 1.f/maxNodeDist);
-		angle *= curSection->lNodes[(j)].fDistFromLast;;
-        distFromLastNode += angle;
-        if(distFromLastNode >= 1.f || j == curSection->lNodes.size()-1)
+    case genericflat:
+    case bm:
+        return 6;
+    case doublespine:
+        return 4;
+    case triangle:
+    case box:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+void trackMesh::createTieTemplate(float railSpacing, float railWidth, float spineHeight, float spineSize)
+{
+    // probe nodes with an unrolled identity frame, vRelPos(y, x, z) on them returns (x, y, z)
+    // the previous tie sits far behind the current one so both can be told apart afterwards
+    const float probeDist = 100.f;
+    mnode probe[2];
+    for(int i = 0; i < 2; ++i)
+    {
+        probe[i].vPos = glm::vec3(0.f, 0.f, i ? -probeDist : 0.f);
+        probe[i].vDir = glm::vec3(0.f, 0.f, 1.f);
+        probe[i].vLat = glm::vec3(1.f, 0.f, 0.f);
+        probe[i].vNorm = glm::vec3(0.f, -1.f, 0.f);
+        probe[i].fVel = 0.f;
+        probe[i].fRollSpeed = 0.f;
+        probe[i].fSmoothSpeed = 0.f;
+        probe[i].fDistFromLast = 0.f;
+        probe[i].fHeartDistFromLast = 0.f;
+        probe[i].fAngleFromLast = 0.f;
+    }
+
+    QVector<tracknode_t> probeMesh;
+    QVector<meshnode_t> probeShadows;
+    int period = crosstiePeriod();
+
+    tieTemplate.clear();
+    tieBlockOffsets.clear();
+    tieRadius = 0.f;
+
+    // the first tie has no predecessor, the block after it repeats for the rest of the track
+    for(int tie = 0; tie <= period; ++tie)
+    {
+        if(tie) tieBlockOffsets.append(tieTemplate.size());
+        probeMesh.clear();
+        createCrosstie(tie, &probe[0], &probe[1], railSpacing, railWidth, spineHeight, spineSize, &probeMesh, probeShadows);
+
+        // createQuad() emits the triangles P1 P2 P4 and P2 P3 P4
+        for(int i = 0; i+5 < probeMesh.size(); i += 6)
         {
-            if(distFromLastNode >= 1.f)
+            glm::vec3 quad[4] = {probeMesh[i].pos, probeMesh[i+1].pos, probeMesh[i+4].pos, probeMesh[i+2].pos};
+            const int corners[6] = {0, 1, 3, 1, 2, 3};
+
+            tievertex_t temp;
+            for(int k = 0; k < 4; ++k)
             {
-                distFromLastNode -= 1.f;
+                bool isLast = quad[k].z < -probeDist/2.f;
+                temp.corners[k] = glm::vec4(quad[k].y, quad[k].x, isLast ? quad[k].z+probeDist : quad[k].z, isLast ? 1.f : 0.f);
+                tieRadius = std::max(tieRadius, glm::length(glm::vec3(temp.corners[k])));
             }
-            else
+            temp.tie = tie ? tie-1 : 0;
+            temp.padding = 0.f;
+            for(int k = 0; k < 6; ++k)
             {
-                distFromLastNode = 0.f;
+                temp.corner = corners[k];
+                temp.triangle = k/3;
+                tieTemplate.append(temp);
             }
-            posList.append(j);
-            secList.append(_sec);
         }
     }
+    tieBlockOffsets.append(tieTemplate.size());
+}
 
+int trackMesh::crosstieVertexCount(int ties)
+{
+    if(ties <= 0 || tieBlockOffsets.isEmpty()) return 0;
+    int period = tieBlockOffsets.size()-1;
+    int blockSize = tieBlockOffsets.last()-tieBlockOffsets.first();
+    return (ties-1)/period*blockSize + tieBlockOffsets[(ties-1)%period];
+}
 
-    int jSize = posList.size();
+namespace {
+class exportTask : public QRunnable
+{
+public:
+    exportTask(std::function<void()> _task) : task(_task) {}
+    void run() { task(); }
+private:
+    std::function<void()> task;
+};
+}
 
-    options.clear();
-    pipeoption_t temp;
-    temp.edges = 6;
-    temp.offset = glm::vec2(-railSpacing, -trackData->fHeart);
-    temp.radius = glm::vec2(railWidth, railWidth);
-    temp.smooth = true;
-    options.append(temp);
-    temp.offset.x *= -1;
-    options.append(temp);
+void trackMesh::exportChunk(int c, const tracknode_t* railData, const tracknode_t* tieData, meshgroup_t &group)
+{
+    group.name = QString::number(c);
+    group.vertices.clear();
+    group.triangles.clear();
 
-    switch(trackData->style)
+    // full detail strips of every pipe, turned into triangles without the degenerate ones
+    QHash<int, unsigned int> local;
+    for(int p = 0; p < lodStrips; ++p)
     {
-    case bm:
-        temp.edges=4;
-        temp.offset.x = 0;
-        temp.offset.y = -trackData->fHeart-spineHeight;
-        temp.radius.x = spineSize;
-        temp.radius.y = spineSize;
-        options.append(temp);
-        //createPipe(rails, 4, spineSize*1.2, spineSize, -trackData->fHeart-spineHeight, 0, false);
-        //createPipe(rails, 4, 0, 0, -trackData->fHeart-spineHeight, 0, false);
-        //createPipe(rails, 4, 0, 0, -trackData->fHeart-spineHeight, 0, false);
-        break;
-    case generic:
-    case vekoma:
-        temp.edges = 12;
-    case triangle:
-        temp.offset.x = 0;
-        temp.offset.y = -trackData->fHeart-spineHeight;
-        temp.radius.x = spineSize;
-        temp.radius.y = spineSize;
-        options.append(temp);
-        //createPipe(rails, 12, spineSize, spineSize, -trackData->fHeart-spineHeight, 0);
-        break;
-    case box:
-        temp.offset.x = -railSpacing;
-        temp.offset.y = -trackData->fHeart-spineHeight;
-        temp.radius.x = spineSize;
-        temp.radius.y = spineSize;
-        options.append(temp);
-        temp.offset.x = railSpacing;
-        options.append(temp);
-        //createPipe(rails, 12, spineSize, spineSize, -trackData->fHeart-spineHeight, -railSpacing);
-        //createPipe(rails, 12, spineSize, spineSize, -trackData->fHeart-spineHeight, railSpacing);
-        break;
-    case genericflat:
-    case smallflat:
-        break;
-    case doublespine:
-        temp.edges = 12;
-        temp.offset.x = 0;
-        temp.offset.y = -trackData->fHeart-spineHeight;
-        temp.radius.x = spineSize;
-        temp.radius.y = spineSize;
-        options.append(temp);
-        temp.offset.y = -trackData->fHeart-0.45f-spineHeight;
-        options.append(temp);
+        int k = c*LOD_LEVELS*lodStrips + p;
+        for(int i = lodBorders[k]+2; i < lodBorders[k+1]; ++i)
+        {
+            int a = pipeIndices[i-2], b = pipeIndices[i-1], d = pipeIndices[i];
+            if(a == b || b == d || a == d) continue;
+            if((i-lodBorders[k])%2) qSwap(a, b);
+            int corners[3] = {a, b, d};
+            for(int v = 0; v < 3; ++v)
+            {
+                QHash<int, unsigned int>::iterator it = local.find(corners[v]);
+                if(it == local.end())
+                {
+                    it = local.insert(corners[v], group.vertices.size());
+                    group.vertices.append(railData+corners[v]);
+                }
+                group.triangles.append(it.value());
+            }
+        }
     }
 
-    create3dsPipes(_vertices, options);
+    for(int i = crosstieBorders[c]; i+2 < crosstieBorders[c+1]; i += 3)
+    {
+        for(int v = 0; v < 3; ++v)
+        {
+            group.triangles.append(group.vertices.size());
+            group.vertices.append(tieData+i+v);
+        }
+    }
+}
 
+void trackMesh::exportSupports(int first, int last, meshgroup_t &group)
+{
+    group.name = QString("supports%1").arg(first/EXPORT_SUPPORTS);
+    group.vertices.clear();
+    group.triangles.clear();
 
-    int edgeCount = 0;
-    for(int i = 0; i < options.size(); ++i) edgeCount += options[i].edges;
+    // every support is a strip of 61 vertices, the caps repeat positions and give empty triangles
+    for(int s = first; s < last; ++s)
+    {
+        unsigned int base = group.vertices.size();
+        const tracknode_t* strip = rendersupports.constData()+61*s;
+        for(int i = 0; i < 61; ++i)
+        {
+            group.vertices.append(strip+i);
+        }
+        for(int i = 2; i < 61; ++i)
+        {
+            unsigned int a = i-2, b = i-1, d = i;
+            if(strip[a].pos == strip[b].pos || strip[b].pos == strip[d].pos || strip[a].pos == strip[d].pos) continue;
+            if(i%2) qSwap(a, b);
+            group.triangles.append(base+a);
+            group.triangles.append(base+b);
+            group.triangles.append(base+d);
+        }
+    }
+}
 
-    QList<int> renderList;
-    for(int i = 0; i < posList.size(); ++i)
+bool trackMesh::exportMesh(meshSink* _sink)
+{
+    if(listsReleased)
     {
-        renderList.append(i);
+        glView->makeCurrent();
+        buildMeshes(0);
     }
-    int nodeCount = posList.size();
+    if(isWireframe || nodeList.isEmpty()) return false;
 
-    QList<int> points;
-    int vBorder = 0;
+    // rails and crossties built on the GPU are read back from the mapped buffers
+    const tracknode_t* railData = rails.constData();
+    const tracknode_t* tieData = crossties.constData();
+    if(gpuRails || gpuCrossties) glView->makeCurrent();
+    if(gpuRails)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[0]);
+        railData = (const tracknode_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, railVertexCount()*sizeof(tracknode_t), GL_MAP_READ_BIT);
+    }
+    if(gpuCrossties)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[3]);
+        tieData = (const tracknode_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, crosstieVertexCount(tieFrames.size())*sizeof(tracknode_t), GL_MAP_READ_BIT);
+    }
 
-    for(int p = 0; p < options.size(); ++p)
+    bool ok = (railData != NULL || rails.isEmpty()) && (tieData != NULL || crossties.isEmpty());
+    int numSupports = std::min(supportsSize, (int)rendersupports.size()/61);
+    int supportGroups = (numSupports+EXPORT_SUPPORTS-1)/EXPORT_SUPPORTS;
+    // every task gets the one group it fills or writes, the vector is not resized while the tasks run
+    // and the pool is declared after it, so its destructor waits for the tasks before the groups go away
+    QVector<meshgroup_t> groups(numChunks+supportGroups);
+    meshgroup_t* groupData = groups.data();
+    QThreadPool pool;
+    if(ok)
     {
-        points.clear();
-        int offset = 0;
-        int edgeCnt = options[p].edges;
-        vBorder += edgeCnt*nodeCount+2;
-        for(int i = 0; i < p; ++i)
+        for(int c = 0; c < numChunks; ++c)
         {
-            offset += options[i].edges*nodeCount+2;
+            meshgroup_t* group = groupData+c;
+            pool.start(new exportTask([this, c, railData, tieData, group]() { exportChunk(c, railData, tieData, *group); }));
         }
-        points.append(offset);
-        for(int e = 0; e < edgeCnt; e+=2)
+        for(int s = 0; s < supportGroups; ++s)
         {
-            int e2 = (e+1)%edgeCnt;
-            int e3 = (e+2)%edgeCnt;
-            int i;
-            for(i = 0; i < nodeCount; ++i)
-            {
-                points.append(offset + 1 + i*edgeCnt + e);
-                points.append(offset + 1 + i*edgeCnt + e2);
-            }
-            points.append(offset + 1 + i*edgeCnt);
-            for(i = nodeCount-1; i >= 0; --i)
-            {
-                points.append(offset + 1 + i*edgeCnt + e2);
-                points.append(offset + 1 + i*edgeCnt + e3);
-            }
-            points.append(offset);
+            int first = s*EXPORT_SUPPORTS, last = std::min(first+EXPORT_SUPPORTS, numSupports);
+            meshgroup_t* group = groupData+numChunks+s;
+            pool.start(new exportTask([this, first, last, group]() { exportSupports(first, last, *group); }));
         }
+        pool.waitForDone();
 
-        for(int i = 0; i < points.size()-2; ++i)
+        ok = _sink->begin(groups);
+    }
+    if(ok && _sink->sequential())
+    {
+        for(int c = 0; c < groups.size(); ++c)
         {
-            if(i%2)
-            {
-                _indices->append(points[i]);
-                _indices->append(points[i+1]);
-                _indices->append(points[i+2]);
-            }
-            else
-            {
-                _indices->append(points[i]);
-                _indices->append(points[i+2]);
-                _indices->append(points[i+1]);
-            }
+            _sink->writeGroup(c, groups[c]);
         }
-        _borders->append(vBorder*3);
-        _borders->append(_indices->size());
     }
-
-    // crossties
-
-    curNode = NULL;
-
-    posList.clear();
-    secList.clear();
-
-
-    curSection = trackData->lSections[_sec];
-    for(j=0; j < curSection->lNodes.size(); ++j)
+    else if(ok)
     {
-		distFromLastNode += curSection->lNodes[(j)].fDistFromLast;
-        if(distFromLastNode >= crosstieSpacing)
+        for(int c = 0; c < groups.size(); ++c)
         {
-            distFromLastNode -= crosstieSpacing;
-            posList.append(j);
-            secList.append(_sec);
+            const meshgroup_t* group = groupData+c;
+            pool.start(new exportTask([_sink, c, group]() { _sink->writeGroup(c, *group); }));
         }
+        pool.waitForDone();
     }
 
-
-    jSize = posList.size();
-
-#define XS (0.06f)
-#define S (0.08f)
-#define M (0.10f)
-#define L (0.12f)
-#define XL (0.14f)
-#define XXL (0.16f)
-
-#define BOX_INWARD (0.14f)
-#define BOX_DIAG0 (0.08f)
-#define BOX_DIAG1 (0.18f)
-#define BOX_WIDTH (0.05f)
-
-
-    for(int i = 0; i < jSize; ++i)
+    if(gpuRails)
     {
-        int index = i;
-        j = posList[i];
-        curSection = trackData->lSections[secList[i]];
-        lastNode = curNode;
-		curNode = &curSection->lNodes[j];
-        nextNode = trackData->getNumPoints(curSection) + j;
-
-        glm::vec3 P1, P2, P3, P4, P5, P6, P7, P8;
-        float mysign = fabs(spineHeight)/spineHeight;
-        switch(trackData->style)
-        {
-        case generic:
-            P1 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, -0.15*spineHeight);
-            P2 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, -railSpacing, 0.15*spineHeight);
-            P3 = curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.15*spineHeight);
-            P4 = curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.15*spineHeight);
-            P5 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
-            P6 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);// -0.15*spineHeight);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);// 0.15*spineHeight);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, -0.15f);//-0.35*spineHeight);
-            P2 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.15, 0, 0.15f);//0.35*spineHeight);
-            P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.15f);//, -0.15*spineHeight);
-            P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.15f);//, 0.15*spineHeight);
-            P5 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, -0.15*spineHeight);
-            P6 = curNode->vRelPos(-trackData->fHeart+0.1*railWidth*mysign, railSpacing, 0.15*spineHeight);
-            P7 = curNode->vRelPos(-trackData->fHeart, railSpacing, -0.15*spineHeight);
-            P8 = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.15*spineHeight);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            break;
-        case genericflat:
-            if(index%6 == 0)
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, -M);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), -railSpacing, M);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, -M);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), -railSpacing, M);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, -M);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.8 : 1.0), railSpacing, M);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, -M);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1.0 : 0.8), railSpacing, M);
-
-            }
-            else
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -0.03);
-                P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, 0.03);
-                P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -0.03);
-                P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, 0.03);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -0.03);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, 0.03);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -0.03);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, 0.03);
-            }
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            if(index)
-            {
-                P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.13, 0.03);
-                P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing+0.07, 0.03);
-                P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.13, 0.03);
-                P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing+0.07, 0.03);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.07, -0.03);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing-0.13, -0.03);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.07, -0.03);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing-0.13, -0.03);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            break;
-        case vekoma:
-            P1 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing-0.5*railWidth, +0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.2*railSpacing, +0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, railSpacing+0.5*railWidth, +0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.2*railSpacing, +0.05f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-            P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -1.2*railSpacing, +0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, -1.3*railSpacing, +0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.2*railSpacing, +0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
-
-            create3dsQuad(_vertices, _indices, P2, P1, P3, P4);
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart-0.7*railWidth*mysign, 1.3*railSpacing, +0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, 1.2*railSpacing, +0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.2*railSpacing, +0.05f);
-
-            create3dsQuad(_vertices, _indices, P2, P1, P3, P4);
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, -1.3*railSpacing, +0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, -1.3*railSpacing, +0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.45*mysign, 1.3*railSpacing, +0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.55*mysign, 1.3*railSpacing, +0.05f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
-            P2 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
-            P3 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
-            P4 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
-            P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, -0.07f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -1.1*spineSize, +0.07f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, -0.07f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), -1.1*spineSize, +0.07f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = P5;
-            P2 = P6;
-            P3 = P7;
-            P4 = P8;
-            P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, -0.07f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 1.1*spineSize, +0.07f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, -0.07f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.9*spineHeight-0.5*mysign*(spineSize-0.05), 1.1*spineSize, +0.07f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = P5;
-            P2 = P6;
-            P3 = P7;
-            P4 = P8;
-            P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-
-            P1 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, -0.07f);
-            P2 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, -0.07f);
-            P3 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, -0.07f);
-            P4 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, -0.07f);
-            P5 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, 0.9*railSpacing, +0.07f);
-            P6 = curNode->vRelPos(-trackData->fHeart-0.48f*mysign, -0.9*railSpacing, +0.07f);
-            P7 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, 0.9*railSpacing, +0.07f);
-            P8 = curNode->vRelPos(-trackData->fHeart-0.58f*mysign, -0.9*railSpacing, +0.07f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            break;
-        case bm:
-            P1 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, -railSpacing, 0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart, -railSpacing, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart, -railSpacing, 0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.3*spineSize, 0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            if(index%6 == 0)
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize*1.3, 0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, -0.71*spineSize*1.3, 0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize*1.3, 0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-1.3*0.71*spineSize*mysign, 0.71*spineSize*1.3, 0.05f);
-
-                create3dsQuad(_vertices, _indices, P2, P1, P3, P4);
-                create3dsQuad(_vertices, _indices, P5, P6, P8, P7);
-            }
-            else
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, -0.05f);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, -0.71*spineSize, 0.05f);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, -0.05f);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, -0.71*spineSize, 0.05f);
-                P5 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, -0.05f);
-                P6 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.71*spineSize, 0.05f);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f);
-            }
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, -0.05f);
-            P2 = curNode->vRelPos(-trackData->fHeart-mysign*0.1f, 0.3*spineSize, 0.05f);
-            P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, -0.05f);
-            P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+0.25*0.71*spineSize*mysign, 0.71*spineSize, 0.05f);
-            P5 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, -0.05f);
-            P6 = curNode->vRelPos(-trackData->fHeart+0.5*railWidth*mysign, railSpacing, 0.05f);
-            P7 = curNode->vRelPos(-trackData->fHeart, railSpacing, -0.05f);
-            P8 = curNode->vRelPos(-trackData->fHeart, railSpacing, 0.05f);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            break;
-        case triangle:
-            P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            if(index && index%2)
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            else if(index && index%2 == 0)
-            {
-                P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(-railSpacing+BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), -BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD+railWidth/2), BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), -BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.8, mysign*(railSpacing-BOX_INWARD-railWidth/2), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight, mysign*railWidth/2, BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight, -mysign*railWidth/2, BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-
-            if(index)
-            {
-                P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            break;
-        case box:
-            P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), -railSpacing, BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), -railSpacing, BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.6 : 0.8), railSpacing, BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.8 : 0.6), railSpacing, BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.7), BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.7), BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-            if(index && index%2)
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                P5 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                P6 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
-                P7 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                P8 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, -BOX_WIDTH);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, -BOX_WIDTH);
-                P5 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                P6 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, BOX_WIDTH);
-                P7 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, BOX_WIDTH);
-                P8 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            else if(index && (index%2 == 0))
-            {
-                P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD-railWidth*0.5), BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight+mysign*railWidth*0.6, -mysign*(-railSpacing+BOX_INWARD+railWidth*0.5), BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                P2 = lastNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                P3 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG1, BOX_WIDTH);
-                P4 = lastNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), -railSpacing+BOX_DIAG0, BOX_WIDTH);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight+railWidth*(mysign < 0 ? 0.4 : 0.6), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG0, -BOX_WIDTH);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-railWidth*(mysign < 0 ? 0.6 : 0.4), railSpacing-BOX_DIAG1, -BOX_WIDTH);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            break;
-        case smallflat:
-            P1 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, -BOX_WIDTH);
-            P2 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), -railSpacing, BOX_WIDTH);
-            P3 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, -BOX_WIDTH);
-            P4 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), -railSpacing, BOX_WIDTH);
-            P5 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, -BOX_WIDTH);
-            P6 = curNode->vRelPos(-trackData->fHeart+railWidth*(mysign > 0 ? 0.5 : 1), railSpacing, BOX_WIDTH);
-            P7 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, -BOX_WIDTH);
-            P8 = curNode->vRelPos(-trackData->fHeart-railWidth*(mysign > 0 ? 1 : 0.5), railSpacing, BOX_WIDTH);
-
-            create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            break;
-        case doublespine:
-            if(index%2 == 0)
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, -0.12*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, -railSpacing, 0.12*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, -0.12*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, -railSpacing, 0.12*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, -0.12*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.75*railWidth*mysign, railSpacing, 0.12*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, -0.12*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.25*railWidth*mysign, railSpacing, 0.12*spineHeight);
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, -0.10*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, -0.80*railSpacing, 0.10*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, -0.20*spineHeight);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight*0.7, 0, 0.20*spineHeight);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, -0.10*spineHeight);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.9*spineSize*mysign, 0, 0.10*spineHeight);
-                P5 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
-                P6 = curNode->vRelPos(-trackData->fHeart+0.7*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
-                P7 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, -0.10*spineHeight);
-                P8 = curNode->vRelPos(-trackData->fHeart-0.2*railWidth*mysign, 0.80*railSpacing, 0.10*spineHeight);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            if((index+3)%4 == 0)
-            {
-                P1 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, -0.65*spineSize);
-                P2 = curNode->vRelPos(-trackData->fHeart-spineHeight, 0.65*spineSize, 0.65*spineSize);
-                P3 = curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, -0.65*spineSize);
-                P4 = curNode->vRelPos(-trackData->fHeart-spineHeight, -0.65*spineSize, 0.65*spineSize);
-                P5 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, -0.65*spineSize);
-                P6 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, 0.65*spineSize, 0.65*spineSize);
-                P7 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, -0.65*spineSize);
-                P8 = curNode->vRelPos(-trackData->fHeart-spineHeight-0.4, -0.65*spineSize, 0.65*spineSize);
-
-                create3dsBox(_vertices, _indices, P1, P2, P3, P4, P5, P6, P7, P8);
-            }
-            break;
-        }
-        if( index%5 == 4 && i != jSize-1 ) {
-            _borders->append(_vertices->size());
-            _borders->append(_indices->size());
-        }
+        glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[0]);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    if(gpuCrossties)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[3]);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
     }
-    _borders->append(_vertices->size());
-    _borders->append(_indices->size());
+    if(gpuRails || gpuCrossties) glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    return;
+    return ok && _sink->end();
 }
 
-void trackMesh::recolorTrack()
+void trackMesh::updateSelection()
 {
-    if(trackData->lSections.size() == 0) return;
-
-    for(int i = 0; i < rails.size(); ++i)
-    {       
-        int node = rails[i].node;
-        int section;
-        trackData->getSecNode(node, &node, &section);
+    selection = glm::ivec4(0, -1, 0, -1);
+    if(trackData != gloParent->curTrack() || trackData->activeSection == NULL) return;
 
-        curSection = trackData->lSections[section];
+    section* active = trackData->activeSection;
+    int first = trackData->getNumPoints(active);
 
-        rails[i].selected = (trackData == gloParent->curTrack() && curSection == trackData->activeSection) ? (curSection->isInFunction(node, gloParent->selectedFunc) ? 2.f : 1.f) : 0.f;
-    }
+    // getSecNode() assigns the first node of every section but the first one to its predecessor
+    int from = trackData->lSections.size() && trackData->lSections[0] == active ? 0 : 1;
+    int to = active->lNodes.size()-1;
+    if(to < from) return;
+    selection.x = first + from;
+    selection.y = first + to;
 
-    for(int i = 0; i < crossties.size(); ++i)
+    if(gloParent->selectedFunc == NULL) return;
+    for(int i = from; i <= to; ++i)
     {
-        int node = crossties[i].node;
-        int section;
-        trackData->getSecNode(node, &node, &section);
-
-        curSection = trackData->lSections[section];
-
-        crossties[i].selected = (trackData == gloParent->curTrack() && curSection == trackData->activeSection) ? (curSection->isInFunction(node, gloParent->selectedFunc) ? 2.f : 1.f) : 0.f;
+        if(active->isInFunction(i, gloParent->selectedFunc))
+        {
+            if(selection.z > selection.w) selection.z = first + i;
+            selection.w = first + i;
+        }
+        else if(selection.z <= selection.w)
+        {
+            break;
+        }
     }
-    updateVertexArrays();
 }
 
 void trackMesh::updateVertexArrays()
@@ -3418,22 +2907,13 @@ void trackMesh::updateVertexArrays()
     glBindVertexArray(TrackObject[0]);
 
     glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[0]);  // Spine
-    glBufferData(GL_ARRAY_BUFFER, rails.size()*sizeof(tracknode_t), rails.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), 0);
-    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(3*sizeof(float)));
-    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(6*sizeof(float)));
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(8*sizeof(float)));
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(9*sizeof(float)));
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(10*sizeof(float)));
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(11*sizeof(float)));
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(12*sizeof(float)));
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(13*sizeof(float)));
+    if(gpuRails) glBufferData(GL_ARRAY_BUFFER, railVertexCount()*sizeof(tracknode_t), NULL, GL_STATIC_DRAW);
+    else glBufferData(GL_ARRAY_BUFFER, rails.size()*sizeof(tracknode_t), rails.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), 0);
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)(3*sizeof(float)));
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)(6*sizeof(float)));
+    glVertexAttribIPointer(6, 1, GL_INT, sizeof(tracknode_t), (void*)(8*sizeof(float)));
     glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glEnableVertexAttribArray(3);
-    glEnableVertexAttribArray(4);
-    glEnableVertexAttribArray(5);
     glEnableVertexAttribArray(6);
     glEnableVertexAttribArray(7);
     glEnableVertexAttribArray(8);
@@ -3445,22 +2925,13 @@ void trackMesh::updateVertexArrays()
     glBindVertexArray(TrackObject[3]);
 
     glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[3]);  // Crossties
-    glBufferData(GL_ARRAY_BUFFER, crossties.size()*sizeof(tracknode_t), crossties.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), 0);
-    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(3*sizeof(float)));
-    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(6*sizeof(float)));
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(8*sizeof(float)));
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(9*sizeof(float)));
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(10*sizeof(float)));
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(11*sizeof(float)));
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(12*sizeof(float)));
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(13*sizeof(float)));
+    if(gpuCrossties) glBufferData(GL_ARRAY_BUFFER, crosstieVertexCount(tieFrames.size())*sizeof(tracknode_t), NULL, GL_STATIC_DRAW);
+    else glBufferData(GL_ARRAY_BUFFER, crossties.size()*sizeof(tracknode_t), crossties.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), 0);
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)(3*sizeof(float)));
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)(6*sizeof(float)));
+    glVertexAttribIPointer(6, 1, GL_INT, sizeof(tracknode_t), (void*)(8*sizeof(float)));
     glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glEnableVertexAttribArray(3);
-    glEnableVertexAttribArray(4);
-    glEnableVertexAttribArray(5);
     glEnableVertexAttribArray(6);
     glEnableVertexAttribArray(7);
     glEnableVertexAttribArray(8);
@@ -3470,21 +2941,12 @@ void trackMesh::updateVertexArrays()
 
     glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[6]);  // Supports
     glBufferData(GL_ARRAY_BUFFER, rendersupports.size()*sizeof(tracknode_t), rendersupports.data(), GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), 0);
-    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(3*sizeof(float)));
-    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(6*sizeof(float)));
-    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(8*sizeof(float)));
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(9*sizeof(float)));
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(10*sizeof(float)));
-    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(11*sizeof(float)));
-    glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(12*sizeof(float)));
-    glVertexAttribPointer(6, 1, GL_FLOAT, GL_FALSE, 15*sizeof(float), (void*)(13*sizeof(float)));
+    supportVertexCount = rendersupports.size();
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), 0);
+    glVertexAttribPointer(7, 3, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)(3*sizeof(float)));
+    glVertexAttribPointer(8, 2, GL_FLOAT, GL_FALSE, sizeof(tracknode_t), (void*)(6*sizeof(float)));
+    glVertexAttribIPointer(6, 1, GL_INT, sizeof(tracknode_t), (void*)(8*sizeof(float)));
     glEnableVertexAttribArray(0);
-    glEnableVertexAttribArray(1);
-    glEnableVertexAttribArray(2);
-    glEnableVertexAttribArray(3);
-    glEnableVertexAttribArray(4);
-    glEnableVertexAttribArray(5);
     glEnableVertexAttribArray(6);
     glEnableVertexAttribArray(7);
     glEnableVertexAttribArray(8);
@@ -3511,6 +2973,7 @@ void trackMesh::updateVertexArrays()
 
     glBindBuffer(GL_ARRAY_BUFFER, HeartBuffer[3]);  // Shadow Supports
     glBufferData(GL_ARRAY_BUFFER, supportshadows.size()*sizeof(meshnode_t), supportshadows.data(), GL_STATIC_DRAW);
+    supportShadowCount = supportshadows.size();
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4*sizeof(float), 0);
     glEnableVertexAttribArray(0);
 
@@ -3518,89 +2981,303 @@ void trackMesh::updateVertexArrays()
 
     glBindBuffer(GL_ARRAY_BUFFER, HeartBuffer[4]);  // Shadow Crossties
     glBufferData(GL_ARRAY_BUFFER, crosstieshadows.size()*sizeof(meshnode_t), crosstieshadows.data(), GL_STATIC_DRAW);
+    crosstieShadowCount = crosstieshadows.size();
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 4*sizeof(float), 0);
     glEnableVertexAttribArray(0);
 
+    if(gpuRails)
+    {
+        glBindVertexArray(TrackObject[1]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[4]);  // Ring Template
+        glBufferData(GL_ARRAY_BUFFER, ringTemplate.size()*sizeof(ringvertex_t), ringTemplate.data(), GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(ringvertex_t), 0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ringvertex_t), (void*)(4*sizeof(float)));
+        glEnableVertexAttribArray(0);
+        glEnableVertexAttribArray(1);
+
+        glBindBuffer(GL_TEXTURE_BUFFER, TrackBuffer[2]);  // Rail Frames
+        glBufferData(GL_TEXTURE_BUFFER, railFrames.size()*sizeof(railframe_t), railFrames.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glView->extrudeRails(this);
+    }
+
+    if(gpuCrossties)
+    {
+        glBindVertexArray(TrackObject[2]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, TrackBuffer[5]);  // Crosstie Template
+        glBufferData(GL_ARRAY_BUFFER, tieTemplate.size()*sizeof(tievertex_t), tieTemplate.data(), GL_STATIC_DRAW);
+        for(int k = 0; k < 4; ++k)
+        {
+            glVertexAttribPointer(k, 4, GL_FLOAT, GL_FALSE, sizeof(tievertex_t), (void*)(4*k*sizeof(float)));
+            glEnableVertexAttribArray(k);
+        }
+        glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(tievertex_t), (void*)(16*sizeof(float)));
+        glEnableVertexAttribArray(4);
+
+        glBindBuffer(GL_TEXTURE_BUFFER, TrackBuffer[7]);  // Crosstie Frames
+        glBufferData(GL_TEXTURE_BUFFER, tieFrames.size()*sizeof(tieframe_t), tieFrames.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        glView->expandCrossties(this);
+    }
+
     glBindVertexArray(0);
     }
 }
 
+void trackMesh::updateNodeMetrics(int fromNode)
+{
+    int numNodes = trackData->lSections.size() ? trackData->getNumPoints()+1 : 0;
+    bool resized = nodeMetrics.size() != numNodes;
+    nodeMetrics.resize(numNodes);
+    if(resized || fromNode > numNodes) fromNode = 0;
+
+    int first = 0;
+    for(int i = 0; i < trackData->lSections.size(); ++i)
+    {
+        section* sec = trackData->lSections[i];
+        // the first node of every section but the first one is the last node of its predecessor
+        for(int j = i ? 1 : 0; j < sec->lNodes.size(); ++j)
+        {
+            if(first + j < fromNode) continue;
+            mnode* node = sec->readNode(j);
+            nodemetric_t* metric = &nodeMetrics[first + j];
+            metric->vel = node->fVel;
+            metric->rollSpeed = fabs(node->fRollSpeed+node->fSmoothSpeed);
+            metric->yForce = node->forceNormal+node->smoothNormal;
+            metric->xForce = fabs(node->forceLateral + node->smoothLateral);
+            metric->flexion = fabs(node->fFlexion());
+        }
+        if(sec->lNodes.size()) first += sec->lNodes.size()-1;
+    }
+
+    if(resized) metricsFrom = -1;
+    else if(metricsFrom >= 0) metricsFrom = std::min(metricsFrom, fromNode);
+}
+
+void trackMesh::uploadNodeMetrics()
+{
+    // the spec only guarantees 65536 texels, a track longer than the limit allows keeps every metricStep-th node
+    static GLint maxTexels = 0;
+    if(maxTexels <= 0) glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    const int texelsPerNode = sizeof(nodemetric_t)/(4*sizeof(float));
+    int maxNodes = std::max(maxTexels/texelsPerNode, 1);
+
+    int numNodes = nodeMetrics.size();
+    int step = std::max((numNodes+maxNodes-1)/maxNodes, 1);
+    glBindBuffer(GL_TEXTURE_BUFFER, TrackBuffer[1]);  // Node Metrics
+    if(step > 1)
+    {
+        QVector<nodemetric_t> sparse((numNodes+step-1)/step);
+        for(int i = 0; i < sparse.size(); ++i)
+        {
+            sparse[i] = nodeMetrics[i*step];
+        }
+        glBufferData(GL_TEXTURE_BUFFER, sparse.size()*sizeof(nodemetric_t), sparse.data(), GL_DYNAMIC_DRAW);
+    }
+    else if(metricsFrom < 0 || metricStep > 1)
+    {
+        glBufferData(GL_TEXTURE_BUFFER, nodeMetrics.size()*sizeof(nodemetric_t), nodeMetrics.data(), GL_DYNAMIC_DRAW);
+    }
+    else if(metricsFrom < numNodes)
+    {
+        glBufferSubData(GL_TEXTURE_BUFFER, metricsFrom*sizeof(nodemetric_t), (numNodes-metricsFrom)*sizeof(nodemetric_t), nodeMetrics.data()+metricsFrom);
+    }
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    metricsFrom = numNodes;
+    metricStep = step;
+}
+
 void trackMesh::createIndices()
 {
     if(nodeList.isEmpty()) return;
-    glm::vec3 cameraPos = glView->cameraPos;
     int edgeCount = 0;
     for(int i = 0; i < options.size(); ++i) edgeCount += options[i].edges;
 
-    QList<int> renderList;
-    for(int i = 0; i < nodeList.size(); ++i)
+    int nodeCount = nodeList.size();
+
+    // split the mesh nodes into chunks, neighbouring chunks share their border node
+    // every level keeps both border rings, so chunks at different levels meet on the same vertices
+    numChunks = nodeCount > 1 ? (nodeCount-2)/LOD_CHUNK_NODES+1 : 1;
+    lodStrips = isWireframe ? numRails : options.size();
+
+    // crossties are sorted by node, so every chunk owns one continuous range of them
+    QVector<int> tieBorders;
+    crosstieBorders.clear();
+    for(int c = 0, i = 0; c < numChunks; ++c)
     {
-        renderList.append(i);
+        if(gpuCrossties)
+        {
+            if(c) while(i < tieFrames.size() && (int)tieFrames[i].node < nodeList[c*LOD_CHUNK_NODES]) ++i;
+            tieBorders.append(i);
+            crosstieBorders.append(crosstieVertexCount(i));
+        }
+        else
+        {
+            if(c) while(i < crossties.size() && crossties[i].node < nodeList[c*LOD_CHUNK_NODES]) ++i;
+            crosstieBorders.append(i);
+        }
     }
-    /*glm::mat4 anchorBase = glm::translate(trackData->startPos) * glm::rotate(trackData->startYaw-90, glm::vec3(0.f, 1.f, 0.f));
+    tieBorders.append(tieFrames.size());
+    crosstieBorders.append(gpuCrossties ? crosstieVertexCount(tieFrames.size()) : crossties.size());
 
-    for(int i = 0; i < nodeList.size();)
+    chunkBounds.clear();
+    for(int c = 0; c < numChunks; ++c)
     {
-        mnode* curNode = trackData->getPoint(nodeList[i]);
-        glm::vec3 pos = glm::vec3(anchorBase*glm::vec4(curNode->vPos, 1));
-        int dist = pow(glm::length(pos-cameraPos)/120.f, 4);
-        if(dist < 1) dist = 1;
-        if(dist > 16) dist = 16;
-        renderList.append(i);
-        i+=dist;
+        int first = c*LOD_CHUNK_NODES;
+        int last = std::min(first+LOD_CHUNK_NODES, nodeCount-1);
+        glm::vec3 minPos(0.f), maxPos(0.f);
+        bool isEmpty = true;
+        for(int i = first; i <= last; ++i)
+        {
+            int vertexCount = isWireframe ? numRails : edgeCount;
+            int base = isWireframe ? numRails*i : options.size()+edgeCount*i;
+            for(int k = 0; k < vertexCount && base+k < rails.size(); ++k)
+            {
+                glm::vec3 pos = rails[base+k].pos;
+                if(isEmpty)
+                {
+                    minPos = pos;
+                    maxPos = pos;
+                    isEmpty = false;
+                }
+                minPos = glm::min(minPos, pos);
+                maxPos = glm::max(maxPos, pos);
+            }
+            // rails extruded on the GPU only exist as frames here, pad them by the pipe radius
+            for(int p = 0; gpuRails && p < options.size() && options.size()*i+p < railFrames.size(); ++p)
+            {
+                glm::vec3 pos = railFrames[options.size()*i+p].pos;
+                glm::vec3 radius(std::max(options[p].radius.x, options[p].radius.y));
+                if(isEmpty)
+                {
+                    minPos = pos-radius;
+                    maxPos = pos+radius;
+                    isEmpty = false;
+                }
+                minPos = glm::min(minPos, pos-radius);
+                maxPos = glm::max(maxPos, pos+radius);
+            }
+        }
+        if(gpuCrossties)
+        {
+            // ties expanded on the GPU may reach back to the previous tie, pad both by the template size
+            glm::vec3 radius(tieRadius);
+            for(int i = std::max(tieBorders[c]-1, 0); i < tieBorders[c+1]; ++i)
+            {
+                minPos = glm::min(minPos, tieFrames[i].pos-radius);
+                maxPos = glm::max(maxPos, tieFrames[i].pos+radius);
+            }
+        }
+        else
+        {
+            for(int i = crosstieBorders[c]; i < crosstieBorders[c+1]; ++i)
+            {
+                minPos = glm::min(minPos, crossties[i].pos);
+                maxPos = glm::max(maxPos, crossties[i].pos);
+            }
+        }
+        chunkBounds.append(minPos);
+        chunkBounds.append(maxPos);
     }
-    if(renderList.last() != nodeList.size()-1) renderList.append(nodeList.size()-1);*/
-
-    int nodeCount = nodeList.size();
 
-
-    pipeBorders.clear();
-    pipeIndices.clear();
-    pipeBorders.append(0);
-    if(isWireframe)
+    supportBounds.clear();
+    if(!isWireframe)
     {
-        for(int p = 0; p < numRails; ++p)
+        for(int i = 0; i < supportsSize && 61*i+61 <= rendersupports.size(); ++i)
         {
-            for(int i = 0; i < renderList.size(); ++i)
+            glm::vec3 minPos = rendersupports[61*i].pos, maxPos = rendersupports[61*i].pos;
+            for(int k = 1; k < 61; ++k)
             {
-                pipeIndices.append(p+numRails*renderList[i]);
+                minPos = glm::min(minPos, rendersupports[61*i+k].pos);
+                maxPos = glm::max(maxPos, rendersupports[61*i+k].pos);
             }
-            pipeBorders.append(pipeIndices.size());
+            supportBounds.append(minPos);
+            supportBounds.append(maxPos);
         }
     }
-    else
+
+    pipeIndices.clear();
+    lodBorders.clear();
+    lodBorders.append(0);
+    for(int c = 0; c < numChunks; ++c)
     {
-        for(int p = 0; p < options.size(); ++p)
+        int first = c*LOD_CHUNK_NODES;
+        int last = std::min(first+LOD_CHUNK_NODES, nodeCount-1);
+        for(int l = 0; l < LOD_LEVELS; ++l)
         {
-            int offset = 0;
-            for(int i = 0; i < p; ++i)
+            QList<int> renderList;
+            for(int i = first; i < last; i += 1<<l)
             {
-                offset += options[i].edges;
+                renderList.append(i);
             }
-            pipeIndices.append(p);
-            for(int e = 0; e < options[p].edges; e+=2)
+            renderList.append(last);
+
+            if(isWireframe)
             {
-                int e2 = (e+1)%options[p].edges;
-                int e3 = (e+2)%options[p].edges;
-                int i;
-                for(i = 0; i < renderList.size(); ++i)
+                for(int p = 0; p < numRails; ++p)
                 {
-                    int node = renderList[i];
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e);
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e2);
+                    for(int i = 0; i < renderList.size(); ++i)
+                    {
+                        pipeIndices.append(p+numRails*renderList[i]);
+                    }
+                    lodBorders.append(pipeIndices.size());
                 }
-                pipeIndices.append(options.size() + edgeCount*nodeCount + p);
-                for(i = renderList.size()-1; i >= 0; --i)
+            }
+            else
+            {
+                for(int p = 0; p < options.size(); ++p)
                 {
-                    int node = renderList[i];
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e3);
-                    pipeIndices.append(options.size() + offset + edgeCount*node + e2);
+                    int offset = 0;
+                    for(int i = 0; i < p; ++i)
+                    {
+                        offset += options[i].edges;
+                    }
+                    // only the outer chunks get caps, inner ones turn around on the ring vertex they just
+                    // emitted, so the turn only adds zero area triangles instead of a face across the ring
+                    int startRing = options.size() + offset + edgeCount*first;
+                    int endRing = options.size() + offset + edgeCount*last;
+                    int startCap = c == 0 ? p : startRing;
+                    int endCap;
+                    pipeIndices.append(startCap);
+                    for(int e = 0; e < options[p].edges; e+=2)
+                    {
+                        int e2 = (e+1)%options[p].edges;
+                        int e3 = (e+2)%options[p].edges;
+                        if(c) startCap = startRing + e3;
+                        endCap = c == numChunks-1 ? options.size() + edgeCount*nodeCount + p : endRing + e2;
+                        int i;
+                        for(i = 0; i < renderList.size(); ++i)
+                        {
+                            int node = renderList[i];
+                            pipeIndices.append(options.size() + offset + edgeCount*node + e);
+                            pipeIndices.append(options.size() + offset + edgeCount*node + e2);
+                        }
+                        pipeIndices.append(endCap);
+                        for(i = renderList.size()-1; i >= 0; --i)
+                        {
+                            int node = renderList[i];
+                            pipeIndices.append(options.size() + offset + edgeCount*node + e3);
+                            pipeIndices.append(options.size() + offset + edgeCount*node + e2);
+                        }
+                        pipeIndices.append(startCap);
+                    }
+                    lodBorders.append(pipeIndices.size());
                 }
-                pipeIndices.append(p);
             }
-            pipeBorders.append(pipeIndices.size());
         }
+    }
 
+    chunkLoD.fill(0, numChunks);
+    chunkVisible.fill(true, numChunks);
+    supportVisible.fill(true, supportBounds.size()/2);
+    fillDrawLists();
+
+    if(!isWireframe)
+    {
         shadowIndices.clear();
         for(int p = 0; p < options.size(); ++p)
         {
@@ -3664,7 +3341,7 @@ void trackMesh::createIndices()
         }
     }
 
-    updateVertexArrays();
+    // the buffers follow in uploadMeshes(), generateMeshes() may run on a worker
     /*if(!glView->legacyMode)
     {
         glBindVertexArray(TrackObject[0]);
@@ -3677,3 +3354,132 @@ void trackMesh::createIndices()
         glBindVertexArray(0);
     }*/
 }
+
+// a box is visible if it, or the shadow it throws onto the floor, intersects the view frustum
+static bool isBoxVisible(const glm::vec4* planes, const glm::mat4 &anchorBase, const glm::vec3 &lightDir, const glm::vec3 &minPos, const glm::vec3 &maxPos)
+{
+    // a light at the horizon throws shadows without bounds, they may reach the frustum from anywhere
+    if(fabs(lightDir.y) < 1e-3f) return true;
+
+    glm::vec3 corners[16];
+    for(int i = 0; i < 8; ++i)
+    {
+        glm::vec3 corner((i&1) ? maxPos.x : minPos.x, (i&2) ? maxPos.y : minPos.y, (i&4) ? maxPos.z : minPos.z);
+        corners[i] = glm::vec3(anchorBase*glm::vec4(corner, 1.f));
+        corners[i+8] = corners[i] - corners[i].y*lightDir/lightDir.y;
+    }
+    for(int p = 0; p < 6; ++p)
+    {
+        int i;
+        for(i = 0; i < 16; ++i)
+        {
+            if(glm::dot(glm::vec3(planes[p]), corners[i]) + planes[p].w >= 0.f) break;
+        }
+        if(i == 16) return false;
+    }
+    return true;
+}
+
+void trackMesh::updateChunks(const glm::mat4 &anchorBase, const glm::mat4 &projectionModel, const glm::vec3 &eyePos, const glm::vec3 &lightDir)
+{
+    if(chunkLoD.size() != numChunks) return;
+
+    glm::vec4 planes[6];
+    for(int p = 0; p < 3; ++p)
+    {
+        planes[2*p] = glm::row(projectionModel, 3) + glm::row(projectionModel, p);
+        planes[2*p+1] = glm::row(projectionModel, 3) - glm::row(projectionModel, p);
+    }
+
+    bool changed = false;
+    drawnChunks = culledChunks = 0;
+    QVector<int> levels(numChunks);
+    for(int c = 0; c < numChunks; ++c)
+    {
+        bool visible = isBoxVisible(planes, anchorBase, lightDir, chunkBounds[2*c], chunkBounds[2*c+1]);
+        visible ? ++drawnChunks : ++culledChunks;
+        if(chunkVisible[c] != visible)
+        {
+            chunkVisible[c] = visible;
+            changed = true;
+        }
+
+        glm::vec3 center = glm::vec3(anchorBase*glm::vec4(0.5f*(chunkBounds[2*c]+chunkBounds[2*c+1]), 1.f));
+        float dist = glm::length(center-eyePos) - 0.5f*glm::length(chunkBounds[2*c+1]-chunkBounds[2*c]);
+        int level = 0;
+        if(dist > LOD_DISTANCE)
+        {
+            float stride = pow(dist/LOD_DISTANCE, 4);
+            while(level < LOD_LEVELS-1 && (2<<level) <= stride) ++level;
+        }
+        levels[c] = level;
+    }
+
+    // neighbouring chunks are at most one level apart, a coarse chunk never meets a full detail one
+    for(int c = 1; c < numChunks; ++c)
+    {
+        levels[c] = std::min(levels[c], levels[c-1]+1);
+    }
+    for(int c = numChunks-2; c >= 0; --c)
+    {
+        levels[c] = std::min(levels[c], levels[c+1]+1);
+    }
+    for(int c = 0; c < numChunks; ++c)
+    {
+        if(chunkLoD[c] != levels[c])
+        {
+            chunkLoD[c] = levels[c];
+            changed = true;
+        }
+    }
+
+    for(int i = 0; i < supportVisible.size(); ++i)
+    {
+        bool visible = isBoxVisible(planes, anchorBase, lightDir, supportBounds[2*i], supportBounds[2*i+1]);
+        if(supportVisible[i] != visible)
+        {
+            supportVisible[i] = visible;
+            changed = true;
+        }
+    }
+    if(changed) fillDrawLists();
+}
+
+void trackMesh::fillDrawLists()
+{
+    drawCounts.clear();
+    drawOffsets.clear();
+    crosstieFirsts.clear();
+    crosstieCounts.clear();
+    for(int c = 0; c < numChunks; ++c)
+    {
+        if(!chunkVisible[c]) continue;
+        for(int p = 0; p < lodStrips; ++p)
+        {
+            int k = (c*LOD_LEVELS+chunkLoD[c])*lodStrips+p;
+            drawCounts.append(lodBorders[k+1]-lodBorders[k]);
+            drawOffsets.append((GLvoid*)(sizeof(GLuint)*lodBorders[k]));
+        }
+        int count = crosstieBorders[c+1]-crosstieBorders[c];
+        if(!count) continue;
+        if(crosstieFirsts.size() && crosstieFirsts.last()+crosstieCounts.last() == crosstieBorders[c])
+        {
+            crosstieCounts.last() += count;
+        }
+        else
+        {
+            crosstieFirsts.append(crosstieBorders[c]);
+            crosstieCounts.append(count);
+        }
+    }
+
+    // every support is its own strip of 61 vertices, all of them go out in one multi draw
+    supportFirsts.clear();
+    supportCounts.clear();
+    for(int i = 0; i < supportVisible.size(); ++i)
+    {
+        if(!supportVisible[i]) continue;
+        supportFirsts.append(61*i);
+        supportCounts.append(61);
+    }
+}
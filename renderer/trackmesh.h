@@ -22,24 +22,80 @@
 //#include "mypanelopengl.h"
 #include "glviewwidget.h"
 
+#define LOD_CHUNK_NODES 32      // mesh nodes per level of detail chunk
+#define LOD_LEVELS 4            // node strides 1, 2, 4 and 8
+#define LOD_DISTANCE (120.f)    // chunks closer than this are always drawn in full detail
+#define EXPORT_SUPPORTS 256     // supports per exported mesh group
+
 typedef struct tracknode_s{
     glm::vec3 pos;
     glm::vec3 normal;
     glm::vec2 uv;
+    int node;
+} tracknode_t;
+
+typedef struct nodemetric_s{    // two RGBA texels per node in the metric buffer texture
     float vel;
     float rollSpeed;
     float yForce;
     float xForce;
     float flexion;
-    float selected;
-    int node;
-} tracknode_t;
+    float padding[3];
+} nodemetric_t;
+
+typedef struct railframe_s{     // four RGBA texels per pipe and mesh node in the frame buffer texture
+    glm::vec3 pos;
+    float v;
+    glm::vec3 normal;
+    float node;
+    glm::vec3 lat;
+    float padding;
+    glm::vec3 dir;
+    float padding2;
+} railframe_t;
+
+typedef struct ringvertex_s{
+    glm::vec4 shape;    // position and normal of the ring vertex in the frame of its pipe
+    float u;
+    float pipe;
+} ringvertex_t;
+
+typedef struct tieframe_s{      // four RGBA texels per crosstie in the tie buffer texture
+    glm::vec3 pos;
+    float node;
+    glm::vec3 normal;
+    float latRoll;
+    glm::vec3 lat;
+    float dirRoll;
+    glm::vec3 dir;
+    float padding;
+} tieframe_t;
+
+typedef struct tievertex_s{
+    glm::vec4 corners[4];   // quad corners as vRelPos() arguments, w selects the previous tie
+    float corner;
+    float triangle;
+    float tie;              // offset of the tie inside its template block
+    float padding;
+} tievertex_t;
 
 typedef struct meshnode_s{
     glm::vec3 pos;
     int node;
 } meshnode_t;
 
+typedef struct meshsettings_s{  // the options generateMeshes() depends on, copied from the GUI when a mesh is queued
+    int quality;
+    bool gpuRails;
+    bool gpuCrossties;
+    bool legacyMode;
+} meshsettings_t;
+
+meshsettings_t currentMeshSettings();   // GUI thread only
+
+class meshSink;
+struct meshgroup_s;
+
 typedef struct pipeoption_s{
     int edges;
     glm::vec2 radius;
@@ -54,40 +110,84 @@ public:
     ~trackMesh();
 
     bool isInit;
+    bool listsReleased;                 // the next generateMeshes() starts at node 0, exportMesh() rebuilds the lists first
+    GLsizei supportVertexCount, supportShadowCount, crosstieShadowCount;  // sizes of the uploaded buffers, the lists may be released
 
     int createPipes(QVector<tracknode_t> &list, QList<pipeoption_t> &options);
-    int create3dsPipes(QVector<float> *_vertices, QList<pipeoption_t> &options);
+    void createRings(QVector<tracknode_t> &list, QList<pipeoption_t> &options);
+    void createRailFrames(QList<pipeoption_t> &options);
+    void createRingTemplate(QList<pipeoption_t> &options);
+    int lastRailNode();
+    int railVertexCount();
     void createIndices();
+    void updateChunks(const glm::mat4 &anchorBase, const glm::mat4 &projectionModel, const glm::vec3 &eyePos, const glm::vec3 &lightDir);
 
     int createPipe(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, float y, float x, bool smooth = true);
     void createBox(QVector<tracknode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
     void createBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
+    void createCrosstie(int index, mnode* tieNode, mnode* lastNode, float railSpacing, float railWidth, float spineHeight, float spineSize, QVector<tracknode_t>* list, QVector<meshnode_t> &shadows);
+    void createTieTemplate(float railSpacing, float railWidth, float spineHeight, float spineSize);
+    int crosstiePeriod();
+    int crosstieVertexCount(int ties);
     int createShadowBox(QVector<meshnode_t> &list, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
-    void create3dsBox(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1l, glm::vec3 P2l, glm::vec3 P3l, glm::vec3 P4l, glm::vec3 P1r, glm::vec3 P2r, glm::vec3 P3r, glm::vec3 P4r);
 
     void createQuad(QVector<tracknode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
     void createQuad(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
-    void create3dsQuad(QVector<float> *_vertices, QVector<unsigned int> *_indices, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3, glm::vec3 P4);
     int createShadowTriangle(QVector<meshnode_t> &list, glm::vec3 P1, glm::vec3 P2, glm::vec3 P3);
 
     void createSupport(QVector<tracknode_t> &list, int edges, float radiusy, float radiusx, glm::vec3 P1, glm::vec3 P2, bool smooth);
 
-    void buildMeshes(int fromNode);
-    void build3ds(const int _sec, QVector<float> * _vertices, QVector<unsigned int> *_indices, QVector<unsigned int> *_borders);
+    void buildMeshes(int fromNode, int toSection = -1);
+    void generateMeshes(int fromNode);
+    void generateMeshes(int fromNode, const meshsettings_t &settings, int toSection = -1);  // no GL calls, may run on a worker thread
+    void uploadMeshes();                // buffers of the last generateMeshes(), needs the GL context
+    void releaseLists();                // frees the vertex lists already in the buffers, see listsReleased
+    bool exportMesh(meshSink* _sink);
     void updateVertexArrays();
+    void updateNodeMetrics(int fromNode);
+    void uploadNodeMetrics();
 
     void appendTrackNode(QVector<tracknode_t> &list, float _u = 0.f, float _v = 0.f);
-    void append3dsNode(QVector<float> *_vertices);
     void appendSupportNode(QVector<tracknode_t> &list, float _u = 0.f, float _v = 0.f);
     void appendMeshNode(QVector<meshnode_t> &list);
 
-    void recolorTrack(void);
+    void updateSelection(void);
 
     QVector<tracknode_t> rails;
+    QVector<railframe_t> railFrames;    // rails extruded on the GPU, see glViewWidget::extrudeRails
+    QVector<ringvertex_t> ringTemplate;
+    myTexture* frameTexture;
+    bool gpuRails;
+    QVector<nodemetric_t> nodeMetrics;
+    int metricsFrom;                    // first metric not uploaded yet, -1 reallocates the buffer
+    int metricStep;                     // nodes per uploaded metric, more than 1 if the track exceeds GL_MAX_TEXTURE_BUFFER_SIZE
+    myTexture* metricTexture;
     QList<int> nodeList;
     QVector<int> pipeIndices, shadowIndices;
-    QList<int> pipeBorders;
+
+    QVector<int> lodBorders;            // index ranges, ordered by chunk, level and pipe
+    QVector<glm::vec3> chunkBounds;     // min and max corner of every chunk
+    QVector<glm::vec3> supportBounds;   // min and max corner of every support
+    QVector<int> crosstieBorders;       // first crosstie vertex of every chunk
+    QVector<int> chunkLoD;
+    QVector<bool> chunkVisible, supportVisible;
+    QVector<GLsizei> drawCounts;        // ranges selected for the current frame
+    QVector<GLvoid*> drawOffsets;
+    QVector<GLint> crosstieFirsts;
+    QVector<GLsizei> crosstieCounts;
+    QVector<GLint> supportFirsts;
+    QVector<GLsizei> supportCounts;
+    int numChunks, lodStrips;
+    float buildTime;                    // ms spent in the last generateMeshes()
+    int drawnChunks, culledChunks;
+    glm::ivec4 selection;               // first and last node of the active section and the selected function
     QVector<tracknode_t> crossties;
+    QVector<tieframe_t> tieFrames;      // crossties expanded on the GPU, see glViewWidget::expandCrossties
+    QVector<tievertex_t> tieTemplate;   // the first tie followed by one block of crosstiePeriod() ties
+    QVector<int> tieBlockOffsets;       // first template vertex of every tie in the block
+    float tieRadius;
+    myTexture* tieTexture;
+    bool gpuCrossties;
     QVector<tracknode_t> rendersupports;
 
     QVector<meshnode_t> supports;
@@ -101,7 +201,7 @@ public:
     QList<int> posList;
     QList<int> secList;
 
-    GLuint TrackBuffer[7], TrackObject[5], TrackIndices[5];
+    GLuint TrackBuffer[8], TrackObject[5], TrackIndices[5];
     GLuint HeartBuffer[5], HeartObject[5], HeartIndices[5];
     GLuint ShadowBuffer[1], ShadowObject[1];
 
@@ -111,8 +211,12 @@ public:
 
     bool isWireframe;
 
-    void init();
+    void init(bool build = true);
 private:
+    void fillDrawLists();
+    void exportChunk(int c, const tracknode_t* railData, const tracknode_t* tieData, struct meshgroup_s &group);
+    void exportSupports(int first, int last, struct meshgroup_s &group);
+
     int j;
     int nextNode;
     glm::vec3 nextPos;
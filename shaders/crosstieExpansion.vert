@@ -0,0 +1,56 @@
+#version 140
+
+in vec4 aCorner1;
+in vec4 aCorner2;
+in vec4 aCorner3;
+in vec4 aCorner4;
+in vec3 aInfo;      // corner, triangle of the quad and tie inside the template block
+
+uniform samplerBuffer tieTex;
+uniform int firstTie;
+uniform int tiePeriod;
+
+out vec3 tfPos;
+out vec3 tfNormal;
+out vec2 tfUv;
+flat out int tfNode;
+
+const float PI = 3.14159265;
+
+int tie;
+
+// mnode::vRelPos() on the frame of the tie, or the one before it for braces between two ties
+vec3 relPos(vec4 corner)
+{
+    int texel = 4*max(tie-int(corner.w), 0);
+    vec3 pos = texelFetch(tieTex, texel).xyz;
+    vec4 norm = texelFetch(tieTex, texel+1);
+    vec4 lat = texelFetch(tieTex, texel+2);
+    vec3 dir = texelFetch(tieTex, texel+3).xyz;
+
+    float heart = -corner.x;
+    vec3 latHeart = normalize(normalize(lat.xyz) - normalize(dir)*(norm.w*PI*heart/180.));
+    vec3 dirHeart = normalize(dir + lat.xyz*(lat.w*PI*heart/180.));
+    return pos - corner.x*norm.xyz + corner.y*latHeart + corner.z*dirHeart;
+}
+
+void main(void)
+{
+    tie = firstTie + gl_InstanceID*tiePeriod + int(aInfo.z);
+
+    vec3 P1 = relPos(aCorner1);
+    vec3 P2 = relPos(aCorner2);
+    vec3 P3 = relPos(aCorner3);
+    vec3 P4 = relPos(aCorner4);
+
+    // same normals and texture coordinates as trackMesh::createQuad()
+    int corner = int(aInfo.x);
+    vec3 base1 = normalize(P1-P4);
+    vec3 base2 = cross(base1, cross(base1, normalize(P1-P2)));
+
+    tfPos = corner == 0 ? P1 : (corner == 1 ? P2 : (corner == 2 ? P3 : P4));
+    tfNormal = aInfo.y < 0.5 ? normalize(cross(P1-P4, P1-P2)) : normalize(cross(P2-P4, P2-P3));
+    tfUv = vec2(dot(tfPos, base1), dot(tfPos, base2));
+    tfNode = int(texelFetch(tieTex, 4*tie).w);
+    gl_Position = vec4(tfPos, 1.);
+}
@@ -1,12 +1,16 @@
-#version 130
+#version 140
 
 in vec3 aPosition;
 out vec2 rasterCoord;
 out vec2 floorCoord;
 out vec4 screenCoord;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
-uniform vec3 eyePos;
+layout(std140) uniform frameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 modelMatrix;
+    vec3 eyePos;
+    vec3 lightDir;
+};
 
 void main(void)
 {
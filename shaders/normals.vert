@@ -1,12 +1,16 @@
-#version 130
+#version 140
 
 in vec3 aPosition;
 out vec4 bPosition;
 out vec4 screenPos;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
+layout(std140) uniform frameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 modelMatrix;
+    vec3 eyePos;
+    vec3 lightDir;
+};
 uniform mat4 anchorBase;
-uniform vec3 eyePos;
 
 in vec3 aNormal;
 out vec3 bNormal;
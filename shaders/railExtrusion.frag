@@ -0,0 +1,8 @@
+#version 140
+
+out vec4 color;
+
+void main(void)
+{
+    color = vec4(1.);
+}
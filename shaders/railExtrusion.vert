@@ -0,0 +1,39 @@
+#version 140
+
+in vec4 aShape;
+in vec2 aTemplate;
+
+uniform samplerBuffer frameTex;
+uniform int numPipes;
+uniform int numFrames;
+uniform int capMode;    // 0 first caps, 1 rings, 2 last caps
+
+out vec3 tfPos;
+out vec3 tfNormal;
+out vec2 tfUv;
+flat out int tfNode;
+
+void main(void)
+{
+    // rings are drawn instanced, one instance per mesh node, caps use the first or last frame
+    int pipe = capMode == 1 ? int(aTemplate.y) : gl_VertexID;
+    int frame = capMode == 1 ? gl_InstanceID : (capMode == 0 ? 0 : numFrames-1);
+    int texel = 4*(frame*numPipes + pipe);
+
+    vec4 center = texelFetch(frameTex, texel);
+    vec4 norm = texelFetch(frameTex, texel+1);
+    vec3 lat = texelFetch(frameTex, texel+2).xyz;
+    vec3 dir = texelFetch(frameTex, texel+3).xyz;
+
+    if(capMode == 1) {
+        tfPos = center.xyz - aShape.x*norm.xyz + aShape.y*lat;
+        tfNormal = normalize(-aShape.z*norm.xyz + aShape.w*lat);
+        tfUv = vec2(aTemplate.x, center.w);
+    } else {
+        tfPos = center.xyz;
+        tfNormal = float(capMode-1)*dir;
+        tfUv = vec2(0., center.w);
+    }
+    tfNode = int(norm.w);
+    gl_Position = vec4(tfPos, 1.);
+}
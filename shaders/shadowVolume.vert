@@ -1,14 +1,20 @@
-#version 130
+#version 140
 
 in vec3 aPosition;
-uniform vec3 lightDir;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
+layout(std140) uniform frameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 modelMatrix;
+    vec3 eyePos;
+    vec3 lightDir;
+};
 uniform mat4 anchorBase;
+uniform float uFill;
 out vec4 pos;
 
 void main(void)
 {
     pos = anchorBase * vec4(aPosition, 1);
-    gl_Position = projectionMatrix * modelMatrix * pos;
+    if(uFill > 0.5) gl_Position = pos;     // screen filling mask
+    else gl_Position = projectionMatrix * modelMatrix * pos;
 }
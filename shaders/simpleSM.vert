@@ -1,10 +1,14 @@
-#version 130
+#version 140
 
 in vec3 aPosition;
 out vec4 pos;
-uniform vec3 lightDir;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
+layout(std140) uniform frameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 modelMatrix;
+    vec3 eyePos;
+    vec3 lightDir;
+};
 uniform mat4 anchorBase;
 
 void main(void)
@@ -1,4 +1,4 @@
-#version 130
+#version 140
 
 out vec4 oFragColor;
 in vec4 bPosition;
@@ -7,7 +7,13 @@ in vec3 color;
 in vec2 bUv;
 in vec4 screenCoord;
 
-uniform vec3 lightDir;
+layout(std140) uniform frameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 modelMatrix;
+    vec3 eyePos;
+    vec3 lightDir;
+};
 
 uniform sampler2D metalTex;
 uniform sampler2D shadowTex;
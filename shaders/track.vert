@@ -1,12 +1,17 @@
-#version 130
+#version 140
 
 in vec3 aPosition;
 out vec4 bPosition;
-uniform mat4 projectionMatrix;
-uniform mat4 modelMatrix;
+layout(std140) uniform frameUniforms
+{
+    mat4 projectionMatrix;
+    mat4 modelMatrix;
+    vec3 eyePos;
+    vec3 lightDir;
+};
 uniform mat4 anchorBase;
-uniform vec3 eyePos;
 
+uniform ivec4 selection;
 uniform vec3 defaultColor;
 uniform vec3 sectionColor;
 uniform vec3 transitionColor;
@@ -19,14 +24,17 @@ out vec4 screenCoord;
 in vec3 aNormal;
 out vec3 bNormal;
 
-in float aselected;
-in float aVel;
-in float aRoll;
-in float aNForce;
-in float aLForce;
-in float aFlex;
+in int aNode;
 out vec3 color;
 
+uniform samplerBuffer metricTex;
+uniform int metricStep;
+float vel;
+float roll;
+float nForce;
+float lForce;
+float flexion;
+
 uniform int colorMode;
 
 
@@ -34,93 +42,104 @@ vec3 getColor()
 {
     switch(colorMode) {
         case 0: // nothing
-            if(aselected < 0.5) return defaultColor;
-            else if(aselected < 1.5) return sectionColor;
+            if(aNode < selection.x || aNode > selection.y) return defaultColor;
+            else if(aNode < selection.z || aNode > selection.w) return sectionColor;
             else return transitionColor;
         case 1: // velocity
-            if(aVel > 60.)
+            if(vel > 60.)
             return vec3(1., 0., 1.);
-            else if(aVel >= 40.)
-            return vec3(1., 0., (aVel-40.)/20);
-            else if(aVel >= 30.)
-            return vec3(1., (40.-aVel)/10., 0.);
-            else if(aVel >= 20.)
-            return vec3((aVel-20.)/10., 1., 0);
-            else if(aVel >= 10.)
-            return vec3(0., 1., (20-aVel)/10.);
-            else if(aVel >= 1)
-            return vec3(0., (aVel-1)/9, 1.);
+            else if(vel >= 40.)
+            return vec3(1., 0., (vel-40.)/20);
+            else if(vel >= 30.)
+            return vec3(1., (40.-vel)/10., 0.);
+            else if(vel >= 20.)
+            return vec3((vel-20.)/10., 1., 0);
+            else if(vel >= 10.)
+            return vec3(0., 1., (20-vel)/10.);
+            else if(vel >= 1)
+            return vec3(0., (vel-1)/9, 1.);
             else
             return vec3(0., 0., 0.);
         case 2: // rollspeed
-            if(aRoll > 240.)
+            if(roll > 240.)
             return vec3(0., 0., 0.);
-            else if(aRoll >= 160)
-            return vec3((240-aRoll)/80, 0., (240-aRoll)/80);
-            else if(aRoll >= 80)
-            return vec3(1., 0., (aRoll-80)/80);
-            else if(aRoll >= 40)
-            return vec3(1., (80-aRoll)/40, 0);
-            else if(aRoll >= 20)
-            return vec3((aRoll-20)/20, 1., 0.);
-            else if(aRoll >= 10)
-            return vec3(0., 1., (20.-aRoll)/10);
+            else if(roll >= 160)
+            return vec3((240-roll)/80, 0., (240-roll)/80);
+            else if(roll >= 80)
+            return vec3(1., 0., (roll-80)/80);
+            else if(roll >= 40)
+            return vec3(1., (80-roll)/40, 0);
+            else if(roll >= 20)
+            return vec3((roll-20)/20, 1., 0.);
+            else if(roll >= 10)
+            return vec3(0., 1., (20.-roll)/10);
             else
-            return vec3(0., aRoll/10, 1.);
+            return vec3(0., roll/10, 1.);
         case 3: // normal force
-            if(aNForce > 6.5)
+            if(nForce > 6.5)
             return vec3(0., 0., 0.);
-            else if(aNForce > 5.)
-            return vec3((6.5-aNForce)/1.5, 0., (6.5-aNForce)/1.5);
-            else if(aNForce >= 3.5)
-            return vec3(1., 0., (aNForce-3.5)/1.5);
-            else if(aNForce >= 2)
-            return vec3(1., (3.5-aNForce)/1.5, 0.);
-            else if(aNForce >= 1.)
-            return vec3(aNForce-1, 1., 0.);
-            else if(aNForce >= 0.)
-            return vec3(0., 1., 1-aNForce);
-            else if(aNForce >= -1.)
-            return vec3(0., aNForce+1., 1.);
-            else if(aNForce >= -2.5)
-            return vec3(0., 0., (aNForce+2.5)/(1.5));
+            else if(nForce > 5.)
+            return vec3((6.5-nForce)/1.5, 0., (6.5-nForce)/1.5);
+            else if(nForce >= 3.5)
+            return vec3(1., 0., (nForce-3.5)/1.5);
+            else if(nForce >= 2)
+            return vec3(1., (3.5-nForce)/1.5, 0.);
+            else if(nForce >= 1.)
+            return vec3(nForce-1, 1., 0.);
+            else if(nForce >= 0.)
+            return vec3(0., 1., 1-nForce);
+            else if(nForce >= -1.)
+            return vec3(0., nForce+1., 1.);
+            else if(nForce >= -2.5)
+            return vec3(0., 0., (nForce+2.5)/(1.5));
             else
             return vec3(0., 0., 0.);
         case 4: // lateral force
-            if(aLForce > 2.)
+            if(lForce > 2.)
             return vec3(0., 0., 0.);
-            else if(aLForce >= 1.5)
-            return vec3((2-aLForce)/0.5, 0., (2-aLForce)/0.5);
-            else if(aLForce >= 1.)
-            return vec3(1., 0., (aLForce-1.0)/0.5);
-            else if(aLForce >= 0.5)
-            return vec3(1., (1.0-aLForce)/0.5, 0);
-            else if(aLForce >= 0.25)
-            return vec3((aLForce-0.25)/0.25, 1., 0.);
-            else if(aLForce >= 0.1)
-            return vec3(0., 1., (0.25-aLForce)/0.15);
+            else if(lForce >= 1.5)
+            return vec3((2-lForce)/0.5, 0., (2-lForce)/0.5);
+            else if(lForce >= 1.)
+            return vec3(1., 0., (lForce-1.0)/0.5);
+            else if(lForce >= 0.5)
+            return vec3(1., (1.0-lForce)/0.5, 0);
+            else if(lForce >= 0.25)
+            return vec3((lForce-0.25)/0.25, 1., 0.);
+            else if(lForce >= 0.1)
+            return vec3(0., 1., (0.25-lForce)/0.15);
             else
-            return vec3(0., aLForce*10, 1.);
+            return vec3(0., lForce*10, 1.);
         case 5: // flexion
-            if(aFlex > 30.)
+            if(flexion > 30.)
             return vec3(0., 0., 0.);
-            else if(aFlex >= 6)
-            return vec3((30-aFlex)/24, 0., (30-aFlex)/24);
-            else if(aFlex >= 4.5)
-            return vec3(1., 0., (aFlex-4.5)/1.5);
-            else if(aFlex >= 3.5)
-            return vec3(1., (4.5-aFlex)/1, 0);
-            else if(aFlex >= 2.5)
-            return vec3((aFlex-2.5)/1, 1., 0.);
-            else if(aFlex >= 1.0)
-            return vec3(0., 1., (2.5-aFlex)/1.5);
+            else if(flexion >= 6)
+            return vec3((30-flexion)/24, 0., (30-flexion)/24);
+            else if(flexion >= 4.5)
+            return vec3(1., 0., (flexion-4.5)/1.5);
+            else if(flexion >= 3.5)
+            return vec3(1., (4.5-flexion)/1, 0);
+            else if(flexion >= 2.5)
+            return vec3((flexion-2.5)/1, 1., 0.);
+            else if(flexion >= 1.0)
+            return vec3(0., 1., (2.5-flexion)/1.5);
             else
-            return vec3(0., aFlex, 1.);
+            return vec3(0., flexion, 1.);
     }
 }
 
 void main(void)
 {
+    vec4 metric = vec4(0.), metric2 = vec4(0.);
+    if(aNode >= 0) {
+        int m = 2*(aNode/metricStep);
+        metric = texelFetch(metricTex, m);
+        metric2 = texelFetch(metricTex, m+1);
+    }
+    vel = metric.x;
+    roll = metric.y;
+    nForce = metric.z;
+    lForce = metric.w;
+    flexion = metric2.x;
     color = getColor();
     bPosition = anchorBase * vec4(aPosition, 1);
     gl_Position = projectionMatrix * modelMatrix * bPosition;
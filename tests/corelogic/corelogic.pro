@@ -1,7 +1,6 @@
 TEMPLATE = lib
-CONFIG += staticlib
-QT += core widgets
-QT -= gui
+CONFIG += staticlib c++17
+QT += core gui widgets
 
 TARGET = corelogic
 
@@ -9,9 +8,31 @@ INCLUDEPATH += $$PWD/../.. $$PWD/../../core
 
 SOURCES += \
     ../../core/mnode.cpp \
-    ../../core/exportfuncs.cpp
+    ../../core/exportfuncs.cpp \
+    ../../core/logging.cpp \
+    ../../core/section.cpp \
+    ../../core/function.cpp \
+    ../../core/subfunction.cpp \
+    ../../core/secforced.cpp \
+    ../../core/secgeometric.cpp \
+    ../../core/sectionkernel.cpp \
+    ../../core/sectioncache.cpp \
+    ../../core/sectionsweep.cpp \
+    ../../core/smoothhandler.cpp \
+    ../../core/tracknodes.cpp
 
 HEADERS += \
     ../../core/mnode.h \
     ../../core/exportfuncs.h \
+    ../../core/logging.h \
+    ../../core/section.h \
+    ../../core/function.h \
+    ../../core/subfunction.h \
+    ../../core/secforced.h \
+    ../../core/secgeometric.h \
+    ../../core/sectionkernel.h \
+    ../../core/sectioncache.h \
+    ../../core/sectionsweep.h \
+    ../../core/smoothhandler.h \
+    ../../core/track.h \
     ../../lenassert.h
@@ -5,6 +5,10 @@
 
 #include "mnode.h"
 #include "exportfuncs.h"
+#include "track.h"
+#include "sectionkernel.h"
+#include "sectioncache.h"
+#include "legacysections.h"
 
 class CoreLogicTests : public QObject
 {
@@ -14,6 +18,12 @@ private slots:
     void curveExportProducesExpectedControlPoints();
     void smoothForceCalculationMatchesFixture();
     void exporterSerializesBezierList();
+    void nodeSpanFollowsSampleRate();
+    void kernelMatchesLegacyLoops_data();
+    void kernelMatchesLegacyLoops();
+    void adaptiveStaysWithinTolerance_data();
+    void adaptiveStaysWithinTolerance();
+    void sectionCacheEvictsLeastRecentlyUsed();
 };
 
 void CoreLogicTests::curveExportProducesExpectedControlPoints()
@@ -119,5 +129,253 @@ void CoreLogicTests::exporterSerializesBezierList()
     qDeleteAll(bezierList);
 }
 
+void CoreLogicTests::nodeSpanFollowsSampleRate()
+{
+    const float projectRate = fSampleRate;
+
+    fSampleRate = F_HZ_DEFAULT;
+    QCOMPARE(nodeSpan(0.02f), 20);
+    QCOMPARE(nodeSpan(0.4f), 400);
+
+    fSampleRate = F_HZ_MAX;
+    QCOMPARE(nodeSpan(0.02f), 80);
+
+    fSampleRate = F_HZ_MIN;
+    QCOMPARE(nodeSpan(0.02f), 2);
+    QCOMPARE(nodeSpan(0.001f), 1);
+    QCOMPARE(nodeSpan(0.f), 1);
+
+    // the graph slopes cover the same time at every rate
+    for (float rate = F_HZ_MIN; rate <= F_HZ_MAX; rate += 100.f) {
+        fSampleRate = rate;
+        QVERIFY(qAbs(nodeSpan(0.02f)/rate - 0.02f) <= 0.5f/rate);
+    }
+
+    fSampleRate = projectRate;
+}
+
+// the anchor a new track starts with
+static void addAnchor(track* _track, float _heart)
+{
+    _track->fHeart = _heart;
+    _track->anchorNode = new mnode({0.f, 0.f, 0.f}, {0.f, 0.f, -1.f}, 0.f, 20.f, 1.f, 0.f);
+    _track->anchorNode->updateNorm();
+    _track->anchorNode->fEnergy = 0.5f*20.f*20.f + F_G*_track->anchorNode->fPosHearty(0.9f*_heart);
+}
+
+// two transitions in every function, the second roll transition returns to zero
+static section* addSection(track* _track, secType _type, bool _argument, bool _orientation, bool _legacy)
+{
+    section* sec;
+    if (_type == forced) {
+        sec = _legacy ? new legacyForced(_track, _track->anchorNode, 1000) : new secforced(_track, _track->anchorNode, 1000);
+    } else {
+        sec = _legacy ? new legacyGeometric(_track, _track->anchorNode, 1000) : new secgeometric(_track, _track->anchorNode, 1000);
+    }
+    _track->lSections.append(sec);
+    sec->bCache = false;
+    sec->bArgument = _argument;
+    sec->bOrientation = _orientation;
+
+    // seconds or meters, the values are per second or per meter
+    const float span = _argument == TIME ? 1.f : 20.f;
+    const float scale = _argument == TIME ? 1.f : 0.05f;
+    const float normal = _type == forced ? 0.5f : 10.f*scale;
+    const float lateral = _type == forced ? 0.2f : 8.f*scale;
+    const float roll = 60.f*scale;
+
+    func* funcs[] = {sec->normForce, sec->latForce, sec->rollFunc};
+    const float changes[] = {normal, lateral, roll};
+    for (int f = 0; f < 3; ++f) {
+        funcs[f]->funcList[0]->update(0.f, span, changes[f]);
+        funcs[f]->appendSubFunction(span, 0);
+        funcs[f]->funcList[1]->update(span, 2.f*span, -changes[f]);
+    }
+    sec->rollFunc->funcList[1]->changeDegree(tozero);
+    sec->rollFunc->translateValues(sec->rollFunc->funcList[0]);
+    return sec;
+}
+
+static bool sameNode(const mnode &_a, const mnode &_b)
+{
+    return glm::distance(_a.vPos, _b.vPos) < 1e-4f
+        && glm::distance(_a.vDir, _b.vDir) < 1e-5f
+        && glm::distance(_a.vLat, _b.vLat) < 1e-5f
+        && qAbs(_a.fVel - _b.fVel) < 1e-4f
+        && qAbs(_a.fRoll - _b.fRoll) < 1e-3f
+        && qAbs(_a.fRollSpeed - _b.fRollSpeed) < 1e-3f
+        && qAbs(_a.fTotalLength - _b.fTotalLength) < 1e-4f
+        && qAbs(_a.forceNormal - _b.forceNormal) < 1e-3f
+        && qAbs(_a.forceLateral - _b.forceLateral) < 1e-3f;
+}
+
+void CoreLogicTests::kernelMatchesLegacyLoops_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("argument");
+    QTest::addColumn<bool>("orientation");
+
+    QTest::newRow("forced time quaternion") << (int)forced << TIME << QUATERNION;
+    QTest::newRow("forced time euler") << (int)forced << TIME << EULER;
+    QTest::newRow("forced distance quaternion") << (int)forced << DISTANCE << QUATERNION;
+    QTest::newRow("forced distance euler") << (int)forced << DISTANCE << EULER;
+    QTest::newRow("geometric time quaternion") << (int)geometric << TIME << QUATERNION;
+    QTest::newRow("geometric time euler") << (int)geometric << TIME << EULER;
+    QTest::newRow("geometric distance quaternion") << (int)geometric << DISTANCE << QUATERNION;
+    QTest::newRow("geometric distance euler") << (int)geometric << DISTANCE << EULER;
+}
+
+void CoreLogicTests::kernelMatchesLegacyLoops()
+{
+    QFETCH(int, type);
+    QFETCH(bool, argument);
+    QFETCH(bool, orientation);
+
+    const float projectTolerance = fAdaptiveTolerance;
+    fAdaptiveTolerance = 0.f;
+
+    track kernelTrack, legacyTrack;
+    addAnchor(&kernelTrack, 1.1f);
+    addAnchor(&legacyTrack, 1.1f);
+    section* kernel = addSection(&kernelTrack, (secType)type, argument, orientation, false);
+    section* legacy = addSection(&legacyTrack, (secType)type, argument, orientation, true);
+
+    QCOMPARE(kernel->updateSection(0), legacy->updateSection(0));
+    QCOMPARE(kernel->lNodes.size(), legacy->lNodes.size());
+    QVERIFY(kernel->lNodes.size() > 100);
+    for (int i = 0; i < kernel->lNodes.size(); ++i) {
+        QVERIFY2(sameNode(kernel->lNodes.at(i), legacy->lNodes.at(i)), qPrintable(QString("node %1 differs").arg(i)));
+    }
+    QVERIFY(qAbs(kernel->length - legacy->length) < 1e-3f);
+
+    // a later update starts in the middle of the section
+    const int node = kernel->lNodes.size()/2;
+    kernel->rollFunc->funcList[0]->update(0.f, kernel->rollFunc->funcList[0]->maxArgument, 30.f*(argument == TIME ? 1.f : 0.05f));
+    legacy->rollFunc->funcList[0]->update(0.f, legacy->rollFunc->funcList[0]->maxArgument, 30.f*(argument == TIME ? 1.f : 0.05f));
+    QCOMPARE(kernel->updateSection(node), legacy->updateSection(node));
+    QCOMPARE(kernel->lNodes.size(), legacy->lNodes.size());
+    for (int i = 0; i < kernel->lNodes.size(); ++i) {
+        QVERIFY2(sameNode(kernel->lNodes.at(i), legacy->lNodes.at(i)), qPrintable(QString("node %1 differs after a partial update").arg(i)));
+    }
+
+    fAdaptiveTolerance = projectTolerance;
+}
+
+void CoreLogicTests::adaptiveStaysWithinTolerance_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<bool>("orientation");
+
+    QTest::newRow("forced quaternion") << (int)forced << QUATERNION;
+    QTest::newRow("forced euler") << (int)forced << EULER;
+    QTest::newRow("geometric quaternion") << (int)geometric << QUATERNION;
+    QTest::newRow("geometric euler") << (int)geometric << EULER;
+}
+
+// the nodes between the accepted steps are resampled onto the 1/F_HZ grid, they have to stay as close to the fixed steps as the ride tolerances
+void CoreLogicTests::adaptiveStaysWithinTolerance()
+{
+    QFETCH(int, type);
+    QFETCH(bool, orientation);
+
+    const float projectTolerance = fAdaptiveTolerance;
+
+    track fixedTrack, adaptiveTrack;
+    addAnchor(&fixedTrack, 1.1f);
+    addAnchor(&adaptiveTrack, 1.1f);
+    section* fixed = addSection(&fixedTrack, (secType)type, TIME, orientation, false);
+    section* adaptive = addSection(&adaptiveTrack, (secType)type, TIME, orientation, false);
+
+    fAdaptiveTolerance = 0.f;
+    fixed->updateSection(0);
+    fAdaptiveTolerance = 1e-4f;
+    adaptive->updateSection(0);
+    fAdaptiveTolerance = projectTolerance;
+
+    QCOMPARE(adaptive->lNodes.size(), fixed->lNodes.size());
+    const float length = qMax(fixed->length, 1.f);
+    for (int i = 1; i < adaptive->lNodes.size(); ++i) {
+        const mnode &node = adaptive->lNodes.at(i);
+        QVERIFY2(glm::distance(node.vPos, fixed->lNodes.at(i).vPos) <= RATE_TOL_POSITION*length, qPrintable(QString("node %1 drifted").arg(i)));
+        QVERIFY2(node.fTotalLength > adaptive->lNodes.at(i-1).fTotalLength, qPrintable(QString("node %1 does not advance").arg(i)));
+        QVERIFY(qAbs(glm::length(node.vDir) - 1.f) < 1e-4f);
+        QVERIFY(qAbs(glm::dot(node.vDir, node.vLat)) < 1e-4f);
+    }
+    // the tozero roll transition starts from the finished nodes in front of it and levels the track out
+    QVERIFY(qAbs(adaptive->lNodes.last().fRoll - fixed->lNodes.last().fRoll) < 0.5f);
+    QVERIFY(compareRides(QTest::currentDataTag(), summarizeRide(&fixedTrack), summarizeRide(&adaptiveTrack)));
+}
+
+void CoreLogicTests::sectionCacheEvictsLeastRecentlyUsed()
+{
+    const qint64 projectBudget = getSectionCacheBudget();
+    const float projectTolerance = fAdaptiveTolerance;
+    fAdaptiveTolerance = 0.f;
+    clearSectionCache();
+    setSectionCacheBudget((qint64)SECTION_CACHE_BUDGET*1024*1024);
+
+    track cacheTrack;
+    addAnchor(&cacheTrack, 1.1f);
+    section* sec = addSection(&cacheTrack, forced, TIME, QUATERNION, false);
+    sec->bCache = true;
+    // three variants of the section, only the change of the first normal force transition differs
+    auto integrateVariant = [sec](float _normal) {
+        sec->normForce->funcList[0]->update(0.f, sec->normForce->funcList[0]->maxArgument, _normal);
+        sec->updateSection(0);
+    };
+
+    sectioncachestats_t start = getSectionCacheStats();
+    integrateVariant(0.5f);
+    const QVector<mnode> integrated = sec->lNodes;
+    sectioncachestats_t stats = getSectionCacheStats();
+    QCOMPARE(stats.misses, start.misses + 1);
+    QCOMPARE(stats.hits, start.hits);
+    QCOMPARE(stats.entries, 1);
+    QVERIFY(stats.bytes > integrated.size()*(qint64)sizeof(mnode));
+    const qint64 entryBytes = stats.bytes;
+
+    // restored nodes are the integrated ones
+    integrateVariant(0.5f);
+    stats = getSectionCacheStats();
+    QCOMPARE(stats.hits, start.hits + 1);
+    QCOMPARE(sec->lNodes.size(), integrated.size());
+    for (int i = 0; i < integrated.size(); ++i) {
+        QVERIFY2(sameNode(sec->lNodes.at(i), integrated.at(i)), qPrintable(QString("node %1 differs").arg(i)));
+    }
+
+    // room for two entries, the third one pushes out the least recently used
+    setSectionCacheBudget(entryBytes*5/2);
+    integrateVariant(0.6f);
+    integrateVariant(0.5f);
+    integrateVariant(0.7f);
+    stats = getSectionCacheStats();
+    QCOMPARE(stats.entries, 2);
+    QVERIFY(stats.bytes <= stats.budget);
+    QCOMPARE(stats.hits, start.hits + 2);
+    QCOMPARE(stats.misses, start.misses + 3);
+
+    integrateVariant(0.5f);
+    QCOMPARE(getSectionCacheStats().hits, start.hits + 3);
+    integrateVariant(0.7f);
+    QCOMPARE(getSectionCacheStats().hits, start.hits + 4);
+    integrateVariant(0.6f);
+    stats = getSectionCacheStats();
+    QCOMPARE(stats.misses, start.misses + 4);
+    QCOMPARE(stats.entries, 2);
+    QVERIFY(stats.bytes <= stats.budget);
+
+    // a budget of zero drops everything and turns the cache off
+    setSectionCacheBudget(0);
+    stats = getSectionCacheStats();
+    QCOMPARE(stats.entries, 0);
+    QCOMPARE(stats.bytes, (qint64)0);
+    integrateVariant(0.5f);
+    QCOMPARE(getSectionCacheStats().misses, stats.misses);
+    QCOMPARE(getSectionCacheStats().entries, 0);
+
+    setSectionCacheBudget(projectBudget);
+    fAdaptiveTolerance = projectTolerance;
+}
+
 QTEST_MAIN(CoreLogicTests)
 #include "corelogic_tests.moc"
@@ -1,12 +1,15 @@
 TEMPLATE = app
-QT += testlib core widgets
-QT -= gui
-CONFIG += c++11
+QT += testlib core gui widgets
+CONFIG += c++17
 
 TARGET = corelogic_tests
 
 SOURCES += \
-    corelogic_tests.cpp
+    corelogic_tests.cpp \
+    legacysections.cpp
+
+HEADERS += \
+    legacysections.h
 
 INCLUDEPATH += $$PWD/../.. $$PWD/../../core
 
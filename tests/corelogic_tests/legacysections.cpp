@@ -0,0 +1,646 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// the four update loops of secforced and secgeometric as they were before sectionkernel.cpp replaced them,
+// kept verbatim as the reference of the kernel tests
+
+#include "legacysections.h"
+#include "exportfuncs.h"
+
+int legacyForced::updateSection(int node)
+{
+    if(rollFunc->lockedFunc() != -1) {
+        if(fabs(rollFunc->funcList.last()->symArg) > 0.00001f && rollFunc->funcList.last()->minArgument*F_HZ < node) node = F_HZ*rollFunc->funcList.last()->minArgument-1.5f;
+    }
+    if(normForce->lockedFunc() != -1) {
+        if(fabs(normForce->funcList.last()->symArg) > 0.00001f && normForce->funcList.last()->minArgument*F_HZ < node) node = F_HZ*normForce->funcList.last()->minArgument-1.5f;
+    }
+    if(latForce->lockedFunc() != -1) {
+        if(fabs(latForce->funcList.last()->symArg) > 0.00001f && latForce->funcList.last()->minArgument*F_HZ < node) node = F_HZ*latForce->funcList.last()->minArgument-1.5f;
+    }
+
+
+    if(bArgument == DISTANCE) {
+        return updateDistanceSection(node);
+    }
+
+    node = node > lNodes.size()-2 ? lNodes.size()-2 : node;
+    node = node < 0 ? 0 : node;
+
+    int numNodes = (int)(getMaxArgument()*F_HZ+0.5);
+    iTime = numNodes;
+
+    if(node >= lNodes.size()-1 && node > 0) node = lNodes.size()-2;
+
+    if(lNodes.size() > 1 && this->parent->lSections.at(this->parent->lSections.size()-1) != this) {
+        lNodes.removeLast(); // disjoint this section from the next one
+    }
+
+    if(node == 0) {
+		lNodes[0].updateNorm();
+
+		float diff = lNodes[0].forceNormal; // - normForce->funcList.at(0)]-startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        normForce->funcList.at(0)->translateValues(diff);
+        normForce->translateValues(normForce->funcList.at(0));
+
+		diff = lNodes[0].forceLateral; // - latForce->funcList.at(0)]-startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        latForce->funcList.at(0)->translateValues(diff);
+        latForce->translateValues(latForce->funcList.at(0));
+
+		diff = lNodes[0].fRollSpeed; // - rollFunc->funcList.at(0)]-startValue;
+        if(bOrientation == 1) {
+			diff += glm::dot(lNodes[0].vDir, glm::vec3(0.f, 1.f, 0.f))*lNodes[0].getYawChange();
+        }
+        rollFunc->funcList.at(0)->translateValues(diff);
+        rollFunc->translateValues(rollFunc->funcList.at(0));
+    }
+
+    int i;
+    for(i = node; i < numNodes; i++)
+    {
+        if(i >= lNodes.size()-1) {
+			lNodes.append(lNodes[i]);
+        }
+
+		mnode* prevNode = &lNodes[i];
+		mnode* curNode = &lNodes[i+1];
+        curNode->vPos = prevNode->vPos;
+        curNode->fVel = prevNode->fVel;
+        curNode->fEnergy = prevNode->fEnergy;
+
+        glm::vec3 forceVec = - normForce->getValue((i+1)/F_HZ) * prevNode->vNorm - latForce->getValue((i+1)/F_HZ) * prevNode->vLat - glm::vec3(0.f, 1.f, 0.f);
+
+        curNode->forceNormal = normForce->getValue((i+1)/F_HZ);
+        curNode->forceLateral = latForce->getValue((i+1)/F_HZ);
+
+		float nForce = - glm::dot(forceVec, glm::normalize(prevNode->vNorm))*F_G;
+		float lForce = - glm::dot(forceVec, glm::normalize(prevNode->vLat))*F_G;
+
+        float estVel = fabs(prevNode->fHeartDistFromLast) < std::numeric_limits<float>::epsilon() ? prevNode->fVel : prevNode->fHeartDistFromLast*F_HZ;
+
+        curNode->vDir = glm::normalize(glm::angleAxis(nForce/F_HZ/estVel, prevNode->vLat) * glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vDir);
+        curNode->vLat = glm::normalize(glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vLat);
+
+        curNode->updateNorm();
+
+        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ)) + prevNode->vDir*(curNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+        curNode->fRollSpeed = 0.f;
+        curNode->setRoll(rollFunc->getValue((i+1)/F_HZ)/F_HZ); // - rollFunc->getValue(i/1000.f));
+        calcDirFromLast(i+1);
+        if(bOrientation == EULER || rollFunc->getSubfunc((i+1)/F_HZ)->degree == tozero) {
+            curNode->setRoll(glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast);
+            curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast*F_HZ;
+        }
+
+
+        curNode->updateNorm();
+
+        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
+        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
+        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
+        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
+        curNode->fRollSpeed += rollFunc->getValue((i+1)/F_HZ);  // /1000.f/curNode->fDistFromLast;
+
+        calcDirFromLast(i+1);
+        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
+        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
+        curNode->fAngleFromLast = forceAngle;
+
+        if(bSpeed) {
+            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
+			curNode->fVel = sqrt(2.f*(curNode->fEnergy-F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+        } else {
+            curNode->fVel = this->fVel;
+			curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
+        }
+
+
+        if(fabs(curNode->fAngleFromLast) < std::numeric_limits<float>::epsilon()) {
+            forceVec = glm::vec3(0.f, 1.f, 0.f);
+        } else {
+            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
+            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
+
+			forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
+        }
+        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
+        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
+
+    }
+    while(lNodes.size() > 1+i) {
+		//delete lNodes.at(1+i);
+        lNodes.removeAt(1+i);
+    }
+    if(lNodes.size()) {
+		length = lNodes.last().fTotalLength - lNodes.first().fTotalLength;
+    } else {
+        length = 0;
+    }
+    return node;
+}
+
+int legacyForced::updateDistanceSection(int node)
+{
+    node = node < 0 ? 0 : node;
+
+    int i = 0;
+    this->length = 0.f;
+    float hDist = 0.f;
+    while(length < (float)node/F_HZ && i+1 < lNodes.size()) {
+		hDist += lNodes[++i].fHeartDistFromLast;
+		length += lNodes[i].fDistFromLast;
+    }
+
+    if(i >= lNodes.size()-1 && i > 0) {
+        i = lNodes.size()-2;
+    }
+
+    if(lNodes.size() > 1 && this->parent->lSections.at(this->parent->lSections.size()-1) != this) {
+        lNodes.removeLast();
+    }
+
+    if(i == 0) {
+		lNodes[0].updateNorm();
+
+		float diff = lNodes[0].forceNormal; // - normForce->funcList.at(0)]-startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+		normForce->funcList[0]->translateValues(diff);
+		normForce->translateValues(normForce->funcList[0]);
+
+		diff = lNodes[0].forceLateral; // - latForce->funcList.at(0)]-startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        latForce->funcList.at(0)->translateValues(diff);
+        latForce->translateValues(latForce->funcList.at(0));
+
+		diff = lNodes[0].fRollSpeed/lNodes[0].fVel; // - rollFunc->funcList.at(0)]-startValue;
+        if(bOrientation == 1) {
+			diff += glm::dot(lNodes[0].vDir, glm::vec3(0.f, 1.f, 0.f))*lNodes[0].getYawChange()/lNodes[0].fVel;
+        }
+        rollFunc->funcList.at(0)->translateValues(diff);
+        rollFunc->translateValues(rollFunc->funcList.at(0));
+    }
+
+    //qDebug("deleting complete");
+
+    int retval = i;
+    float end = this->getMaxArgument();
+
+    while(length < end) {
+        if(i >= lNodes.size()-1) {
+			lNodes.append(lNodes[i]);
+        }
+
+		mnode* prevNode = &lNodes[i];
+		mnode* curNode = &lNodes[i+1];
+        curNode->vPos = prevNode->vPos;
+        curNode->fVel = prevNode->fVel;
+        curNode->fEnergy = prevNode->fEnergy;
+
+        glm::vec3 forceVec = - normForce->getValue(length+prevNode->fVel/F_HZ) * prevNode->vNorm - latForce->getValue(length+prevNode->fVel/F_HZ) * prevNode->vLat - glm::vec3(0.f, 1.f, 0.f);
+
+        curNode->forceNormal = normForce->getValue(length+prevNode->fVel/F_HZ);
+        curNode->forceLateral = latForce->getValue(length+prevNode->fVel/F_HZ);
+
+		float nForce = - glm::dot(forceVec, glm::normalize(prevNode->vNorm))*F_G;
+		float lForce = - glm::dot(forceVec, glm::normalize(prevNode->vLat))*F_G;
+
+        float estVel = fabs(prevNode->fHeartDistFromLast) < std::numeric_limits<float>::epsilon() ? prevNode->fVel : prevNode->fHeartDistFromLast*F_HZ;
+
+        curNode->vDir = glm::normalize(glm::angleAxis(nForce/F_HZ/estVel, prevNode->vLat) * glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vDir);
+        curNode->vLat = glm::normalize(glm::angleAxis(-lForce/prevNode->fVel/F_HZ, prevNode->vNorm) * prevNode->vLat);
+
+        curNode->updateNorm();
+
+        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ)) + prevNode->vDir*(curNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+        curNode->setRoll(rollFunc->getValue(length+curNode->fVel/F_HZ)*(curNode->fVel/F_HZ)); // - rollFunc->getValue(i/1000.f));
+
+        curNode->fRollSpeed = 0.f;
+		curNode->setRoll(rollFunc->getValue(length+prevNode->fVel/F_HZ)/F_HZ); // - rollFunc->getValue(i/1000.f));
+		calcDirFromLast(i+1);
+		if(bOrientation == EULER) {
+            curNode->setRoll(glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast);
+            curNode->fRollSpeed += glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->fYawFromLast*F_HZ;
+        }
+
+		curNode->updateNorm();
+
+        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
+        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
+        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
+        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
+        curNode->fRollSpeed += rollFunc->getValue(length+curNode->fVel/F_HZ) *curNode->fVel;  // /1000.f/curNode->fDistFromLast;
+
+        calcDirFromLast(i+1);
+        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
+        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
+        curNode->fAngleFromLast = forceAngle;
+
+        if(bSpeed) {
+            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
+			curNode->fVel = sqrt(2.f*(curNode->fEnergy-F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+        } else {
+            curNode->fVel = this->fVel;
+			curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
+        }
+
+        if(fabs(curNode->fAngleFromLast) < std::numeric_limits<float>::epsilon()) {
+            forceVec = glm::vec3(0.f, 1.f, 0.f);
+        } else {
+            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
+            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
+
+			forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
+        }
+        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
+        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
+
+        this->length += curNode->fDistFromLast;
+        ++i;
+    }
+    while(lNodes.size() > 1+i) {
+		//delete lNodes.at(1+i);
+        lNodes.removeAt(1+i);
+    }
+    if(lNodes.size()) {
+		length = lNodes.last().fTotalLength - lNodes.first().fTotalLength;
+    } else {
+        length = 0;
+    }
+    return retval;
+}
+
+int legacyGeometric::updateSection(int node)
+{
+    if(rollFunc->lockedFunc() != -1) {
+        if(fabs(rollFunc->funcList.last()->symArg) > 0.00001f && rollFunc->funcList.last()->minArgument*F_HZ < node) node = F_HZ*rollFunc->funcList.last()->minArgument-1.5f;
+    }
+    if(normForce->lockedFunc() != -1) {
+        if(fabs(normForce->funcList.last()->symArg) > 0.00001f && normForce->funcList.last()->minArgument*F_HZ < node) node = F_HZ*normForce->funcList.last()->minArgument-1.5f;
+    }
+    if(latForce->lockedFunc() != -1) {
+        if(fabs(latForce->funcList.last()->symArg) > 0.00001f && latForce->funcList.last()->minArgument*F_HZ < node) node = F_HZ*latForce->funcList.last()->minArgument-1.5f;
+    }
+
+    if(bArgument == DISTANCE) {
+        return updateDistanceSection(node);
+    }
+
+    node = node > lNodes.size()-2 ? lNodes.size()-2 : node;
+    node = node < 0 ? 0 : node;
+
+    int numNodes = (int)(getMaxArgument()*F_HZ+0.5);
+    iTime = numNodes;
+
+    if(node >= lNodes.size()-1 && node > 0) {
+        node = lNodes.size()-2;
+    }
+
+    if(lNodes.size() > 1 && this->parent->lSections.at(this->parent->lSections.size()-1) != this) {
+        lNodes.removeLast(); // disjoint this section from the next one
+    }
+
+    if(node == 0) {
+		lNodes[0].updateNorm();
+
+		float diff = lNodes[0].getPitchChange(); // - normForce->funcList.at(0)->startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        normForce->funcList.at(0)->translateValues(diff);
+        normForce->translateValues(normForce->funcList.at(0));
+
+		diff = lNodes[0].getYawChange(); // - latForce->funcList.at(0)->startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        latForce->funcList.at(0)->translateValues(diff);
+        latForce->translateValues(latForce->funcList.at(0));
+
+		diff = lNodes[0].fRollSpeed; // - rollFunc->funcList.at(0)->startValue;
+        if(bOrientation == 1) {
+			diff += glm::dot(lNodes[0].vDir, glm::vec3(0.f, 1.f, 0.f))*lNodes[0].getYawChange();
+        }
+        rollFunc->funcList.at(0)->translateValues(diff);
+        rollFunc->translateValues(rollFunc->funcList.at(0));
+    }
+
+	float artificialRoll = lNodes[0].fRoll;
+    for(int i = 0; i < node; ++i) {
+        if(bOrientation == 0) {
+			artificialRoll -= glm::dot(lNodes[i+1].vDir, glm::vec3(0.f, -1.f, 0.f))*latForce->getValue((i+1)/F_HZ)/F_HZ;
+        }
+        artificialRoll += rollFunc->getValue((i+1)/F_HZ)/F_HZ;
+        while(artificialRoll > 180.f) {
+            artificialRoll -= 360.f;
+        }
+        while(artificialRoll < -180.f) {
+            artificialRoll += 360.f;
+        }
+    }
+
+    int i;
+    for(i = node; i < numNodes; i++) {
+        if(i >= lNodes.size()-1) {
+			lNodes.append(lNodes[i]);
+        }
+
+		mnode* prevNode = &lNodes[i];
+		mnode* curNode = &lNodes[i+1];
+
+        curNode->vPos = prevNode->vPos;
+        curNode->vDir = prevNode->vDir;
+        curNode->vLat = prevNode->vLat;
+        curNode->vNorm = prevNode->vNorm;
+        curNode->fVel = prevNode->fVel;
+        curNode->fEnergy = prevNode->fEnergy;
+
+        float pitchChange = normForce->getValue((i+1)/F_HZ)/F_HZ;
+        float yawChange = latForce->getValue((i+1)/F_HZ)/F_HZ;
+        int sign = 1;
+        if(fabs(artificialRoll) >= 90.f) {
+            sign = -1;
+        }
+
+        curNode->changePitch(pitchChange, sign == -1);
+        curNode->changeYaw(yawChange);
+
+        float pureYawChange = (1.f-fabs(glm::dot(curNode->vDir, glm::vec3(0.f, 1.f, 0.f))))*yawChange;
+        float pureRollChange = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yawChange*F_HZ;
+        float deltaAngle = sqrt(pitchChange*pitchChange + pureYawChange*pureYawChange);
+
+        curNode->setRoll(-pureRollChange/F_HZ);
+        artificialRoll -= pureRollChange/F_HZ;
+
+        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ))+prevNode->vDir*(prevNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+        curNode->updateNorm();
+
+        curNode->setRoll(rollFunc->getValue((i+1)/F_HZ)/F_HZ); //rollFunc->getValue((float)(i+1)/numNodes*fAngle)); //360./numNodes*(i+1));
+
+        if(bOrientation == EULER  || rollFunc->getSubfunc((i+1)/F_HZ)->degree == tozero) {
+            curNode->setRoll(+pureRollChange/F_HZ);
+            artificialRoll += pureRollChange/F_HZ;
+        }
+
+        artificialRoll += rollFunc->getValue((i+1)/F_HZ)/F_HZ;
+        while(artificialRoll > 180.f) {
+            artificialRoll -= 360.f;
+        }
+        while(artificialRoll < -180.f) {
+            artificialRoll += 360.f;
+        }
+        curNode->updateNorm();
+
+        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
+        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
+        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
+        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
+        curNode->fRollSpeed = rollFunc->getValue((i+1)/F_HZ);
+
+        if(bOrientation == EULER  || rollFunc->getSubfunc((i+1)/F_HZ)->degree == tozero) {
+            curNode->fRollSpeed += pureRollChange;
+        }
+
+
+        if(bSpeed) {
+            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
+            curNode->fVel = sqrt(2.f*(curNode->fEnergy-9.80665*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+        } else {
+            curNode->fVel = this->fVel;
+            curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
+        }
+
+
+        calcDirFromLast(i+1);
+        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
+        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
+        curNode->fAngleFromLast = forceAngle;
+
+        glm::vec3 forceVec;
+        if(fabs(deltaAngle) < std::numeric_limits<float>::epsilon()) {
+            forceVec = glm::vec3(0.f, 1.f, 0.f);
+        } else {
+            float normalDAngle = F_PI/180.f*(- curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
+            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
+
+            forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
+        }
+        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
+        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
+    }
+    while(lNodes.size() > 1+i) {
+		//delete lNodes.at(1+i);
+        lNodes.removeAt(1+i);
+    }
+	if(lNodes.size()) length = lNodes.last().fTotalLength - lNodes.first().fTotalLength;
+    else length = 0;
+    return node;
+}
+
+int legacyGeometric::updateDistanceSection(int node)
+{
+    node = node < 0 ? 0 : node;
+
+    int i = 0;
+    this->length = 0.f;
+    float hDist = 0.f;
+	float artificialRoll = lNodes[(0)].fRoll;
+    while(length < (float)node/F_HZ && i+1 < lNodes.size()) {
+		hDist += lNodes[++i].fHeartDistFromLast;
+		length += lNodes[i].fDistFromLast;
+
+        if(bOrientation == 0) {
+			artificialRoll -= glm::dot(lNodes[i].vDir, glm::vec3(0.f, -1.f, 0.f))*latForce->getValue(length + lNodes[i].fVel/F_HZ)*lNodes[i].fVel/F_HZ;
+        }
+
+		artificialRoll += rollFunc->getValue(length + lNodes[i].fVel/F_HZ)*(lNodes[i].fVel/F_HZ);
+        while(artificialRoll > 180.f) {
+            artificialRoll -= 360.f;
+        }
+        while(artificialRoll < -180.f) {
+            artificialRoll += 360.f;
+        }
+    }
+
+    if(i >= lNodes.size()-1  && i > 0) {
+        i = lNodes.size()-2;
+    }
+
+    if(lNodes.size() > 1 && this->parent->lSections.at(this->parent->lSections.size()-1) != this) {
+        lNodes.removeLast(); // disjoint this section from the next one
+    }
+
+    if(i == 0) {
+		lNodes[(0)].updateNorm();
+
+		float diff = lNodes[0].getPitchChange()/lNodes[0].fVel; // - normForce->funcList.at(0)->startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        normForce->funcList.at(0)->translateValues(diff);
+        normForce->translateValues(normForce->funcList.at(0));
+
+		diff = lNodes[0].getYawChange()/lNodes[0].fVel; // - latForce->funcList.at(0)->startValue;
+        lenAssert(diff==diff);
+        if(diff != diff) {
+			lNodes.append(lNodes[0]);
+            return node;
+        }
+        latForce->funcList.at(0)->translateValues(diff);
+        latForce->translateValues(latForce->funcList.at(0));
+
+		diff = lNodes[0].fRollSpeed/lNodes[0].fVel; // - rollFunc->funcList.at(0)->startValue;
+        if(bOrientation == 1) {
+			diff += glm::dot(lNodes[0].vDir, glm::vec3(0.f, 1.f, 0.f))*lNodes[0].getYawChange()/lNodes[0].fVel;
+        }
+        rollFunc->funcList.at(0)->translateValues(diff);
+        rollFunc->translateValues(rollFunc->funcList.at(0));
+    }
+
+    int returnval = i;
+    float end = this->getMaxArgument();
+
+    while(length < end) {
+        if(i >= lNodes.size()-1) {
+			lNodes.append(lNodes[i]);
+        }
+
+		mnode* prevNode = &lNodes[i];
+		mnode* curNode = &lNodes[i+1];
+
+        curNode->vPos = prevNode->vPos;
+        curNode->vDir = prevNode->vDir;
+        curNode->vLat = prevNode->vLat;
+        curNode->vNorm = prevNode->vNorm;
+        curNode->fVel = prevNode->fVel;
+        curNode->fEnergy = prevNode->fEnergy;
+
+        float pitchChange = normForce->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ);
+        float yawChange = latForce->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ);
+        int sign = 1;
+        if(fabs(artificialRoll) >= 90.f) {
+            sign = -1;
+        }
+
+
+        curNode->changePitch(pitchChange, sign == -1);
+        curNode->changeYaw(yawChange);
+
+        float pureYawChange = (1.f-fabs(glm::dot(curNode->vDir, glm::vec3(0.f, 1.f, 0.f))))*yawChange;
+        float pureRollChange = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yawChange*F_HZ;
+        float deltaAngle = sqrt(pitchChange*pitchChange + pureYawChange*pureYawChange);
+
+        curNode->setRoll(-pureRollChange/F_HZ);
+        artificialRoll -= pureRollChange/F_HZ;
+
+        curNode->vPos += curNode->vDir*(curNode->fVel/(2.f*F_HZ))+prevNode->vDir*(prevNode->fVel/(2.f*F_HZ)) + (prevNode->vPosHeart(parent->fHeart) - curNode->vPosHeart(parent->fHeart));
+
+        curNode->updateNorm();
+
+        curNode->setRoll(rollFunc->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ)); //rollFunc->getValue((float)(i+1)/numNodes*fAngle)); //360./numNodes*(i+1));
+
+        if(bOrientation == EULER) {
+            curNode->setRoll(pureRollChange/F_HZ);
+            artificialRoll += pureRollChange/F_HZ;
+        }
+
+        artificialRoll += rollFunc->getValue(length + curNode->fVel/F_HZ)*(curNode->fVel/F_HZ);
+        while(artificialRoll > 180.f) {
+            artificialRoll -= 360.f;
+        }
+        while(artificialRoll < -180.f) {
+            artificialRoll += 360.f;
+        }
+
+        curNode->fDistFromLast = glm::distance(curNode->vPosHeart(parent->fHeart), prevNode->vPosHeart(parent->fHeart));
+        curNode->fTotalLength = prevNode->fTotalLength + curNode->fDistFromLast;
+        curNode->fHeartDistFromLast = glm::distance(curNode->vPos, prevNode->vPos);
+        curNode->fTotalHeartLength = prevNode->fTotalHeartLength + curNode->fHeartDistFromLast;
+        curNode->fRollSpeed = rollFunc->getValue(length + curNode->fVel/F_HZ)*curNode->fVel;
+
+        if(bOrientation == 1) {
+            curNode->fRollSpeed += pureRollChange;
+        }
+
+        if(bSpeed) {
+            curNode->fEnergy -= (curNode->fVel*curNode->fVel*curNode->fVel/F_HZ * parent->fResistance);
+            curNode->fVel = sqrt(2.f*(curNode->fEnergy-9.80665*(curNode->vPosHeart(parent->fHeart*0.9f).y+curNode->fTotalLength*parent->fFriction)));
+        } else {
+            curNode->fVel = this->fVel;
+            curNode->fEnergy = 0.5*fVel*fVel + F_G*(curNode->vPosHeart(parent->fHeart*0.9f).y + curNode->fTotalLength*parent->fFriction);
+        }
+
+
+        calcDirFromLast(i+1);
+        float temp = cos(fabs(curNode->getPitch())*F_PI/180.f);
+        float forceAngle = sqrt(temp*temp*curNode->fYawFromLast*curNode->fYawFromLast + curNode->fPitchFromLast*curNode->fPitchFromLast);//deltaAngle;
+        curNode->fAngleFromLast = forceAngle;
+
+        glm::vec3 forceVec;
+        if(fabs(deltaAngle) < std::numeric_limits<float>::epsilon()) {
+            forceVec = glm::vec3(0.f, 1.f, 0.f);
+        } else {
+            float normalDAngle = F_PI/180.f*(-curNode->fPitchFromLast * cos(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*sin(curNode->fRoll*F_PI/180.));
+            float lateralDAngle = F_PI/180.f*(curNode->fPitchFromLast * sin(curNode->fRoll*F_PI/180.) - temp*curNode->fYawFromLast*cos(curNode->fRoll*F_PI/180.));
+
+            forceVec = glm::vec3(0.f, 1.f, 0.f) + lateralDAngle*curNode->fVel*F_HZ/F_G * curNode->vLat + normalDAngle*curNode->fHeartDistFromLast*F_HZ*F_HZ/F_G * curNode->vNorm;
+        }
+        curNode->forceNormal = - glm::dot(forceVec, glm::normalize(curNode->vNorm));
+        curNode->forceLateral = - glm::dot(forceVec, glm::normalize(curNode->vLat));
+
+        this->length += curNode->fDistFromLast;
+        if(curNode->fVel < 0.01) break;
+        ++i;
+    }
+    while(lNodes.size() > 1+i) {
+		//delete lNodes.at(1+i);
+        lNodes.removeAt(1+i);
+    }
+    if(lNodes.size()) {
+		length = lNodes.last().fTotalLength - lNodes.first().fTotalLength;
+    } else {
+        length = 0;
+    }
+    return returnval;
+}
@@ -0,0 +1,42 @@
+#ifndef LEGACYSECTIONS_H
+#define LEGACYSECTIONS_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "secforced.h"
+#include "secgeometric.h"
+
+// sections integrated by their own loops instead of integrateSection()
+class legacyForced : public secforced
+{
+public:
+    legacyForced(track* getParent, mnode* first, float getlength = 10.0) : secforced(getParent, first, getlength) {}
+    virtual int updateSection(int node = 0);
+    int updateDistanceSection(int node = 0);
+};
+
+class legacyGeometric : public secgeometric
+{
+public:
+    legacyGeometric(track* getParent, mnode* first, float getlength = 10.0) : secgeometric(getParent, first, getlength) {}
+    virtual int updateSection(int node = 0);
+    int updateDistanceSection(int node = 0);
+};
+
+#endif // LEGACYSECTIONS_H
@@ -47,4 +47,5 @@ void dragLabel::mouseMoveEvent(QMouseEvent *event)
     x += deltax;
     y += deltay;
     move(x, y);
+    emit moved();
 }
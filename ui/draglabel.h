@@ -29,7 +29,7 @@ public:
     bool isDragged;
 
 signals:
-    
+    void moved();
 public slots:
 
 protected:
@@ -99,6 +99,7 @@ void exportUi::doExport()
     float fRollThresh = sin(ui->relThresBox->value()*F_PI/180.f);
 
     track* tTrack = project->trackList[curTrackIndex]->trackData;
+    tTrack->materializeTrack();
 
     if (!fileName.isEmpty()) {
         this->cFile = fileName.toLocal8Bit().data();
@@ -148,6 +149,7 @@ void exportUi::doExport2()
     float fRollThresh = sin(ui->relThresBox->value()*F_PI/180.f);
 
     track* tTrack = project->trackList[curTrackIndex]->trackData;
+    tTrack->materializeTrack();
 
     if (!fileName.isEmpty()) {
         this->cFile = fileName.toLocal8Bit().data();
@@ -195,6 +197,7 @@ void exportUi::doNL2Export()
     fPerNode = ui->segmentLengthBox->value();
 
     track* tTrack = project->trackList[curTrackIndex]->trackData;
+    tTrack->materializeTrack();
 
     if (!fileName.isEmpty()) {
         this->cFile = fileName.toLocal8Bit().data();
@@ -21,6 +21,7 @@
 #include "trackhandler.h"
 #include "lenassert.h"
 #include "qcustomplot.h"
+#include <algorithm>
 
 graphHandler::graphHandler(QTreeWidgetItem* _treeItem, enum graphType _type, trackHandler* _track, QCPAxis* _axis, QColor* _color)
 {
@@ -48,41 +49,271 @@ graphHandler::graphHandler(QTreeWidgetItem* _treeItem, enum graphType _type, tra
     treeItem->setBackgroundColor(1, backColor);
 }
 
-void graphHandler::fillGraphList(QCPAxis* xAxis, bool _argument, bool _orientation, bool _drawExterns)
+graphSamples::graphSamples(trackHandler* _track)
 {
-    const unsigned max_segments_per_transition = 10000;
+    mTrack = _track;
+    valid = false;
+    mArgument = TIME;
+    mOrientation = QUATERNION;
+    mNumPoints = 0;
+}
+
+void graphSamples::invalidate()
+{
+    valid = false;
+}
 
-    mnode* curNode = mTrack->trackData->anchorNode, *prevNode = NULL;
+void graphSamples::update(bool _argument, bool _orientation)
+{
     track* curTrack = mTrack->trackData;
-    QVector<double> x, y;
+    int numPoints = curTrack->getNumPoints();
+
+    if(valid && mArgument == _argument && mOrientation == _orientation && mNumPoints == numPoints && sectionStart.size() == curTrack->lSections.size()+1) {
+        return;
+    }
+    valid = true;
+    mArgument = _argument;
+    mOrientation = _orientation;
+    mNumPoints = numPoints;
+
+    QVector<mnode*> nodes;
+    keys.resize(0);
+    sectionStart.resize(0);
+    for(int i = 0; i <= smoothedLForce; ++i) {
+        columns[i].resize(0);
+        pyramid[i].resize(0);
+        levelStart[i].resize(0);
+    }
+
+    // the first node of a section is the last node of the section before
+    for(int i = 0; i < curTrack->lSections.size(); ++i) {
+        section* curSection = curTrack->lSections[i];
+        sectionStart.append(nodes.size() ? nodes.size()-1 : 0);
+        for(int k = nodes.size() ? 1 : 0; k < curSection->lNodes.size(); ++k) {
+            nodes.append(curSection->readNode(k));
+        }
+    }
+    sectionStart.append(nodes.size() ? nodes.size()-1 : 0);
+
+    keys.resize(nodes.size());
+    for(int i = 0; i <= smoothedLForce; ++i) {
+        columns[i].resize(nodes.size());
+    }
+
+    // one pass over the nodes fills every column, the slopes are taken over 20 ms whatever the rate
+    const int window = nodeSpan(0.02f);
+    for(int j = 0; j < nodes.size(); ++j) {
+        mnode* curNode = nodes[j], *prevNode;
+        unsigned int diff;
+        if(j >= window) {
+            prevNode = nodes[j-window];
+            diff = window;
+        } else {
+            prevNode = nodes[j];
+            diff = 1;
+        }
+
+        float yaw = curNode->getYawChange();
+        float speed = curNode->fRollSpeed;
+        float smoothedSpeed = curNode->fRollSpeed + curNode->fSmoothSpeed;
+        float rollChange = curNode->fRollSpeed + curNode->fSmoothSpeed - prevNode->fRollSpeed - prevNode->fSmoothSpeed;
+        if(_orientation != QUATERNION) {
+            float eulerSpeed = glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*yaw;
+            speed -= eulerSpeed;
+            smoothedSpeed -= eulerSpeed;
+            rollChange = rollChange - eulerSpeed + glm::dot(prevNode->vDir, glm::vec3(0.f, -1.f, 0.f))*prevNode->getYawChange();
+        }
+        float normChange = curNode->forceNormal + curNode->smoothNormal - prevNode->forceNormal - prevNode->smoothNormal;
+        float latChange = curNode->forceLateral + curNode->smoothLateral - prevNode->forceLateral - prevNode->smoothLateral;
+
+        columns[banking][j] = curNode->fRoll;
+        columns[nForce][j] = curNode->forceNormal;
+        columns[smoothedNForce][j] = curNode->forceNormal + curNode->smoothNormal;
+        columns[lForce][j] = curNode->forceLateral;
+        columns[smoothedLForce][j] = curNode->forceLateral + curNode->smoothLateral;
+
+        if(_argument == TIME) {
+            keys[j] = j/F_HZ;
+            columns[rollSpeed][j] = speed;
+            columns[smoothedRollSpeed][j] = smoothedSpeed;
+            columns[rollAccel][j] = rollChange*F_HZ/diff;
+            columns[nForceChange][j] = normChange*F_HZ/diff;
+            columns[lForceChange][j] = latChange*F_HZ/diff;
+            columns[pitchChange][j] = curNode->getPitchChange();
+            columns[yawChange][j] = yaw;
+        } else {
+            double dist = curNode->fTotalLength - prevNode->fTotalLength;
+            if(dist < std::numeric_limits<double>::epsilon()){
+                dist = 0.0001;
+            }
+            keys[j] = curNode->fTotalLength;
+            columns[rollSpeed][j] = speed/curNode->fVel;
+            columns[smoothedRollSpeed][j] = smoothedSpeed/curNode->fVel;
+            columns[rollAccel][j] = rollChange/curNode->fVel/dist;
+            columns[nForceChange][j] = normChange/dist;
+            columns[lForceChange][j] = latChange/dist;
+            columns[pitchChange][j] = curNode->getPitchChange()/curNode->fVel;
+            columns[yawChange][j] = yaw/curNode->fVel;
+        }
+    }
+
+    for(int i = 0; i <= smoothedLForce; ++i) {
+        if(i != secBoundaries && i != povPos) buildPyramid((enum graphType)i);
+    }
+}
+
+void graphSamples::buildPyramid(enum graphType _type)
+{
+    const QVector<double>& column = columns[_type];
+    QVector<int>& levels = pyramid[_type];
+
+    // level 0 are the nodes themselves, every level above stores the index of the minimum and maximum
+    // of two buckets of the level below, -1 if there are only NaNs in it
+    int count = column.size(), from = -1;
+    while(count > 1) {
+        int buckets = (count+1)/2;
+        int start = levels.size();
+        levelStart[_type].append(start);
+        levels.resize(start + 2*buckets);
+        for(int b = 0; b < buckets; ++b) {
+            int minIdx = -1, maxIdx = -1;
+            for(int c = 2*b; c < 2*b+2 && c < count; ++c) {
+                int lower, upper;
+                if(from < 0) {
+                    lower = upper = column[c] == column[c] ? c : -1;
+                } else {
+                    lower = levels[from+2*c];
+                    upper = levels[from+2*c+1];
+                }
+                if(lower >= 0 && (minIdx < 0 || column[lower] < column[minIdx])) minIdx = lower;
+                if(upper >= 0 && (maxIdx < 0 || column[upper] > column[maxIdx])) maxIdx = upper;
+            }
+            levels[start+2*b] = minIdx;
+            levels[start+2*b+1] = maxIdx;
+        }
+        from = start;
+        count = buckets;
+    }
+}
+
+void graphSamples::appendPair(const QVector<double> &column, int a, int b, int &last, QVector<double> &x, QVector<double> &y)
+{
+    // the points go out in node order, so the keys never run backwards and no node is sent twice
+    if(a > b) {
+        int temp = a;
+        a = b;
+        b = temp;
+    }
+    if(a > last && column[a] == column[a]) {
+        x.append(keys[a]);
+        y.append(column[a]);
+        last = a;
+    }
+    if(b > last && column[b] == column[b]) {
+        x.append(keys[b]);
+        y.append(column[b]);
+        last = b;
+    }
+}
+
+void graphSamples::appendRange(const QVector<double> &column, int from, int to, int &last, QVector<double> &x, QVector<double> &y)
+{
+    int minIdx = -1, maxIdx = -1;
+    for(int j = from; j <= to; ++j) {
+        if(column[j] != column[j]) continue;
+        if(minIdx < 0 || column[j] < column[minIdx]) minIdx = j;
+        if(maxIdx < 0 || column[j] > column[maxIdx]) maxIdx = j;
+    }
+    if(minIdx >= 0) appendPair(column, minIdx, maxIdx, last, x, y);
+}
+
+void graphSamples::decimate(enum graphType _type, int _section, QCPAxis* xAxis, QVector<double> &x, QVector<double> &y)
+{
+    x.clear();
+    y.clear();
+    if(keys.isEmpty()) return;
+    const QVector<double>& column = columns[_type];
+
+    int first = sectionStart[_section], last = sectionStart[_section+1];
+    if(_section == sectionStart.size()-2 && last > first) {
+        --last;
+    }
+
+    int lower = std::lower_bound(keys.begin()+first, keys.begin()+last+1, xAxis->range().lower) - keys.begin() - 1;
+    int upper = std::upper_bound(keys.begin()+first, keys.begin()+last+1, xAxis->range().upper) - keys.begin();
+    lower = lower < first ? first : lower;
+    upper = upper > last ? last : upper;
+
+    // the section ends are always kept, so the key range of the graph stays right
+    int sent = -1;
+    appendPair(column, first, first, sent, x, y);
+    if(lower >= upper) {
+        appendPair(column, last, last, sent, x, y);
+        return;
+    }
+
+    int pixels = (int)fabs(xAxis->coordToPixel(keys[upper]) - xAxis->coordToPixel(keys[lower]));
+    pixels = pixels > xAxis->axisRect()->width() ? xAxis->axisRect()->width() : pixels;
+    pixels = pixels < 1 ? 1 : pixels;
+
+    int level = 0;
+    while(((upper-lower+1) >> level) > pixels && level < levelStart[_type].size()) {
+        ++level;
+    }
+
+    if(level == 0) {
+        x.reserve(upper-lower+3);
+        y.reserve(upper-lower+3);
+        for(int j = lower; j <= upper; ++j) {
+            appendPair(column, j, j, sent, x, y);
+        }
+        appendPair(column, last, last, sent, x, y);
+        return;
+    }
 
-    while(graphList.size() > 0) {
-        delete graphList[0];
-        graphList.removeAt(0);
+    // one min/max pair per pixel, the buckets at both ends reach out of the visible nodes and are scanned directly
+    const QVector<int>& levels = pyramid[_type];
+    int start = levelStart[_type][level-1];
+    int b0 = lower >> level, b1 = upper >> level;
+
+    x.reserve(2*(b1-b0)+6);
+    y.reserve(2*(b1-b0)+6);
+    appendRange(column, lower, ((b0+1) << level)-1 < upper ? ((b0+1) << level)-1 : upper, sent, x, y);
+    for(int b = b0+1; b < b1; ++b) {
+        if(levels[start+2*b] >= 0) appendPair(column, levels[start+2*b], levels[start+2*b+1], sent, x, y);
     }
+    if(b1 > b0) appendRange(column, b1 << level, upper, sent, x, y);
+    appendPair(column, last, last, sent, x, y);
+}
+
+void graphHandler::fillGraphList(graphSamples* _samples, QCPAxis* xAxis, bool _argument, bool _orientation, bool _drawExterns)
+{
+    int used = 0;
+    QVector<double> x, y;
 
     if(mType == secBoundaries) {
-        if(mTrack->trackData->activeSection) fillBoundaryGraphList(xAxis, _argument);
+        if(mTrack->trackData->activeSection) fillBoundaryGraphList(xAxis, _argument, used);
+        dropGraphs(used);
         return;
     }
 
+    _samples->update(_argument, _orientation);
+
     for(int i = 0; i < mTrack->trackData->lSections.size(); ++i) {
         x.clear();
         y.clear();
         if(active && mTrack->trackData->activeSection == mTrack->trackData->lSections[i]) {
-            fillActiveGraphList(xAxis, _argument, _drawExterns);
+            fillActiveGraphList(xAxis, _argument, _drawExterns, used);
             continue;
         }
         else if(!_drawExterns && mTrack->trackData->activeSection != mTrack->trackData->lSections[i]) {
             continue;
         }
 
-        QCPGraph* curGraph = new QCPGraph(xAxis, usedAxis);
-
-        graphList.append(curGraph);
+        QCPGraph* curGraph = nextGraph(xAxis, used);
 
         /*
-         *  Set Colors and Style of the new graph
+         *  Set Colors and Style of the graph
          */
         if(mType == nForceChange || mType == lForceChange || mType == banking || mType == rollAccel){
             curGraph->setPen(QPen(color[0], 1, Qt::DashDotLine));
@@ -106,159 +337,39 @@ void graphHandler::fillGraphList(QCPAxis* xAxis, bool _argument, bool _orientati
             curGraph->setBrush(QBrush(brush));
         }
 
-        section* curSection = mTrack->trackData->lSections[i];
-
-        unsigned int n1 = curTrack->getNumPoints(curSection);
-        unsigned int n2 = n1 + curSection->lNodes.size()-1;
-        unsigned int step = (n2-n1)/max_segments_per_transition;
-        step = step < 50 ? 50 : step;
-
-        if(curTrack->lSections.size()-1 == i && n2) {
-            --n2;
-        }
-        unsigned int diff;
-
-        for(unsigned int j = n1; j < n2+step; j+=step) {
-            j = j > n2+step ? n2 : j;
-
-            if(j > 19) {
-                prevNode = curTrack->getPoint(j-20);
-                diff = 20;
-            } else {
-                prevNode = curTrack->getPoint(j);
-                diff = 1;
-            }
-
-            curNode = curTrack->getPoint(j);
-            if(_argument == TIME) {
-                x.append(j/F_HZ);
-            } else {
-                x.append(curNode->fTotalLength);
-            }
+        _samples->decimate(mType, i, xAxis, x, y);
+        curGraph->setProperty("p", qVariantFromValue((void*)NULL));
+        curGraph->setData(x, y);
+        curGraph->setSelectable(false);
+    }
+    dropGraphs(used);
+}
 
-            if(_argument == TIME) {
-                switch(mType) {
-                case banking:
-                    y.append(curNode->fRoll);
-                    break;
-                case rollSpeed:
-                    if(_orientation == QUATERNION) {
-                        y.append(curNode->fRollSpeed);
-                    } else {
-                        y.append(curNode->fRollSpeed - glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->getYawChange());
-                    }
-                    break;
-                case smoothedRollSpeed:
-                    if(_orientation == QUATERNION) {
-                        y.append(curNode->fRollSpeed + curNode->fSmoothSpeed);
-                    } else {
-                        y.append(curNode->fRollSpeed + curNode->fSmoothSpeed - glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->getYawChange());
-                    }
-                    break;
-                case rollAccel:
-                    if(_orientation == QUATERNION) {
-                        y.append((curNode->fRollSpeed + curNode->fSmoothSpeed - prevNode->fRollSpeed - prevNode->fSmoothSpeed)*F_HZ/diff);
-                    } else {
-                        y.append((curNode->fRollSpeed + curNode->fSmoothSpeed - prevNode->fRollSpeed - prevNode->fSmoothSpeed - glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->getYawChange() + glm::dot(prevNode->vDir, glm::vec3(0.f, -1.f, 0.f))*prevNode->getYawChange())*F_HZ/diff);
-                    }
-                    break;
-                case nForce:
-                    y.append(curNode->forceNormal);
-                    break;
-                case smoothedNForce:
-                    y.append(curNode->forceNormal + curNode->smoothNormal);
-                    break;
-                case nForceChange:
-                    y.append((curNode->forceNormal + curNode->smoothNormal - prevNode->forceNormal - prevNode->smoothNormal)*F_HZ/diff);
-                    break;
-                case lForce:
-                    y.append(curNode->forceLateral);
-                    break;
-                case smoothedLForce:
-                    y.append(curNode->forceLateral + curNode->smoothLateral);
-                    break;
-                case lForceChange:
-                    y.append((curNode->forceLateral + curNode->smoothLateral - prevNode->forceLateral - prevNode->smoothLateral)*F_HZ/diff);
-                    break;
-                case pitchChange:
-                    y.append(curNode->getPitchChange());
-                    break;
-                case yawChange:
-                    y.append(curNode->getYawChange());
-                    break;
-                default:
-                    break;
-                }
-            } else {
-                double diff = curNode->fTotalLength - prevNode->fTotalLength;
-                if(diff < std::numeric_limits<double>::epsilon()){
-                    diff = 0.0001;
-                }
-                switch(mType) {
-                case banking:
-                    y.append(curNode->fRoll);
-                    break;
-                case rollSpeed:
-                    if(_orientation == QUATERNION) {
-                        y.append(curNode->fRollSpeed/curNode->fVel);
-                    } else {
-                        y.append((curNode->fRollSpeed - glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->getYawChange())/curNode->fVel);
-                    }
-                    break;
-                case smoothedRollSpeed:
-                    if(_orientation == QUATERNION) {
-                        y.append((curNode->fRollSpeed + curNode->fSmoothSpeed)/curNode->fVel);
-                    } else {
-                        y.append((curNode->fRollSpeed + curNode->fSmoothSpeed - glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->getYawChange())/curNode->fVel);
-                    }
-                    break;
-                case rollAccel:
-                    if(_orientation == QUATERNION) {
-                        y.append((curNode->fRollSpeed + curNode->fSmoothSpeed - prevNode->fRollSpeed - prevNode->fSmoothSpeed)/curNode->fVel/diff);
-                    } else {
-                        y.append((curNode->fRollSpeed + curNode->fSmoothSpeed - prevNode->fRollSpeed - prevNode->fSmoothSpeed - glm::dot(curNode->vDir, glm::vec3(0.f, -1.f, 0.f))*curNode->getYawChange() + glm::dot(prevNode->vDir, glm::vec3(0.f, -1.f, 0.f))*prevNode->getYawChange())/curNode->fVel/diff);
-                    }
-                    break;
-                case nForce:
-                    y.append(curNode->forceNormal);
-                    break;
-                case smoothedNForce:
-                    y.append(curNode->forceNormal + curNode->smoothNormal);
-                    break;
-                case nForceChange:
-                    y.append((curNode->forceNormal + curNode->smoothNormal - prevNode->forceNormal - prevNode->smoothNormal)/diff);
-                    break;
-                case lForce:
-                    y.append(curNode->forceLateral);
-                    break;
-                case smoothedLForce:
-                    y.append(curNode->forceLateral + curNode->smoothLateral);
-                    break;
-                case lForceChange:
-                    y.append((curNode->forceLateral + curNode->smoothLateral - prevNode->forceLateral - prevNode->smoothLateral)/diff);
-                    break;
-                case pitchChange:
-                    y.append(curNode->getPitchChange()/curNode->fVel);
-                    break;
-                case yawChange:
-                    y.append(curNode->getYawChange()/curNode->fVel);
-                    break;
-                default:
-                    break;
-                }
-            }
+QCPGraph* graphHandler::nextGraph(QCPAxis* xAxis, int &used)
+{
+    // graphs of the previous fill are reused, only their data is replaced
+    if(used < graphList.size()) {
+        return graphList[used++];
+    }
+    QCPGraph* curGraph = new QCPGraph(xAxis, usedAxis);
+    graphList.append(curGraph);
+    ++used;
+    return curGraph;
+}
 
-            if(y.last() != y.last()) {
-                y.pop_back();
-                x.pop_back();
-            }
+void graphHandler::dropGraphs(int used)
+{
+    while(graphList.size() > used) {
+        QCPGraph* curGraph = graphList.takeLast();
+        if(curGraph->parentPlot()->hasPlottable(curGraph)) {
+            curGraph->parentPlot()->removeGraph(curGraph);
+        } else {
+            delete curGraph;
         }
-        curGraph->setData(x, y);
-        curGraph->setSelectable(false);
     }
 }
 
-void graphHandler::fillActiveGraphList(QCPAxis *xAxis, bool _argument, bool _drawExterns)
+void graphHandler::fillActiveGraphList(QCPAxis *xAxis, bool _argument, bool _drawExterns, int &used)
 {
     const unsigned max_segs_per_active_transition = 160;
 
@@ -299,9 +410,7 @@ void graphHandler::fillActiveGraphList(QCPAxis *xAxis, bool _argument, bool _dra
 
         if(curFunc->locked) curFunc->getValue(-1.f); // make sure maxArg is right
 
-        curGraph = new QCPGraph(xAxis, usedAxis);
-
-        graphList.append(curGraph);
+        curGraph = nextGraph(xAxis, used);
 
         curGraph->setPen(QPen(color[0], 1));
         curGraph->setBrush(QBrush(color[1]));
@@ -340,29 +449,29 @@ void graphHandler::fillActiveGraphList(QCPAxis *xAxis, bool _argument, bool _dra
                 if(_argument == TIME) {
                     x.append(key/F_HZ+n);
                 } else {
-					x.append(curTrack->activeSection->lNodes[key].fTotalLength);
+					x.append(curTrack->activeSection->readNode(key)->fTotalLength);
                 }
 
                 switch(mType)
                 {
                 case rollSpeed:
                     if(curTrack->activeSection->bOrientation == EULER) {
-						y.append(curTrack->activeSection->lNodes[key].fRollSpeed + sin(curTrack->activeSection->lNodes[key].getPitch()*F_PI/180.)*curTrack->activeSection->lNodes[key].getYawChange());
+						y.append(curTrack->activeSection->readNode(key)->fRollSpeed + sin(curTrack->activeSection->readNode(key)->getPitch()*F_PI/180.)*curTrack->activeSection->readNode(key)->getYawChange());
                     } else {
-						y.append(curTrack->activeSection->lNodes[key].fRollSpeed);
+						y.append(curTrack->activeSection->readNode(key)->fRollSpeed);
                     }
                     break;
                 case nForce:
-					y.append(curTrack->activeSection->lNodes[key].forceNormal);
+					y.append(curTrack->activeSection->readNode(key)->forceNormal);
                     break;
                 case lForce:
-					y.append(curTrack->activeSection->lNodes[key].forceLateral);
+					y.append(curTrack->activeSection->readNode(key)->forceLateral);
                     break;
                 case pitchChange:
-					y.append(curTrack->activeSection->lNodes[key].getPitchChange());
+					y.append(curTrack->activeSection->readNode(key)->getPitchChange());
                     break;
                 case yawChange:
-					y.append(curTrack->activeSection->lNodes[key].getYawChange());
+					y.append(curTrack->activeSection->readNode(key)->getYawChange());
                     break;
                 default:
                     break;
@@ -370,7 +479,7 @@ void graphHandler::fillActiveGraphList(QCPAxis *xAxis, bool _argument, bool _dra
             }
         } else {
             if(_argument == DISTANCE) {
-				n = curTrack->activeSection->lNodes[0].fTotalLength;
+				n = curTrack->activeSection->readNode(0)->fTotalLength;
             }
             for(int j = 0; j < 251; ++j) {
                 double maxArg;
@@ -407,7 +516,7 @@ void graphHandler::fillActiveGraphList(QCPAxis *xAxis, bool _argument, bool _dra
     }
 }
 
-void graphHandler::fillBoundaryGraphList(QCPAxis *xAxis, bool _argument)
+void graphHandler::fillBoundaryGraphList(QCPAxis *xAxis, bool _argument, int &used)
 {
     QCPGraph* curGraph;
     QVector<double> x, y;
@@ -416,8 +525,7 @@ void graphHandler::fillBoundaryGraphList(QCPAxis *xAxis, bool _argument)
         x.clear();
         y.clear();
 
-        curGraph = new QCPGraph(xAxis, usedAxis);
-        graphList.append(curGraph);
+        curGraph = nextGraph(xAxis, used);
 
         curGraph->setPen(QPen(QColor(0, 0, 0, 150), 1, Qt::DashDotLine));
         curGraph->setBrush(QBrush(QColor(0, 0, 0, 20)));
@@ -427,8 +535,8 @@ void graphHandler::fillBoundaryGraphList(QCPAxis *xAxis, bool _argument)
             n1 = curTrack->getNumPoints(mTrack->trackData->lSections[i])/F_HZ;
             n2 = n1 + (mTrack->trackData->lSections[i]->lNodes.size()-1)/F_HZ;
         } else {
-			n1 = curTrack->lSections[i]->lNodes[0].fTotalLength;
-			n2 = curTrack->lSections[i]->lNodes.last().fTotalLength;
+			n1 = curTrack->lSections[i]->readNode(0)->fTotalLength;
+			n2 = curTrack->lSections[i]->lNodes.constLast().fTotalLength;
         }
         //if(curTrack->lSections.size()-1 == i) --n2;
 
@@ -451,8 +559,7 @@ void graphHandler::fillBoundaryGraphList(QCPAxis *xAxis, bool _argument)
         x.clear();
         y.clear();
 
-        curGraph = new QCPGraph(xAxis, usedAxis);
-        graphList.append(curGraph);
+        curGraph = nextGraph(xAxis, used);
 
         curGraph->setPen(QPen(QColor(0, 0, 0, 150), 1, Qt::DashDotLine));
         curGraph->setBrush(QBrush(QColor(0, 0, 0, 20)));
@@ -45,12 +45,42 @@ enum graphType
     smoothedLForce
 };
 
+// samples every plottable metric of a track in one pass, shared by all graph handlers of a graphWidget
+// every column keeps a min/max pyramid so a section can be decimated to the plot's pixel width
+class graphSamples
+{
+public:
+    graphSamples(trackHandler* _track);
+
+    void invalidate();
+    void update(bool _argument, bool _orientation);
+    void decimate(enum graphType _type, int _section, QCPAxis* xAxis, QVector<double> &x, QVector<double> &y);
+
+    QVector<double> keys;
+    QVector<int> sectionStart;
+
+private:
+    void buildPyramid(enum graphType _type);
+    void appendPair(const QVector<double> &column, int a, int b, int &last, QVector<double> &x, QVector<double> &y);
+    void appendRange(const QVector<double> &column, int from, int to, int &last, QVector<double> &x, QVector<double> &y);
+
+    QVector<double> columns[smoothedLForce+1];
+    QVector<int> pyramid[smoothedLForce+1];
+    QVector<int> levelStart[smoothedLForce+1];
+
+    trackHandler* mTrack;
+    bool valid;
+    bool mArgument;
+    bool mOrientation;
+    int mNumPoints;
+};
+
 class graphHandler
 {
 public:
     graphHandler(QTreeWidgetItem* _treeItem, enum graphType _type, trackHandler* _track, QCPAxis* _axis, QColor* _color);
 
-    void fillGraphList(QCPAxis* xAxis, bool _argument = TIME, bool _orientation = QUATERNION, bool _drawExterns = true);
+    void fillGraphList(graphSamples* _samples, QCPAxis* xAxis, bool _argument = TIME, bool _orientation = QUATERNION, bool _drawExterns = true);
 
     QTreeWidgetItem* treeItem;
     QColor color[4];
@@ -66,8 +96,10 @@ public:
     QCPAxis* usedAxis;
 
 private:
-    void fillActiveGraphList(QCPAxis* xAxis, bool _argument, bool _drawExterns);
-    void fillBoundaryGraphList(QCPAxis *xAxis, bool _argument);
+    void fillActiveGraphList(QCPAxis* xAxis, bool _argument, bool _drawExterns, int &used);
+    void fillBoundaryGraphList(QCPAxis *xAxis, bool _argument, int &used);
+    QCPGraph* nextGraph(QCPAxis* xAxis, int &used);
+    void dropGraphs(int used);
 };
 
 #endif // GRAPHHANDLER_H
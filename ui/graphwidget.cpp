@@ -24,6 +24,8 @@
 #include "draglabel.h"
 #include "lenassert.h"
 #include "smoothui.h"
+#include "undohandler.h"
+#include <QTimer>
 
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
@@ -40,6 +42,16 @@ graphWidget::graphWidget(QWidget *parent, trackHandler* _track) :
     selTrack = _track;
     selFunc = NULL;
 
+    pendingTrack = NULL;
+    pendingSection = NULL;
+    previewNode = refineNode = 0;
+    previewTimer = new QTimer(this);
+    previewTimer->setSingleShot(true);
+    refineTimer = new QTimer(this);
+    refineTimer->setSingleShot(true);
+    connect(previewTimer, SIGNAL(timeout()), this, SLOT(previewUpdate()));
+    connect(refineTimer, SIGNAL(timeout()), this, SLOT(refineUpdate()));
+
     this->setMaximumHeight(300);
     this->setMinimumHeight(200);
 
@@ -68,6 +80,9 @@ graphWidget::graphWidget(QWidget *parent, trackHandler* _track) :
         yAxes[i]->grid()->setZeroLinePen(QPen(QPen(QColor(220, 220, 220), 1)));
     }
 
+    mSamples = new graphSamples(selTrack);
+    refilling = false;
+
     pGraphList.append(new graphHandler(ui->selTree->topLevelItem(1)->child(0)->child(0), banking, selTrack, yAxes[0], gloParent->mOptions->rollColor));
     pGraphList.append(new graphHandler(ui->selTree->topLevelItem(1)->child(0)->child(1), rollSpeed, selTrack, yAxes[0], gloParent->mOptions->rollColor));
     pGraphList.append(new graphHandler(ui->selTree->topLevelItem(1)->child(0)->child(2), rollAccel, selTrack, yAxes[0], gloParent->mOptions->rollColor));
@@ -98,12 +113,14 @@ graphWidget::graphWidget(QWidget *parent, trackHandler* _track) :
     connect(ui->plotter, SIGNAL(mousePress(QMouseEvent*)), this, SLOT(MousePressedPlotter()));
     connect(ui->plotter, SIGNAL(mouseMove(QMouseEvent*)), this, SLOT(setPlotRanges()));
     connect(ui->plotter, SIGNAL(mouseWheel(QWheelEvent*)), this, SLOT(MouseWheelPlotter()));
+    connect(ui->plotter->xAxis, SIGNAL(rangeChanged(QCPRange)), this, SLOT(refillGraphs()));
 
     ui->plotter->setNotAntialiasedElement((QCP::AntialiasedElement)(0xFFFF ^ 0x0020), true);
     ui->plotter->setPlottingHint(QCP::phForceRepaint, true);
 
 
     connect(ui->plotter, SIGNAL(selectionChangedByUser()), this, SLOT(selectionChanged()));
+    connect(ui->plotter, SIGNAL(afterReplot()), this, SLOT(setBezPoints()));
     ui->tabWidget->removeTab(1);
 
     if(selTrack) {
@@ -121,6 +138,7 @@ graphWidget::~graphWidget()
     for(int i = 0; i < pGraphList.size(); ++i) {
         delete pGraphList[i];
     }
+    delete mSamples;
     delete ui;
 }
 
@@ -254,17 +272,17 @@ void graphWidget::drawGraph(int index)
     pGraphList[index]->drawn = true;
 
     if(selTrack->trackData->activeSection) {
-        pGraphList[index]->fillGraphList(ui->plotter->xAxis, selTrack->trackData->activeSection->bArgument, selTrack->trackData->activeSection->bOrientation, pGraphList[secBoundaries]->drawn);
+        pGraphList[index]->fillGraphList(mSamples, ui->plotter->xAxis, selTrack->trackData->activeSection->bArgument, selTrack->trackData->activeSection->bOrientation, pGraphList[secBoundaries]->drawn);
     } else {
-        pGraphList[index]->fillGraphList(ui->plotter->xAxis, TIME, QUATERNION, pGraphList[secBoundaries]->drawn);
+        pGraphList[index]->fillGraphList(mSamples, ui->plotter->xAxis, TIME, QUATERNION, pGraphList[secBoundaries]->drawn);
     }
 
     for(int i = 0; i < pGraphList[index]->graphList.size(); ++i) {
-        ui->plotter->addPlottable(pGraphList[index]->graphList[i]);
-        subfunc* temp = (subfunc*)pGraphList[index]->graphList[i]->property("p").value<void*>();
-        if(temp && temp == ui->transitionEditor->getSelectedFunc()) {
-            pGraphList[index]->graphList[i]->setSelected(true);
+        if(!ui->plotter->hasPlottable(pGraphList[index]->graphList[i])) {
+            ui->plotter->addPlottable(pGraphList[index]->graphList[i]);
         }
+        subfunc* temp = (subfunc*)pGraphList[index]->graphList[i]->property("p").value<void*>();
+        pGraphList[index]->graphList[i]->setSelected(temp && temp == ui->transitionEditor->getSelectedFunc());
     }
 }
 
@@ -274,7 +292,7 @@ bool graphWidget::drawPoVLine()
     bool changed = false;
     double coord;
     if(selTrack->trackData->activeSection && selTrack->trackData->activeSection->bArgument == DISTANCE) {
-         mnode* temp = selTrack->trackData->getPoint(gloParent->getPovPos());
+         mnode* temp = selTrack->trackData->readPoint(gloParent->getPovPos());
          if(temp) {
             coord = temp->fTotalLength;
          } else {
@@ -442,15 +460,16 @@ bool graphWidget::changeSelection(subfunc* _sel)
 
 void graphWidget::redrawGraphs(bool otherArgument)
 {
+    mSamples->invalidate();
     for(int i = 0; i < pGraphList.size(); ++i) {
         if(pGraphList[i]->drawn) {
             if(i%2 && (i-1)/2 >= 0 && (i-1)/2 < 3) {
-                undrawGraph(11+(i-1)/2);
                 if(selTrack->trackData->smoother && selTrack->trackData->smoother->active()) {
                     drawGraph(11+(i-1)/2);
+                } else {
+                    undrawGraph(11+(i-1)/2);
                 }
             }
-            undrawGraph(i);
             drawGraph(i);
         }
     }
@@ -463,8 +482,8 @@ void graphWidget::redrawGraphs(bool otherArgument)
         int maxPoints = curTrack->getNumPoints();
 
         if(curTrack->activeSection->bArgument == TIME) {
-            rLower = curTrack->getIndexFromDist(rLower)/1000.;
-            rUpper = curTrack->getIndexFromDist(rUpper)/1000.;
+            rLower = curTrack->getIndexFromDist(rLower)/F_HZ;
+            rUpper = curTrack->getIndexFromDist(rUpper)/F_HZ;
 
             double edge = (rUpper-rLower)/3.;
             rUpper += edge;
@@ -472,17 +491,17 @@ void graphWidget::redrawGraphs(bool otherArgument)
 
             ui->plotter->xAxis->setRange(rLower, rUpper);
         } else { // DISTANCE
-            rLower *= 1000.;
-            rUpper *= 1000.;
+            rLower *= F_HZ;
+            rUpper *= F_HZ;
 
             lenAssert(rLower < maxPoints);
 
             if(rLower <= 0.) {
-                rUpper = curTrack->getPoint(maxPoints <= rUpper ? maxPoints : rUpper)->fTotalLength;
+                rUpper = curTrack->readPoint(maxPoints <= rUpper ? maxPoints : rUpper)->fTotalLength;
                 rLower = 0.;
             } else {
-                rUpper = curTrack->getPoint(maxPoints <= rUpper ? maxPoints : rUpper)->fTotalLength;
-                rLower = curTrack->getPoint(rLower)->fTotalLength;
+                rUpper = curTrack->readPoint(maxPoints <= rUpper ? maxPoints : rUpper)->fTotalLength;
+                rLower = curTrack->readPoint(rLower)->fTotalLength;
             }
 
             double edge = (rUpper-rLower)/3.;
@@ -619,6 +638,7 @@ void graphWidget::keyPressEvent(QKeyEvent* event) {
 
 void graphWidget::setBezPoints()
 {
+    // called after every replot, the handles follow the axes and the selected function
     if(!selFunc || selFunc->degree != freeform) {
         if(bezPoints.size()) {
             for(int i = 0; i < bezPoints.size(); ++i) {
@@ -628,60 +648,142 @@ void graphWidget::setBezPoints()
         }
         return;
     }
-    if(selFunc && selFunc->degree == freeform) {
-        QCPAxis* yAxis;
-        switch(selFunc->parent->type) {
-        case funcRoll:
-            yAxis = yAxes[0];
-            break;
-        case funcNormal:
-        case funcLateral:
-            yAxis = yAxes[1];
-            break;
-        case funcPitch:
-            yAxis = yAxes[2];
-            break;
-        case funcYaw:
-            yAxis = yAxes[3];
-            break;
-        }
-
-        float until;
-        if(selFunc->parent->secParent->bArgument == TIME) {
-            until = selTrack->trackData->getNumPoints(selFunc->parent->secParent)/F_HZ;
-        } else {
-			until = selFunc->parent->secParent->lNodes.first().fTotalHeartLength;
-        }
-        int x1 = ui->plotter->xAxis->coordToPixel(selFunc->minArgument+until);
-        int x2 = ui->plotter->xAxis->coordToPixel(selFunc->maxArgument+until);
-        int y1 = yAxis->coordToPixel(selFunc->startValue);
-        int y2 = yAxis->coordToPixel(selFunc->startValue+selFunc->symArg);
-        if(selFunc->pointList.size() != bezPoints.size()) {
-            for(int i = 0; i < bezPoints.size(); ++i) {
-                delete bezPoints[i];
-            }
-            bezPoints.clear();
-            for(int i = 0; i < selFunc->pointList.size(); ++i) {
-                bezPoints.append(new dragLabel(ui->plotter));
-                bezPoints[i]->setText("x");
-                bezPoints[i]->setGeometry(QRect(0, 0, 12, 12));
-                bezPoints[i]->setAlignment(Qt::AlignCenter);
-                bezPoints[i]->show();
-            }
+    float until;
+    QCPAxis* yAxis = getBezAxis(until);
+    int x1 = ui->plotter->xAxis->coordToPixel(selFunc->minArgument+until);
+    int x2 = ui->plotter->xAxis->coordToPixel(selFunc->maxArgument+until);
+    int y1 = yAxis->coordToPixel(selFunc->startValue);
+    int y2 = yAxis->coordToPixel(selFunc->startValue+selFunc->symArg);
+    if(selFunc->pointList.size() != bezPoints.size()) {
+        for(int i = 0; i < bezPoints.size(); ++i) {
+            delete bezPoints[i];
         }
+        bezPoints.clear();
         for(int i = 0; i < selFunc->pointList.size(); ++i) {
-            if(bezPoints[i]->isDragged) {
-                selFunc->pointList[i].x = (ui->plotter->xAxis->pixelToCoord(bezPoints[i]->pos().x()+6)-selFunc->minArgument-until)/(selFunc->maxArgument-selFunc->minArgument);
-                selFunc->pointList[i].y = (yAxis->pixelToCoord(bezPoints[i]->pos().y()+6)-selFunc->startValue)/(selFunc->symArg);
-                selFunc->updateBez();
-                selTrack->trackData->updateTrack(selTrack->trackData->activeSection, (int)(selFunc->minArgument*F_HZ-1.5f));
-            } else {
-                int x = x1*(1-selFunc->pointList[i].x) + x2*selFunc->pointList[i].x-6;
-                int y = y1*(1-selFunc->pointList[i].y) + y2*selFunc->pointList[i].y-6;
-                bezPoints[i]->move(x, y);
-            }
+            bezPoints.append(new dragLabel(ui->plotter));
+            bezPoints[i]->setText("x");
+            bezPoints[i]->setGeometry(QRect(0, 0, 12, 12));
+            bezPoints[i]->setAlignment(Qt::AlignCenter);
+            bezPoints[i]->show();
+            connect(bezPoints[i], SIGNAL(moved()), this, SLOT(bezPointMoved()));
+        }
+    }
+    for(int i = 0; i < selFunc->pointList.size(); ++i) {
+        if(!bezPoints[i]->isDragged) {
+            int x = x1*(1-selFunc->pointList[i].x) + x2*selFunc->pointList[i].x-6;
+            int y = y1*(1-selFunc->pointList[i].y) + y2*selFunc->pointList[i].y-6;
+            bezPoints[i]->move(x, y);
         }
-        redrawGraphs();
     }
     return;
 }
+
+void graphWidget::bezPointMoved()
+{
+    if(!selFunc || selFunc->degree != freeform || selFunc->pointList.size() != bezPoints.size()) return;
+    float until;
+    QCPAxis* yAxis = getBezAxis(until);
+    bool moved = false;
+    for(int i = 0; i < selFunc->pointList.size(); ++i) {
+        if(bezPoints[i]->isDragged) {
+            selFunc->pointList[i].x = (ui->plotter->xAxis->pixelToCoord(bezPoints[i]->pos().x()+6)-selFunc->minArgument-until)/(selFunc->maxArgument-selFunc->minArgument);
+            selFunc->pointList[i].y = (yAxis->pixelToCoord(bezPoints[i]->pos().y()+6)-selFunc->startValue)/(selFunc->symArg);
+            moved = true;
+        }
+    }
+    if(!moved) return;
+    selFunc->updateBez();
+    requestUpdate((int)(selFunc->minArgument*F_HZ-1.5f));
+    redrawGraphs();
+}
+
+QCPAxis* graphWidget::getBezAxis(float& until)
+{
+    if(selFunc->parent->secParent->bArgument == TIME) {
+        until = selTrack->trackData->getNumPoints(selFunc->parent->secParent)/F_HZ;
+    } else {
+        until = selFunc->parent->secParent->lNodes.constFirst().fTotalHeartLength;
+    }
+    switch(selFunc->parent->type) {
+    case funcRoll:
+        return yAxes[0];
+    case funcNormal:
+    case funcLateral:
+        return yAxes[1];
+    case funcPitch:
+        return yAxes[2];
+    default:
+        return yAxes[3];
+    }
+}
+
+void graphWidget::requestUpdate(int fromNode)
+{
+    // edits made while dragging are coalesced, at most one preview of the edited section per frame
+    // and one full update of the track once the value stopped changing
+    track* curTrack = selTrack->trackData;
+    if(pendingTrack != NULL && (pendingTrack != curTrack || pendingSection != curTrack->activeSection)) {
+        refineUpdate();
+    }
+
+    if(previewTimer->isActive()) {
+        previewNode = previewNode < fromNode ? previewNode : fromNode;
+    } else {
+        previewNode = fromNode;
+        previewTimer->start(PREVIEW_INTERVAL);
+    }
+    if(pendingTrack != NULL) {
+        refineNode = refineNode < fromNode ? refineNode : fromNode;
+    } else {
+        refineNode = fromNode;
+    }
+    pendingTrack = curTrack;
+    pendingSection = curTrack->activeSection;
+
+    if(selTrack->mUndoHandler->busy) {
+        refineUpdate();
+        return;
+    }
+    refineTimer->start(REFINE_DELAY);
+}
+
+void graphWidget::previewUpdate()
+{
+    if(pendingTrack == NULL) return;
+    pendingTrack->previewTrack(pendingSection, previewNode);
+    if(pendingSection != NULL && pendingTrack->lSections.size() && pendingSection != pendingTrack->lSections.last()) {
+        gloParent->showMessage(tr("Sections behind %1 are updated once the value is released").arg(pendingSection->sName), REFINE_DELAY*2);
+    }
+    redrawGraphs();
+    gloParent->updateInfoPanel();
+}
+
+void graphWidget::refineUpdate()
+{
+    previewTimer->stop();
+    refineTimer->stop();
+    if(pendingTrack == NULL) return;
+
+    track* curTrack = pendingTrack;
+    pendingTrack = NULL;
+    if(curTrack->lSections.contains(pendingSection)) {
+        curTrack->updateTrack(pendingSection, refineNode);
+    } else {
+        curTrack->updateTrack(0, 0);
+    }
+    redrawGraphs();
+    gloParent->updateInfoPanel();
+}
+
+void graphWidget::refillGraphs()
+{
+    // the graphs are decimated to the visible range, so panning and zooming refills them from the cached samples
+    if(refilling || selTrack == NULL) return;
+    refilling = true;
+    for(int i = 0; i < pGraphList.size(); ++i) {
+        if(pGraphList[i]->drawn && i != povPos && i != secBoundaries) {
+            drawGraph(i);
+        }
+    }
+    refilling = false;
+}
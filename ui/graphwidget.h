@@ -27,6 +27,12 @@ class dragLabel;
 class transitionWidget;
 class sectionHandler;
 class QCPAxis;
+class QTimer;
+class track;
+class section;
+
+#define PREVIEW_INTERVAL 16
+#define REFINE_DELAY 250
 
 namespace Ui {
 class graphWidget;
@@ -48,6 +54,7 @@ public:
     void redrawGraphs(bool otherArgument = false);
     bool changeSelection(subfunc* _sel);
     void keyPressEvent(QKeyEvent* event);
+    void requestUpdate(int fromNode);
 
     trackHandler* selTrack;
     subfunc* selFunc;
@@ -65,12 +72,27 @@ public slots:
 
     void on_plotter_customContextMenuRequested(const QPoint &pos);
     void setBezPoints();
+    void bezPointMoved();
+    void previewUpdate();
+    void refineUpdate();
+    void refillGraphs();
 
 private:
+    QCPAxis* getBezAxis(float& until);
+
     Ui::graphWidget *ui;
     QList<graphHandler*> pGraphList;
+    graphSamples* mSamples;
+    bool refilling;
     QList<dragLabel*> bezPoints;
     bool phantomChanges;
+
+    QTimer* previewTimer;
+    QTimer* refineTimer;
+    track* pendingTrack;
+    section* pendingSection;
+    int previewNode;
+    int refineNode;
 };
 
 #endif // GRAPHWIDGET_H
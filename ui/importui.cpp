@@ -21,6 +21,7 @@
 #include "fstream"
 #include "exportfuncs.h"
 #include "trackhandler.h"
+#include "sectionsweep.h"
 #include "mainwindow.h"
 #include "lenassert.h"
 
@@ -43,10 +44,18 @@ importUi::importUi(QWidget *parent, QString _fileName) :
 
     fstream fin(fileName.toLocal8Bit().data(), ios::in | ios::binary);
     //lenAssert(fin != NULL && "input stream NULL");
+    sampleRate = F_HZ_DEFAULT;
     if(!fin) {
         return;
     }
 
+    string version;
+    if(readString(&fin, 3) == "FVD" && ((version = readString(&fin, 5)) == "v0.78" || version == "v0.79")) {
+        int namelength = readInt(&fin);
+        readString(&fin, namelength);
+        sampleRate = qBound(F_HZ_MIN, readFloat(&fin), F_HZ_MAX);
+    }
+
     fin.seekg (0, ios::end);
     int length = fin.tellg();
     int id = 0;
@@ -105,11 +114,24 @@ void importUi::on_buttonBox_accepted()
             --i;
         } else if(posList.size()) {
             fin.seekg(posList[i]);
+
             if(legacymode) {
+                // legacy tracks are integrated while they are read, at the sample rate they were saved with,
+                // the stubs of the project must not be warmed at that rate meanwhile
+                float projectRate = F_HZ;
+                stopWarming();
+                cancelSweeps();
+                fSampleRate = sampleRate;
                 trackList[i]->trackData->legacyLoadTrack(fin, trackList[i]->trackWidgetItem);
-
+                fSampleRate = projectRate;
+                warmTracks(gloParent->getTrackList());
+                if(sampleRate != projectRate) {
+                    trackList[i]->trackData->resample(sampleRate);
+                }
             } else {
-                trackList[i]->trackData->loadTrack(fin, trackList[i]->trackWidgetItem);
+                // only the parameters are read, the windows counted in nodes of the file are scaled before the first integration
+                trackList[i]->trackData->loadTrack(fin, trackList[i]->trackWidgetItem, false);
+                trackList[i]->trackData->resample(sampleRate);
             }
             ui->treeWidget->takeTopLevelItem(0);
         }
@@ -45,6 +45,7 @@ private:
     Ui::importUi *ui;
     QString fileName;
     bool legacymode;
+    float sampleRate;
 };
 
 #endif // IMPORTUI_H
@@ -36,6 +36,7 @@
 #include <QFileDialog>
 #include <QCloseEvent>
 #include "objectexporter.h"
+#include "sweepdialog.h"
 
 MainWindow* gloParent;
 glViewWidget* glView;
@@ -116,6 +117,9 @@ MainWindow::MainWindow(QWidget *parent) :
     mObjectExporter = new objectExporter(this);
     mObjectExporter->setWindowFlags(exportScreen->windowFlags());
 
+    mSweepDialog = new sweepDialog(this);
+    mSweepDialog->setWindowFlags(exportScreen->windowFlags());
+
     setUndoButtons();
     undoChanges = false;
 
@@ -130,20 +134,28 @@ MainWindow::MainWindow(QWidget *parent) :
     selectedFunc = NULL;
 
 
+    // the timer only checks whether anything changed, frames are rendered on demand
     QTimer *timer = new QTimer(this);
-    connect(timer, SIGNAL(timeout()), glView, SLOT(updateGL()));
-    connect(timer, SIGNAL(timeout()), this, SLOT(showCurInfoPanel()));
+    connect(timer, SIGNAL(timeout()), glView, SLOT(checkRedraw()));
 	timer->start(10);
+    glView->installEventFilter(glView);
 
     QTimer *autosave = new QTimer(this);
     connect(autosave, SIGNAL(timeout()), this, SLOT(doAutoSave()));
     autosave->start(1000*60);
 
+    // only tracks left alone for a while are compacted, not the one the user is about to open again
+    QTimer *compact = new QTimer(this);
+    connect(compact, SIGNAL(timeout()), this, SLOT(compactInactiveTracks()));
+    compact->start(COMPACT_IDLE/4);
+
     connect(this, SIGNAL(emitMessage(QString,int)), ui->statusBar, SLOT(showMessage(QString,int)));
+    connect(this, SIGNAL(emitTracksWarmed()), this, SLOT(finishWarmTracks()), Qt::QueuedConnection);
 }
 
 MainWindow::~MainWindow()
 {
+    stopWarming();
     delete ui;
     exit(0);
 }
@@ -407,6 +419,21 @@ void MainWindow::on_actionUseShader5_triggered()
     useShader(5);
 }
 
+void MainWindow::on_actionContinuousRendering_toggled(bool checked)
+{
+    glView->setContinuousMode(checked);
+}
+
+void MainWindow::on_actionGpuRails_toggled(bool checked)
+{
+    glView->setGpuRails(checked);
+}
+
+void MainWindow::on_actionGpuCrossties_toggled(bool checked)
+{
+    glView->setGpuCrossties(checked);
+}
+
 void MainWindow::useShader(int shader)
 {
     glView->curTrackShader = shader;
@@ -481,7 +508,7 @@ void MainWindow::updateInfoPanel()
     temp->updateSectionFrame();
     mnode* lastnode;
     if(curTrack()->lSections.size() != 0 && curTrack()->activeSection != NULL) {
-		lastnode = &curTrack()->activeSection->lNodes[curTrack()->activeSection->lNodes.size()-1];
+		lastnode = curTrack()->activeSection->readNode(curTrack()->activeSection->lNodes.size()-1);
 	} else {
         lastnode = curTrack()->anchorNode;
     }
@@ -583,6 +610,7 @@ void MainWindow::displayStatusMessage(QString message)
 void MainWindow::on_actionOptions_triggered()
 {
     mOptions->setGLVersionString(glView->getGLVersionString());
+    mOptions->updateCacheStats();
     mOptions->show();
 }
 
@@ -603,6 +631,9 @@ QString MainWindow::getCurrentFileName() {
 void MainWindow::openTab(trackHandler* _track)
 {
     this->setUpdatesEnabled(false);
+    if(_track->trackData->materializeTrack()) {
+        _track->graphWidgetItem->redrawGraphs();
+    }
     _track->trackWidgetItem->on_sectionListWidget_itemSelectionChanged();
     if(_track->tabId == -1) {
         _track->tabId = ui->tabChooser->addTab(_track->trackWidgetItem, _track->trackData->name);
@@ -634,6 +665,9 @@ void MainWindow::on_tabChooser_currentChanged(int index)
     if(index) {
         //this->updatesEnabled(false);
         trackWidget* widget = (trackWidget*)ui->tabChooser->widget(index);
+        if(widget->inTrack->trackData->materializeTrack()) {
+            widget->inTrack->graphWidgetItem->redrawGraphs();
+        }
         mGraphWidget = widget->inTrack->graphWidgetItem;
         ui->vertSplitter->insertWidget(1, mGraphWidget);
         mGraphWidget->show();
@@ -646,9 +680,33 @@ void MainWindow::on_tabChooser_currentChanged(int index)
         ui->tabChooser->setCurrentIndex(index);
     }
     setUndoButtons();
+    glView->hasChanged = true;
     phantomChanges = false;
 }
 
+// every track but the one of the current tab that was not used for COMPACT_IDLE ms, see track::compactTrack()
+void MainWindow::compactInactiveTracks()
+{
+    if(!mOptions->compactTracks) return;
+    track* active = curTrack();
+    QList<trackHandler*> trackList = getTrackList();
+    for(int i = 0; i < trackList.size(); ++i) {
+        if(trackList[i]->trackData == active) {
+            trackList[i]->lastUsed.start();
+            continue;
+        }
+        // the stubs are cold already, stubs and stale tracks may be held by a worker
+        if(trackList[i]->isStub || trackList[i]->isStale || trackList[i]->lastUsed.elapsed() < COMPACT_IDLE) continue;
+        trackList[i]->trackData->compactTrack();
+    }
+}
+
+// emitted by the workers of warmTracks()
+void MainWindow::finishWarmTracks()
+{
+    uploadWarmTracks();
+}
+
 void MainWindow::on_tabChooser_tabCloseRequested(int index)
 {
     if(!index) {
@@ -713,6 +771,15 @@ void MainWindow::on_actionExport_Model_As_triggered()
     mObjectExporter->show();
 }
 
+void MainWindow::on_actionParameter_Sweep_triggered()
+{
+    if(mSweepDialog->update()) {
+        mSweepDialog->show();
+    } else {
+        displayStatusMessage("Select a transition of a forced or geometric section to sweep it");
+    }
+}
+
 void MainWindow::on_actionExport_triggered()
 {
     if(exportScreen->updateBoxes()) {
@@ -70,6 +70,7 @@ class conversionPanel;
 class graphWidget;
 class trackHandler;
 class objectExporter;
+class sweepDialog;
 
 namespace Ui {
 class MainWindow;
@@ -120,6 +121,7 @@ public:
 
 signals:
     void emitMessage(QString msg, int msec = 5000);
+    void emitTracksWarmed();
 
 public slots:
     void showCurInfoPanel();
@@ -153,6 +155,11 @@ public slots:
 
     void on_actionUseShader5_triggered();
 
+    void on_actionContinuousRendering_toggled(bool checked);
+
+    void on_actionGpuRails_toggled(bool checked);
+    void on_actionGpuCrossties_toggled(bool checked);
+
     void on_actionUndo_triggered();
 
     void on_actionRedo_triggered();
@@ -168,14 +175,19 @@ public slots:
     void on_tabChooser_tabCloseRequested(int index);
 
     void doAutoSave();
+    void compactInactiveTracks();
 
     void showMessage(QString msg, int msec = 5000);
 
 private slots:
+    void finishWarmTracks();
+
     void on_actionExport_Model_As_triggered();
 
     void on_actionExport_triggered();
 
+    void on_actionParameter_Sweep_triggered();
+
 private:
     Ui::MainWindow *ui;
     void useShader(int shader);
@@ -186,6 +198,7 @@ private:
     exportUi* exportScreen;
     conversionPanel* mConversion;
     objectExporter* mObjectExporter;
+    sweepDialog* mSweepDialog;
 };
 
 
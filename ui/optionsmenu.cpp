@@ -25,6 +25,7 @@
 #include "glviewwidget.h"
 #include "mainwindow.h"
 #include "trackmesh.h"
+#include "sectioncache.h"
 
 extern MainWindow* gloParent;
 extern glViewWidget* glView;
@@ -34,6 +35,8 @@ optionsMenu::optionsMenu(QWidget *parent) :
     ui(new Ui::optionsMenu)
 {
     maxUndoChanges = 50000;
+    cacheBudget = SECTION_CACHE_BUDGET;
+    compactTracks = false;
     phantomChanges = false;
 
 #ifdef Q_OS_MAC
@@ -144,7 +147,10 @@ optionsMenu::optionsMenu(QWidget *parent) :
     ui->fovSlider->setValue(fov*10);
     ui->shadowModeBox->setCurrentIndex(shadowQuality);
     ui->meshQualityBox->setCurrentIndex(meshQuality);
+    ui->cacheBox->setValue(cacheBudget);
+    ui->compactBox->setChecked(compactTracks);
     phantomChanges = false;
+    setSectionCacheBudget((qint64)cacheBudget*1024*1024);
     this->ui->measureBox->setCurrentIndex(measures);
 #ifndef Q_OS_MAC // on Win / Unix
     this->ui->glBox->setCurrentIndex(glPolicy);
@@ -573,6 +579,9 @@ void optionsMenu::saveToOptionsFile()   // Ercan: Config file Erstellung hier
     fout << "selYawLine " << yawColor[2].red() << " " << yawColor[2].green() << " " << yawColor[2].blue() << " " << yawColor[2].alpha() << "\n";
     fout << "selYawBack " << yawColor[3].red() << " " << yawColor[3].green() << " " << yawColor[3].blue() << " " << yawColor[3].alpha() << "\n";
 
+    fout << "sectionCache " << cacheBudget << "\n";
+    fout << "compactTracks " << compactTracks << "\n";
+
     fout.close();
 }
 
@@ -901,6 +910,16 @@ bool optionsMenu::loadFromOptionsFile()   // Ercan: Config file Auslesen hier
     yawColor[3].setAlpha(QString(input).toInt(&ok));
     if(!ok) return false;
 
+    // options files of older versions end here
+    if(fin >> input >> input) {
+        cacheBudget = QString(input).toInt(&ok);
+        if(!ok) return false;
+    }
+    if(fin >> input >> input) {
+        compactTracks = QString(input).toInt(&ok);
+        if(!ok) return false;
+    }
+
     fin.close();
     return true;
 }
@@ -974,9 +993,27 @@ void optionsMenu::on_meshQualityBox_currentIndexChanged(int index)
 {
     meshQuality = index;
     if(gloParent->project == NULL) return;
-    QList<trackHandler*> TL = gloParent->getTrackList();
-    for(int i = 0; i < TL.size(); ++i)
-    {
-        TL[i]->mMesh->buildMeshes(0);
-    }
+    recomputeTracks(gloParent->getTrackList(), false);
+}
+
+void optionsMenu::on_cacheBox_valueChanged(int arg1)
+{
+    if(phantomChanges) return;
+    cacheBudget = arg1;
+    setSectionCacheBudget((qint64)cacheBudget*1024*1024);
+    updateCacheStats();
+}
+
+void optionsMenu::on_compactBox_stateChanged(int arg1)
+{
+    compactTracks = arg1;
+    if(phantomChanges || !compactTracks) return;
+    gloParent->compactInactiveTracks();
+}
+
+void optionsMenu::updateCacheStats()
+{
+    sectioncachestats_t stats = getSectionCacheStats();
+    ui->cacheStatsLabel->setText(QString("%1 hits, %2 misses, %3 sections in %4 MB").arg(stats.hits).arg(stats.misses)
+                                 .arg(stats.entries).arg(stats.bytes/(1024.*1024.), 0, 'f', 1));
 }
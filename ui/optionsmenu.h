@@ -58,6 +58,7 @@ public:
     void saveToOptionsFile();
     bool loadFromOptionsFile();
     void setGLVersionString(QString version);
+    void updateCacheStats();
     ~optionsMenu();
 
 
@@ -72,6 +73,8 @@ public:
     QColorDialog* colorPicker;
     int shadowQuality;
     int meshQuality;
+    int cacheBudget;    // section cache in MB
+    bool compactTracks; // see track::compactTrack()
     float fov;
 
     bool drawGrid;
@@ -141,6 +144,10 @@ private slots:
 
     void on_meshQualityBox_currentIndexChanged(int index);
 
+    void on_cacheBox_valueChanged(int arg1);
+
+    void on_compactBox_stateChanged(int arg1);
+
 private:
     Ui::optionsMenu *ui;
 
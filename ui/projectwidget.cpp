@@ -30,8 +30,12 @@
 #include "trackproperties.h"
 #include "lenassert.h"
 #include "trackwidget.h"
+#include "graphwidget.h"
 #include "seccurved.h"
 #include "secstraight.h"
+#include "sectionkernel.h"
+#include "smoothhandler.h"
+#include "sectionsweep.h"
 #include <QMenu>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -117,6 +121,8 @@ void projectWidget::init()
     ui->texEdit->setText(QString("./background.png"));
     glView->loadGroundTexture(":/background.png");
 
+    setSampleRate(F_HZ_DEFAULT);
+    setAdaptiveTolerance(0.f);
     newEmptyTrack();
 }
 
@@ -165,6 +171,29 @@ void projectWidget::newEmptyTrack()
     ui->trackListWidget->addTopLevelItem(_newTrack->listItem);
 }
 
+// the copy shares the node buffers of the selected track, only the sections edited in either one get their own again
+void projectWidget::duplicateTrack()
+{
+    if(selTrack == NULL) return;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    trackHandler* source = selTrack;
+    source->trackData->materializeTrack();
+    newEmptyTrack();
+    trackHandler* newTrack = trackList.back();
+    newTrack->trackData->cloneTrack(source->trackData, newTrack->trackWidgetItem);
+    newTrack->trackData->name = source->trackData->name + QString(" Copy");
+    newTrack->listItem->setText(1, newTrack->trackData->name);
+
+    newTrack->trackData->updateSmoothLabels();
+    newTrack->mMesh->buildMeshes(0);
+
+    float mSec = timer.nsecsElapsed()/1000000.;
+    gloParent->showMessage(QString::number(mSec).append(QString("ms used to duplicate %1").arg(source->trackData->name)), 3000);
+}
+
 void projectWidget::generateRandomTrack()
 {
     QRandomGenerator rng(QRandomGenerator::securelySeeded());
@@ -377,6 +406,76 @@ void projectWidget::appendTracks(QList<trackHandler *> &_list)
     }
 }
 
+void projectWidget::setSampleRate(float _hz)
+{
+    _hz = qBound(F_HZ_MIN, _hz, F_HZ_MAX);
+
+    bool oldP = phantomChanges;
+    phantomChanges = true;
+    ui->sampleRateBox->setValue((int)(_hz+0.5f));
+    phantomChanges = oldP;
+
+    if(_hz == F_HZ) return;
+
+    // nothing may integrate at the old rate while it changes
+    stopWarming();
+    cancelSweeps();
+    float oldHz = F_HZ;
+    fSampleRate = _hz;
+    if(trackList.isEmpty()) return;
+
+    for(int i = 0; i < trackList.size(); ++i) {
+        trackList[i]->trackData->resample(oldHz, false);
+        // undo steps hold node indices and per node values of the old rate
+        trackList[i]->mUndoHandler->clearActions();
+    }
+    recomputeTracks(trackList);
+    for(int i = 0; i < trackList.size(); ++i) {
+        // the workers own the others until they are uploaded
+        if(trackList[i]->isStub || trackList[i]->isStale) continue;
+        for(int j = 0; j < trackList[i]->trackData->smoothList.size(); ++j) {
+            trackList[i]->trackData->smoothList[j]->update();
+        }
+    }
+    gloParent->setUndoButtons();
+    gloParent->updateInfoPanel();
+    if(selTrack && !selTrack->isStub && !selTrack->isStale) selTrack->graphWidgetItem->redrawGraphs();
+}
+
+void projectWidget::on_sampleRateBox_valueChanged(int arg1)
+{
+    if(phantomChanges) return;
+    setSampleRate(arg1);
+}
+
+void projectWidget::setAdaptiveTolerance(float _meters)
+{
+    _meters = qMax(0.f, _meters);
+
+    bool oldP = phantomChanges;
+    phantomChanges = true;
+    ui->toleranceBox->setValue(_meters*1000.);
+    phantomChanges = oldP;
+
+    if(_meters == fAdaptiveTolerance) return;
+
+    stopWarming();
+    cancelSweeps();
+    fAdaptiveTolerance = _meters;
+
+    // the nodes stay on the 1/F_HZ grid, undo steps remain valid
+    if(trackList.isEmpty()) return;
+    recomputeTracks(trackList);
+    gloParent->updateInfoPanel();
+    if(selTrack && !selTrack->isStub && !selTrack->isStale) selTrack->graphWidgetItem->redrawGraphs();
+}
+
+void projectWidget::on_toleranceBox_valueChanged(double arg1)
+{
+    if(phantomChanges) return;
+    setAdaptiveTolerance(arg1/1000.);
+}
+
 void projectWidget::on_deleteButton_released()
 {
     if(areYouSure()) {
@@ -385,6 +484,7 @@ void projectWidget::on_deleteButton_released()
             if(trackList[i] == selTrack) {
                 trackList.removeAt(i);
                 delete selTrack;
+                glView->hasChanged = true;
                 break;
             }
         }
@@ -441,6 +541,7 @@ void projectWidget::on_trackListWidget_itemChanged(QTreeWidgetItem *item, int co
         } else {
             trackList[index]->trackData->drawTrack = false;
         }
+        glView->hasChanged = true;
         return;
     default:
         lenAssert(0 && "unexpected default case");
@@ -474,7 +575,7 @@ bool projectWidget::areYouSure()
 QString projectWidget::saveProject(std::fstream& file)
 {
     file << "FVD";
-    file << "v0.77";
+    file << "v0.79";
 
     int namelength = texPath.length();
     std::string stdName = texPath.toStdString();
@@ -482,11 +583,16 @@ QString projectWidget::saveProject(std::fstream& file)
     writeBytes(&file, (const char*)&namelength, sizeof(int));
     file << stdName;
 
+    writeBytes(&file, (const char*)&fSampleRate, sizeof(float));
+    writeBytes(&file, (const char*)&fAdaptiveTolerance, sizeof(float));
 
+    // the workers rewrite the function values of the stubs while they integrate them
+    stopWarming();
     for(int i = 0; i < this->trackList.size(); ++i) {
         trackList[i]->trackWidgetItem->writeNames();
         trackList[i]->trackData->saveTrack(file, trackList[i]->trackWidgetItem);
     }
+    warmTracks(trackList);
 
     file << "EOP";
     return QString("Project Saved!");
@@ -499,10 +605,19 @@ QString projectWidget::loadProject(std::fstream& file)
     if(temp != "FVD") return QString("Error while Loading: No FVD File!");
     temp = readString(&file, 5);
     int legacy;
+    bool hasSampleRate = false;
+    bool hasTolerance = false;
     if(temp == "v0.30") {
         legacy = 1;
     } else if(temp == "v0.77") {
         legacy = 0;
+    } else if(temp == "v0.78") {
+        legacy = 0;
+        hasSampleRate = true;
+    } else if(temp == "v0.79") {
+        legacy = 0;
+        hasSampleRate = true;
+        hasTolerance = true;
     } else {
         legacy = -1;
     }
@@ -519,6 +634,10 @@ QString projectWidget::loadProject(std::fstream& file)
         }
         ui->texEdit->setText(texPath);
 
+        // older projects were integrated at 1 kHz
+        setSampleRate(hasSampleRate ? readFloat(&file) : F_HZ_DEFAULT);
+        setAdaptiveTolerance(hasTolerance ? readFloat(&file) : 0.f);
+
         int i = 0;
         while(1) {
             temp = readString(&file, 3);
@@ -528,16 +647,15 @@ QString projectWidget::loadProject(std::fstream& file)
                     trackList[i]->trackData->legacyLoadTrack(file, trackList[i]->trackWidgetItem);
                     errType = 0;
                 } else {
-                    trackList[i]->trackData->loadTrack(file, trackList[i]->trackWidgetItem);
+                    // only the parameters, integrated and meshed by warmTracks() or once the track is opened
+                    trackList[i]->trackData->loadTrack(file, trackList[i]->trackWidgetItem, false);
+                    trackList[i]->isStub = true;
 
                     trackWidget* _widget = trackList[i]->trackWidgetItem;
                     if(!_widget->smoothScreen) {
                         _widget->smoothScreen = new smoothUi(trackList[i], gloParent);
                         trackList[i]->trackData->smoother = _widget->smoothScreen;
                     }
-
-                    _widget->smoothScreen->updateUi();
-                    _widget->smoothScreen->applyRollSmooth();
                 }
                 trackList[i]->listItem->setText(1, trackList[i]->trackData->name);
                 trackList[i]->mUndoHandler->clearActions();
@@ -554,12 +672,22 @@ QString projectWidget::loadProject(std::fstream& file)
         errType = 10;
     }
 
+    if(legacy == 0) {
+        for(int i = 0; i < trackList.size(); ++i) {
+            trackList[i]->trackWidgetItem->smoothScreen->updateUi();
+        }
+    }
+
     for(int i = 0; i < trackList.size(); ++i) {
         if(trackList[i]->trackData->drawTrack == false) {
             trackList[i]->listItem->setCheckState(2, Qt::Unchecked);
         }
     }
 
+    if(legacy == 0) {
+        warmTracks(trackList);
+    }
+
     switch(errType) {
     case -1:
         return QString("Load Successfull.");
@@ -631,6 +759,7 @@ void projectWidget::on_trackListWidget_customContextMenuRequested(const QPoint &
         menu->addAction("Import from Pointlist", this, SLOT(importPointList()));
         if(selTrack != NULL) {
             menu->addAction("Edit Track", this, SLOT(on_editButton_released()));
+            menu->addAction("Duplicate Track", this, SLOT(duplicateTrack()));
             menu->addAction("Remove Track", this, SLOT(on_deleteButton_released()));
         }
     }
@@ -659,5 +788,6 @@ void projectWidget::keyPressEvent(QKeyEvent* event) {
 
 void projectWidget::on_propertyButton_released()
 {
+    selTrack->trackData->materializeTrack();
     properties->openForTrack(selTrack);
 }
@@ -42,6 +42,8 @@ public:
     void init();
     void cleanUp();
     void appendTracks(QList<trackHandler*> &_list);
+    void setSampleRate(float _hz);
+    void setAdaptiveTolerance(float _meters);
     void keyPressEvent(QKeyEvent* event);
 
     QList<trackHandler*> trackList;
@@ -60,6 +62,8 @@ public slots:
 
     void newEmptyTrack();
 
+    void duplicateTrack();
+
     void importFromProject(QString fileName = "");
 
     void importNLTrack();
@@ -82,6 +86,10 @@ private slots:
 
     void on_propertyButton_released();
 
+    void on_sampleRateBox_valueChanged(int arg1);
+
+    void on_toleranceBox_valueChanged(double arg1);
+
 signals:
     void updateTracks();
 
@@ -81,167 +81,18 @@ smoothUi::~smoothUi()
 
 void smoothUi::applyRollSmooth(int fromNode)
 {
-    m_track->removeSmooth(fromNode);
-
-    m_track->anchorNode->fRollSpeed = 0.0;
-
-    int sec, curNode = fromNode < 0 ? 0 : fromNode;
-    for(sec = 0; sec < m_track->lSections.size(); ++sec) {
-        if(m_track->lSections[sec]->lNodes.size() >= curNode) {
-            break;
-        }
-        curNode -= m_track->lSections[sec]->lNodes.size()-1;
-    }
-
-    for(; sec < m_track->lSections.size(); ++sec) {
-        section* curSection = m_track->lSections[sec];
-        for(int i = curNode; i < curSection->lNodes.size(); ++i) {
-			curSection->lNodes[i].fSmoothSpeed = 0.f;
-        }
-        curNode = 0;
-    }
-
-    for(int i = 0; i < m_track->smoothList.size(); ++i) {
-        smoothHandler* cur = m_track->smoothList[i];
-        if(cur->active == false) continue;
-
-        if(cur->getTo() > fromNode) {
-            applyRollSmoothFilter(cur);
-        }
-    }
-
-    if(active()) {
-        m_track->applySmooth(fromNode);
-    }
+    smoothRoll(fromNode);
     m_widget->redrawGraphs();
-    m_track->hasChanged = true;
-    return;
 }
 
-void smoothUi::applyRollSmoothFilter(smoothHandler* _handler)
+void smoothUi::smoothRoll(int fromNode)
 {
-    const int iter = _handler->getIterations();
-    const int length = _handler->getLength()/iter;
-    const int fromNode = _handler->getFrom();
-    const int toNode = _handler->getTo();
-
-    QVector<double> adjustValues;
-
-    QVector<double> *cur = new QVector<double>();
-    QVector<double> *last = new QVector<double>();
-    QVector<double> orig;
-    QVector<double> *swap;
-
-    mnode* curNode;
-
-    if(toNode - fromNode - length/2*iter < 0) {
-        lenAssert(0 && "Smoothing not possible");
-        return;
-    }
-
-    double lastValue = 0., firstValue = 0.;
-    for(int i = 0; i <= length/2*iter; ++i) {
-        curNode = m_track->getPoint(toNode - i);
-        lastValue += curNode->fRollSpeed + curNode->fSmoothSpeed;
-        curNode =  m_track->getPoint(fromNode + i);
-        firstValue += curNode->fRollSpeed + curNode->fSmoothSpeed;
-    }
-    lastValue /= length/2*iter + 1;
-    firstValue /= length/2*iter + 1;
-
-    for(int i = fromNode; i < toNode; ++i) {
-        if(length == 0) {
-            curNode = m_track->getPoint(i);
-            cur->append(curNode->fRollSpeed + curNode->fSmoothSpeed);
-            last->append(cur->last());
-            orig.append(cur->last());
-            continue;
-        }
-        double t1 = (i - fromNode - length/2.*iter)/(length/2. * iter);
-        double t2 = (toNode - length/2.*iter - i)/(length/2. * iter);
-        if(t1 < 0) t1 = 1.;
-        else t1 = exp(-2*t1*t1);
-        if(t2 < 0) t2 = 1.;
-        else t2 = exp(-2*t2*t2);
-        double t = (1. - t1)*(1. - t2);
-        if(t != t) t = 0.;
-
-        if(t2 > t1) {
-            if(t > t2) { // max = t
-                if(fabs(t1+t2) > std::numeric_limits<double>::epsilon()) {
-                    t2 = t2/(t1+t2)*(1.-t);
-                    t1 = t1/(t1+t2)*(1.-t);
-                }
-            } else {   // max = t2
-                if(fabs(t1+t) > std::numeric_limits<double>::epsilon()) {
-                    t = t/(t1+t)*(1.-t2);
-                    t1 = t1/(t1+t)*(1.-t2);
-                }
-            }
-        } else {
-            if(t > t1) { // max = t
-                if(fabs(t1+t2) > std::numeric_limits<double>::epsilon()) {
-                    t2 = t2/(t1+t2)*(1.-t);
-                    t1 = t1/(t1+t2)*(1.-t);
-                }
-            } else {   // max = t1
-                if(fabs(t+t2) > std::numeric_limits<double>::epsilon()) {
-                    t = t/(t2+t)*(1.-t1);
-                    t2 = t2/(t2+t)*(1.-t1);
-                }
-            }
-        }
-        if(i < fromNode + length/2 * iter) {
-            cur->append(firstValue);
-        } else if(i > toNode - length/2*iter) {
-            cur->append(lastValue);
-        } else {
-            curNode = m_track->getPoint(i);
-            cur->append(t*(curNode->fRollSpeed + curNode->fSmoothSpeed) + t1*firstValue + t2*lastValue);
-        }
-        last->append(cur->last());
-        orig.append(cur->last());
-    }
-
-    for(int iterations = 0; iterations < iter; ++iterations) {
-        swap = cur;
-        cur = last;
-        last = swap;
-        for(int i = 0; i < cur->size(); ++i) {
-            double temp = 0.0, div = 0.;
-
-            for(int j = -length/2; j <= length/2; ++j) {
-                if(i+j < 0) {
-                    temp += last->at(0);
-                } else if(i+j >= last->size()) {
-                    temp += last->last();
-                } else {
-                    temp += last->at(i+j);
-                }
-                div = length/2 * 2 + 1;
-            }
-            cur->replace(i, temp/div);
-        }
-    }
-
-    for(int i = 0; i < cur->size(); ++i) {
-        adjustValues.append(cur->at(i) - orig[i]);
-    }
-
-    for(int i = 0; i < adjustValues.size(); ++i) {
-        m_track->getPoint(i+fromNode)->fSmoothSpeed += adjustValues[i];
-    }
-
-    delete cur;
-    delete last;
+    m_track->smoothRoll(fromNode);
 }
 
 bool smoothUi::active()
 {
-    for(int i = 0; i < m_track->smoothList.size(); ++i) {
-        if(m_track->smoothList[i]->active) return true;
-    }
-    return false;
+    return m_track->smoothActive();
 }
 
 void smoothUi::on_buttonBox_accepted()
@@ -279,16 +130,16 @@ void smoothUi::on_smoothUnitTree_itemSelectionChanged()
     }
     curHandler = m_track->smoothList[i];
     if(m_track->smoothList[i]->sec != NULL) {
-        ui->lengthBox->setValue(curHandler->getLength()/1000.);
+        ui->lengthBox->setValue(curHandler->getLength()/F_HZ);
         ui->iterBox->setValue(curHandler->getIterations());
         ui->optsFrame->show();
         ui->regionFrame->hide();
         ui->removeButton->setEnabled(false);
     } else {
-        ui->lengthBox->setValue(curHandler->getLength()/1000.);
+        ui->lengthBox->setValue(curHandler->getLength()/F_HZ);
         ui->iterBox->setValue(curHandler->getIterations());
-        ui->fromBox->setValue(curHandler->getFrom()/1000.);
-        ui->toBox->setValue(curHandler->getTo()/1000.);
+        ui->fromBox->setValue(curHandler->getFrom()/F_HZ);
+        ui->toBox->setValue(curHandler->getTo()/F_HZ);
         ui->optsFrame->show();
         ui->regionFrame->show();
         ui->removeButton->setEnabled(true);
@@ -301,7 +152,7 @@ void smoothUi::on_lengthBox_valueChanged(double arg1)
 {
     if(phantomChanges) return;
     phantomChanges = true;
-    curHandler->setLength((int)(arg1*1000.+0.5));
+    curHandler->setLength((int)(arg1*F_HZ+0.5));
     generateWarnings();
     phantomChanges = false;
 }
@@ -320,18 +171,18 @@ void smoothUi::on_fromBox_valueChanged(double arg1)
     if(phantomChanges) return;
     const int max = m_track->getNumPoints();
     const int min = 0;
-    int setTo = (int)(arg1*1000.+0.5);
+    int setTo = (int)(arg1*F_HZ+0.5);
     if(setTo > max) {
-        ui->fromBox->setValue(max/1000.);
+        ui->fromBox->setValue(max/F_HZ);
         return;
     }
     if(setTo < min) {
-        ui->fromBox->setValue(min/1000.);
+        ui->fromBox->setValue(min/F_HZ);
         return;
     }
 
     phantomChanges = true;
-    curHandler->setFrom((int)(arg1*1000.+0.5));
+    curHandler->setFrom((int)(arg1*F_HZ+0.5));
     generateWarnings();
     phantomChanges = false;
 }
@@ -339,15 +190,15 @@ void smoothUi::on_fromBox_valueChanged(double arg1)
 void smoothUi::on_toBox_valueChanged(double arg1)
 {
     if(phantomChanges) return;
-    int setTo = (int)(arg1*1000.+0.5);
+    int setTo = (int)(arg1*F_HZ+0.5);
     const int max = m_track->getNumPoints();
     const int min = 0;
     if(setTo > max) {
-        ui->toBox->setValue(max/1000.);
+        ui->toBox->setValue(max/F_HZ);
         return;
     }
     if(setTo < min) {
-        ui->toBox->setValue(min/1000.);
+        ui->toBox->setValue(min/F_HZ);
         return;
     }
 
@@ -376,7 +227,7 @@ void smoothUi::on_smoothUnitTree_itemChanged(QTreeWidgetItem *item, int column)
 
 void smoothUi::on_newButton_released()
 {
-    m_track->smoothList.append(new smoothHandler(m_track, -2, &customChar, 400, 1, 0, 1000));
+    m_track->smoothList.append(new smoothHandler(m_track, -2, &customChar, -1, 1, 0, (int)F_HZ));
     updateUi();
 }
 
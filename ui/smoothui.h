@@ -41,6 +41,7 @@ public:
     ~smoothUi();
 
     void applyRollSmooth(int fromNode = 0);
+    void smoothRoll(int fromNode = 0);
     bool active();
 
     void updateUi();
@@ -68,8 +69,6 @@ private slots:
     void on_removeButton_released();
 
 private:
-    void applyRollSmoothFilter(smoothHandler* _handler);
-
     void generateWarnings();
 
     Ui::smoothUi *ui;
@@ -0,0 +1,314 @@
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sweepdialog.h"
+#include "ui_sweepdialog.h"
+
+#include "mainwindow.h"
+#include "projectwidget.h"
+#include "graphwidget.h"
+#include "trackhandler.h"
+#include "optionsmenu.h"
+#include "undoaction.h"
+#include "undohandler.h"
+#include "section.h"
+
+#include <QApplication>
+#include <algorithm>
+
+extern MainWindow* gloParent;
+
+sweepDialog::sweepDialog(QWidget *parent) :
+    QDialog(parent),
+    ui(new Ui::sweepDialog)
+{
+    ui->setupUi(this);
+    curTrack = NULL;
+    curSub = NULL;
+    runs = 0;
+    sweeping = false;
+
+    QStringList names;
+    names << "Change" << "Shape" << "Center" << "Tension" << "Length";
+    for(int i = 0; i < names.size(); ++i) {
+        ui->parameterBox1->addItem(names[i], i);
+    }
+    ui->parameterBox2->addItem("None", -1);
+    for(int i = 0; i < names.size(); ++i) {
+        ui->parameterBox2->addItem(names[i], i);
+    }
+}
+
+sweepDialog::~sweepDialog()
+{
+    // the workers hold the job and post to this dialog
+    cancelSweeps();
+    delete ui;
+}
+
+// picks up the selected transition, there is nothing to sweep unless it belongs to a forced or geometric section
+bool sweepDialog::update()
+{
+    if(sweeping) {
+        cancelSweeps();
+        sweeping = false;
+        ++runs;
+        ui->runButton->setEnabled(true);
+        ui->solveButton->setEnabled(true);
+    }
+    results.clear();
+    order.clear();
+    ui->resultTable->setRowCount(0);
+    ui->applyButton->setEnabled(false);
+
+    curTrack = gloParent->project->selTrack;
+    curSub = curTrack ? curTrack->graphWidgetItem->selFunc : NULL;
+    if(curSub == NULL) return false;
+    section* curSection = curSub->parent->secParent;
+    if(curSection->type != forced && curSection->type != geometric) {
+        curSub = NULL;
+        return false;
+    }
+
+    ui->captionLabel->setText(QString("%1, Transition %2").arg(curSection->sName).arg(curSub->parent->getSubfuncNumber(curSub)+1));
+    ui->heightBox->setSuffix(QString(" ").append(gloParent->mOptions->getLengthString()));
+    ui->speedBox->setSuffix(QString(" ").append(gloParent->mOptions->getSpeedString()));
+
+    mnode last = curSection->lNodes.constLast();
+    ui->heightBox->setValue(last.vPos.y*gloParent->mOptions->getLengthFactor());
+    ui->speedBox->setValue(last.fVel*gloParent->mOptions->getSpeedFactor());
+    ui->pitchBox->setValue(last.getPitch());
+    ui->rollBox->setValue(last.fRoll);
+
+    setupRange(ui->parameterBox1, ui->fromBox1, ui->toBox1);
+    setupRange(ui->parameterBox2, ui->fromBox2, ui->toBox2);
+    return true;
+}
+
+void sweepDialog::setupRange(QComboBox* _box, QDoubleSpinBox* _from, QDoubleSpinBox* _to)
+{
+    int parameter = _box->currentData().toInt();
+    _from->setEnabled(parameter >= 0);
+    _to->setEnabled(parameter >= 0);
+    if(parameter < 0 || curSub == NULL) return;
+
+    float value = getSweepValue(curSub, (enum eSweepParameter)parameter);
+    float span = std::max(0.2f*(float)fabs(value), 0.1f);
+    _from->setValue(parameter == sweepLength ? std::max(value-span, 0.01f) : value-span);
+    _to->setValue(value+span);
+}
+
+void sweepDialog::on_parameterBox1_currentIndexChanged(int)
+{
+    setupRange(ui->parameterBox1, ui->fromBox1, ui->toBox1);
+}
+
+void sweepDialog::on_parameterBox2_currentIndexChanged(int)
+{
+    setupRange(ui->parameterBox2, ui->fromBox2, ui->toBox2);
+    ui->stepsBox2->setEnabled(ui->parameterBox2->currentData().toInt() >= 0);
+}
+
+QList<sweeprange_t> sweepDialog::getRanges()
+{
+    QList<sweeprange_t> ranges;
+    sweeprange_t range;
+    range.parameter = (enum eSweepParameter)ui->parameterBox1->currentData().toInt();
+    range.from = ui->fromBox1->value();
+    range.to = ui->toBox1->value();
+    range.steps = ui->stepsBox1->value();
+    ranges.append(range);
+
+    int second = ui->parameterBox2->currentData().toInt();
+    if(second >= 0 && second != range.parameter) {
+        range.parameter = (enum eSweepParameter)second;
+        range.from = ui->fromBox2->value();
+        range.to = ui->toBox2->value();
+        range.steps = ui->stepsBox2->value();
+        ranges.append(range);
+    }
+    return ranges;
+}
+
+sweeptarget_t sweepDialog::getTarget()
+{
+    sweeptarget_t target;
+    target.useHeight = ui->heightCheck->isChecked();
+    target.height = ui->heightBox->value()/gloParent->mOptions->getLengthFactor();
+    target.useSpeed = ui->speedCheck->isChecked();
+    target.speed = ui->speedBox->value()/gloParent->mOptions->getSpeedFactor();
+    target.usePitch = ui->pitchCheck->isChecked();
+    target.pitch = ui->pitchBox->value();
+    target.useRoll = ui->rollCheck->isChecked();
+    target.roll = ui->rollBox->value();
+    return target;
+}
+
+void sweepDialog::on_runButton_released()
+{
+    if(curSub == NULL && !update()) return;
+
+    sweptRanges = getRanges();
+    if(sweepVariants(sweptRanges) > SWEEP_MAX_VARIANTS) {
+        ui->countLabel->setText(QString("more than %1 variants").arg(SWEEP_MAX_VARIANTS));
+        return;
+    }
+
+    const int run = ++runs;
+    if(!startSweep(&job, curSub->parent->secParent, curSub, sweptRanges, getTarget(), [this, run]() {
+        QMetaObject::invokeMethod(this, "sweepFinished", Qt::QueuedConnection, Q_ARG(int, run));
+    })) return;
+
+    sweeping = true;
+    ui->runButton->setEnabled(false);
+    ui->solveButton->setEnabled(false);
+    ui->applyButton->setEnabled(false);
+    ui->countLabel->setText(QString("sweeping %1 variants").arg(job.results.size()));
+}
+
+void sweepDialog::sweepFinished(int _run)
+{
+    if(_run != runs || !sweeping) return;
+    sweeping = false;
+    ui->runButton->setEnabled(true);
+    ui->solveButton->setEnabled(true);
+
+    // a cancelled sweep leaves the variants it never reached without values
+    results.clear();
+    for(int i = 0; i < job.results.size(); ++i) {
+        if(job.results[i].values.size() == sweptRanges.size()) results.append(job.results[i]);
+    }
+    fillTable();
+    if(job.cancelled) ui->countLabel->setText(QString("cancelled, %1").arg(ui->countLabel->text()));
+}
+
+// the ranges of the parameter rows are the bounds of the solver
+void sweepDialog::on_solveButton_released()
+{
+    if(curSub == NULL && !update()) return;
+
+    sweptRanges = getRanges();
+    sweeptarget_t target = getTarget();
+    if(!target.useHeight && !target.useSpeed && !target.usePitch && !target.useRoll) {
+        ui->countLabel->setText("no end condition selected");
+        return;
+    }
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    solveresult_t solution = solveSection(curSub->parent->secParent, curSub, sweptRanges, target);
+    QApplication::restoreOverrideCursor();
+
+    results.clear();
+    results.append(solution.exit);
+    fillTable();
+    ui->countLabel->setText(QString("%1 after %2 iterations").arg(solution.converged ? "converged" : "not converged").arg(solution.iterations));
+}
+
+void sweepDialog::fillTable()
+{
+    order.resize(results.size());
+    for(int i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        if(results[a].valid != results[b].valid) return results[a].valid;
+        return results[a].score < results[b].score;
+    });
+
+    const QStringList names = QStringList() << "Change" << "Shape" << "Center" << "Tension" << "Length";
+    QStringList header;
+    for(int r = 0; r < sweptRanges.size(); ++r) {
+        header << names[sweptRanges[r].parameter];
+    }
+    header << QString("Height [%1]").arg(gloParent->mOptions->getLengthString())
+           << QString("Speed [%1]").arg(gloParent->mOptions->getSpeedString())
+           << "Pitch" << "Yaw" << "Roll" << "Max Normal" << "Min Normal" << "Max Lateral" << "Score";
+
+    ui->resultTable->clear();
+    ui->resultTable->setColumnCount(header.size());
+    ui->resultTable->setHorizontalHeaderLabels(header);
+    ui->resultTable->setRowCount(order.size());
+
+    int valid = 0;
+    for(int row = 0; row < order.size(); ++row) {
+        const sweepresult_t &result = results[order[row]];
+        QStringList cells;
+        for(int r = 0; r < result.values.size(); ++r) {
+            cells << QString::number(result.values[r], 'f', 3);
+        }
+        if(result.valid) {
+            ++valid;
+            cells << QString::number(result.pos.y*gloParent->mOptions->getLengthFactor(), 'f', 2)
+                  << QString::number(result.vel*gloParent->mOptions->getSpeedFactor(), 'f', 2)
+                  << QString::number(result.pitch, 'f', 2)
+                  << QString::number(result.yaw, 'f', 2)
+                  << QString::number(result.roll, 'f', 2)
+                  << QString::number(result.maxNormal, 'f', 2)
+                  << QString::number(result.minNormal, 'f', 2)
+                  << QString::number(result.maxLateral, 'f', 2)
+                  << QString::number(result.score, 'f', 3);
+        } else {
+            cells << "train stalls";
+        }
+        for(int c = 0; c < cells.size(); ++c) {
+            ui->resultTable->setItem(row, c, new QTableWidgetItem(cells[c]));
+        }
+    }
+    ui->resultTable->resizeColumnsToContents();
+    if(valid) ui->resultTable->selectRow(0);
+    ui->applyButton->setEnabled(valid > 0);
+    ui->countLabel->setText(QString("%1 variants, %2 valid").arg(results.size()).arg(valid));
+}
+
+// the chosen variant goes onto the real transition as one undo step
+void sweepDialog::on_applyButton_released()
+{
+    if(curSub == NULL || order.isEmpty()) return;
+    if(gloParent->project->selTrack != curTrack || curTrack->graphWidgetItem->selFunc != curSub) {
+        ui->countLabel->setText("the selection has changed, run the sweep again");
+        return;
+    }
+
+    int row = ui->resultTable->currentRow();
+    const sweepresult_t &result = results[order[row < 0 ? 0 : row]];
+    if(!result.valid) return;
+
+    const eActionType actionTypes[] = {onChangeSpin, onArg1, onCenterSpin, onTensionSpin, onLengthSpin};
+    undoAction* head = NULL;
+    for(int r = 0; r < sweptRanges.size(); ++r) {
+        undoAction* temp = NULL;
+        if(!curTrack->mUndoHandler->busy) {
+            temp = new undoAction(curTrack, actionTypes[sweptRanges[r].parameter]);
+            temp->fromValue = QVariant(getSweepValue(curSub, sweptRanges[r].parameter));
+        }
+        applySweepValue(curSub, sweptRanges[r].parameter, result.values[r]);
+        if(temp) {
+            temp->toValue = QVariant(getSweepValue(curSub, sweptRanges[r].parameter));
+            temp->nextAction = head;
+            head = temp;
+        }
+    }
+
+    curTrack->graphWidgetItem->selectionChanged();
+    curTrack->trackData->updateTrack(curSub->parent->secParent, (int)(curSub->minArgument*F_HZ-1.5f));
+    curTrack->graphWidgetItem->redrawGraphs();
+    gloParent->updateInfoPanel();
+
+    if(head) {
+        curTrack->mUndoHandler->addAction(head);
+        gloParent->setUndoButtons();
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef SWEEPDIALOG_H
+#define SWEEPDIALOG_H
+
+/*
+#    FVD++, an advanced coaster design tool for NoLimits
+#    Copyright (C) 2012-2015, Stephan "Lenny" Alt <alt.stephan@web.de>
+#
+#    This program is free software: you can redistribute it and/or modify
+#    it under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    This program is distributed in the hope that it will be useful,
+#    but WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <QDialog>
+#include "sectionsweep.h"
+
+class trackHandler;
+class QComboBox;
+class QDoubleSpinBox;
+
+namespace Ui {
+class sweepDialog;
+}
+
+class sweepDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit sweepDialog(QWidget *parent = 0);
+    ~sweepDialog();
+
+    bool update();
+
+private slots:
+    void on_parameterBox1_currentIndexChanged(int index);
+
+    void on_parameterBox2_currentIndexChanged(int index);
+
+    void on_runButton_released();
+
+    void on_solveButton_released();
+
+    void on_applyButton_released();
+
+    void sweepFinished(int _run);
+
+private:
+    void setupRange(QComboBox* _box, QDoubleSpinBox* _from, QDoubleSpinBox* _to);
+    QList<sweeprange_t> getRanges();
+    sweeptarget_t getTarget();
+    void fillTable();
+
+    trackHandler* curTrack;
+    subfunc* curSub;
+
+    QList<sweeprange_t> sweptRanges;
+    QVector<sweepresult_t> results;
+    QVector<int> order;             // results by score
+
+    sweepjob_t job;
+    int runs;                       // a finished sweep only fills the table if no later run or update() came in between
+    bool sweeping;
+
+    Ui::sweepDialog *ui;
+};
+
+#endif // SWEEPDIALOG_H
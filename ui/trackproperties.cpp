@@ -104,6 +104,7 @@ void TrackProperties::ontransitionColor_received()
 void TrackProperties::on_drawBox_currentIndexChanged(int index)
 {
     curTrack->trackData->drawHeartline = index;
+    curTrack->trackData->hasChanged = true;
 }
 
 void TrackProperties::on_styleBox_currentIndexChanged(int)
@@ -116,6 +117,9 @@ void TrackProperties::on_wireframeBox_stateChanged(int)
 
 void TrackProperties::on_buttonBox_accepted()
 {
+    // the dialog stays open while the tabs change, the track may have been compacted since
+    bool wasCold = curTrack->trackData->materializeTrack();
+
     if(curTrack->trackData->fFriction != ui->frictionBox->value()) {
         curTrack->trackData->fFriction = ui->frictionBox->value();
         curTrack->trackData->updateTrack(0, 0);
@@ -198,6 +202,9 @@ void TrackProperties::on_buttonBox_accepted()
         curTrack->trackData->hasChanged = true;
     }
 
+    if(wasCold && gloParent->mOptions->compactTracks && gloParent->curTrack() != curTrack->trackData) {
+        curTrack->trackData->compactTrack();
+    }
 }
 
 void TrackProperties::on_buttonBox_rejected()
@@ -23,6 +23,7 @@
 #include "undohandler.h"
 #include "mainwindow.h"
 #include "trackmesh.h"
+#include "exportfuncs.h"
 #include <QMenu>
 #include <QKeyEvent>
 #include <QPushButton>
@@ -167,6 +168,32 @@ void trackWidget::addSection(secType _type)
     }
 }
 
+// appends a copy of _source without integrating it, see track::cloneTrack()
+void trackWidget::addSharedSection(section* _source)
+{
+    section* curSection = addSectionStub(_source->type);
+
+    std::stringstream data;
+    _source->saveSection(data);
+    readString(&data, 3);
+    curSection->loadSection(data);
+    // the forced sections do not save these with the undo data
+    curSection->bSpeed = _source->bSpeed;
+    curSection->fVel = _source->fVel;
+
+    curSection->lNodes = _source->lNodes;
+    curSection->length = _source->length;
+}
+
+// appends a section with its default parameters, nothing is integrated, meshed or added to the undo steps
+section* trackWidget::addSectionStub(secType _type)
+{
+    sectionHandler* newSec = new sectionHandler(inTrack->trackData, _type, sectionList.size());
+    sectionList.append(newSec);
+    ui->sectionListWidget->addTopLevelItem(newSec->listItem);
+    return newSec->sectionData;
+}
+
 void trackWidget::appendStraightSec()
 {
     appendSection(straight);
@@ -1167,8 +1194,8 @@ void trackWidget::updateAnchorGeometrics()
     glm::vec3 pitchVec = (float)cos(inTrack->trackData->anchorNode->fRoll*F_PI/180)*inTrack->trackData->anchorNode->vNorm - (float)sin(inTrack->trackData->anchorNode->fRoll*F_PI/180)*inTrack->trackData->anchorNode->vLat;
     glm::vec3 yawVec = (float)sin(inTrack->trackData->anchorNode->fRoll*F_PI/180)*inTrack->trackData->anchorNode->vNorm + (float)cos(inTrack->trackData->anchorNode->fRoll*F_PI/180)*inTrack->trackData->anchorNode->vLat;
 
-    inTrack->trackData->anchorNode->fPitchFromLast = glm::dot(forceVec, pitchVec)/inTrack->trackData->anchorNode->fVel*1.8/F_PI;
-    inTrack->trackData->anchorNode->fYawFromLast = glm::dot(forceVec, yawVec)/inTrack->trackData->anchorNode->fVel*1.8/F_PI;
+    inTrack->trackData->anchorNode->fPitchFromLast = glm::dot(forceVec, pitchVec)/inTrack->trackData->anchorNode->fVel*1800./F_PI/F_HZ;
+    inTrack->trackData->anchorNode->fYawFromLast = glm::dot(forceVec, yawVec)/inTrack->trackData->anchorNode->fVel*1800./F_PI/F_HZ;
 }
 
 void trackWidget::on_smoothButton_released()
@@ -55,6 +55,8 @@ public:
 
     void updateAnchorGeometrics();
     void setSelection(int index);
+    void addSharedSection(section* _source);
+    section* addSectionStub(secType _type);
 
     QList<sectionHandler*> sectionList;
     sectionHandler* selSection;
@@ -284,8 +284,7 @@ void transitionWidget::on_lengthSpin_valueChanged(double arg1)
 
     trackHandler* inTrack = mParent->selTrack;
 
-    inTrack->trackData->updateTrack(inTrack->trackData->activeSection, (int)(selectedFunc->minArgument*F_HZ-1.5f));
-    mParent->redrawGraphs();
+    mParent->requestUpdate((int)(selectedFunc->minArgument*F_HZ-1.5f));
 
     if(inTrack->trackData->activeSection->type == straight) {
         inTrack->trackWidgetItem->setupStraightFrame();
@@ -346,8 +345,7 @@ void transitionWidget::on_changeSpin_valueChanged(double arg1)
 
     trackHandler* inTrack = mParent->selTrack;
 
-    inTrack->trackData->updateTrack(inTrack->trackData->activeSection, (int)(selectedFunc->minArgument*F_HZ-1.5f));
-    mParent->redrawGraphs();
+    mParent->requestUpdate((int)(selectedFunc->minArgument*F_HZ-1.5f));
     gloParent->updateInfoPanel();
 
     if(!inTrack->mUndoHandler->busy) {
@@ -457,8 +455,7 @@ void transitionWidget::on_quarticSpin_valueChanged(double arg1)
 
     trackHandler* inTrack = mParent->selTrack;
 
-    inTrack->trackData->updateTrack(inTrack->trackData->activeSection, (int)(selectedFunc->minArgument*F_HZ-1.5f));
-    mParent->redrawGraphs();
+    mParent->requestUpdate((int)(selectedFunc->minArgument*F_HZ-1.5f));
     gloParent->updateInfoPanel();
 
     if(!inTrack->mUndoHandler->busy)
@@ -530,8 +527,7 @@ void transitionWidget::on_quinticSpin_valueChanged(double arg1)
 
     trackHandler* inTrack = mParent->selTrack;
 
-    inTrack->trackData->updateTrack(inTrack->trackData->activeSection, (int)(selectedFunc->minArgument*F_HZ-1.5f));
-    mParent->redrawGraphs();
+    mParent->requestUpdate((int)(selectedFunc->minArgument*F_HZ-1.5f));
     gloParent->updateInfoPanel();
 
     if(!inTrack->mUndoHandler->busy)
@@ -550,8 +546,7 @@ void transitionWidget::on_centerSpin_valueChanged(double arg1)
 
     trackHandler* inTrack = mParent->selTrack;
 
-    inTrack->trackData->updateTrack(inTrack->trackData->activeSection, (int)(selectedFunc->minArgument*F_HZ-1.5f));
-    mParent->redrawGraphs();
+    mParent->requestUpdate((int)(selectedFunc->minArgument*F_HZ-1.5f));
     gloParent->updateInfoPanel();
 
     if(!inTrack->mUndoHandler->busy)
@@ -570,8 +565,7 @@ void transitionWidget::on_tensionSpin_valueChanged(double arg1)
 
     trackHandler* inTrack = mParent->selTrack;
 
-    inTrack->trackData->updateTrack(inTrack->trackData->activeSection, (int)(selectedFunc->minArgument*F_HZ-1.5f));
-    mParent->redrawGraphs();
+    mParent->requestUpdate((int)(selectedFunc->minArgument*F_HZ-1.5f));
     gloParent->updateInfoPanel();
 
     if(!inTrack->mUndoHandler->busy)